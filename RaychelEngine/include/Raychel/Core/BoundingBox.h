@@ -0,0 +1,94 @@
+/**
+*\file BoundingBox.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for axis aligned bounding boxes
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_BOUNDING_BOX_H
+#define RAYCHEL_BOUNDING_BOX_H
+
+#include "Types.h"
+
+namespace Raychel {
+
+    /**
+    *\brief Axis aligned bounding box. A default constructed box is empty
+    *
+    */
+    struct BoundingBox
+    {
+        vec3 min{std::numeric_limits<number_t>::max(), std::numeric_limits<number_t>::max(), std::numeric_limits<number_t>::max()};
+        vec3 max{std::numeric_limits<number_t>::lowest(), std::numeric_limits<number_t>::lowest(), std::numeric_limits<number_t>::lowest()};
+    };
+
+    inline bool isEmpty(const BoundingBox& b) noexcept
+    {
+        return (b.min.x > b.max.x) || (b.min.y > b.max.y) || (b.min.z > b.max.z);
+    }
+
+    inline BoundingBox merge(const BoundingBox& a, const BoundingBox& b) noexcept
+    {
+        return {min(a.min, b.min), max(a.max, b.max)};
+    }
+
+    inline BoundingBox merge(const BoundingBox& b, const vec3& p) noexcept
+    {
+        return {min(b.min, p), max(b.max, p)};
+    }
+
+    inline vec3 center(const BoundingBox& b) noexcept
+    {
+        return (b.min + b.max) * number_t(0.5);
+    }
+
+    inline vec3 extent(const BoundingBox& b) noexcept
+    {
+        return b.max - b.min;
+    }
+
+    inline bool contains(const BoundingBox& b, const vec3& p) noexcept
+    {
+        return (p.x >= b.min.x) && (p.y >= b.min.y) && (p.z >= b.min.z) && (p.x <= b.max.x) && (p.y <= b.max.y) && (p.z <= b.max.z);
+    }
+
+    /**
+    *\brief Euclidean distance from p to the box. 0 if p is inside the box
+    *
+    */
+    inline number_t distance(const BoundingBox& b, const vec3& p) noexcept
+    {
+        const number_t dx = std::max({b.min.x - p.x, number_t(0), p.x - b.max.x});
+        const number_t dy = std::max({b.min.y - p.y, number_t(0), p.y - b.max.y});
+        const number_t dz = std::max({b.min.z - p.z, number_t(0), p.z - b.max.z});
+        return std::sqrt((dx * dx) + (dy * dy) + (dz * dz));
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, const BoundingBox& b)
+    {
+        return os << "{ min: " << b.min << ", max: " << b.max << " }";
+    }
+
+}
+
+#endif //!RAYCHEL_BOUNDING_BOX_H
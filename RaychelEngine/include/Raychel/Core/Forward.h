@@ -47,11 +47,14 @@ namespace Raychel {
     class Camera;
 
     struct IRaymarchable;
+    class SdLamp;
     class IMaterial;
 
     class Material;
 
     class RaymarchRenderer;
+
+    class PrimitiveStore;
 }
 
 #endif //RAYCHEL_FORWARD_H
\ No newline at end of file
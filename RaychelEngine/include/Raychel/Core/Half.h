@@ -0,0 +1,127 @@
+/**
+*\file Half.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for IEEE 754 half precision conversions
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_HALF_H
+#define RAYCHEL_HALF_H
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__F16C__)
+    #include <immintrin.h>
+#endif
+
+namespace Raychel {
+
+    /**
+    *\brief Convert a float to the bit pattern of the closest half precision float (round to nearest even)
+    *
+    */
+    inline std::uint16_t floatToHalf(float value) noexcept
+    {
+#if defined(__F16C__)
+        return static_cast<std::uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const auto sign = static_cast<std::uint16_t>((bits >> 16U) & 0x8000U);
+        const std::uint32_t abs_bits = bits & 0x7FFFFFFFU;
+
+        //infinity and NaN
+        if(abs_bits >= 0x7F800000U) {
+            return sign | 0x7C00U | (abs_bits > 0x7F800000U ? 0x200U : 0U);
+        }
+
+        //everything from 65520 upwards rounds to infinity
+        if(abs_bits >= 0x477FF000U) {
+            return sign | 0x7C00U;
+        }
+
+        //subnormal results. Values below 2^-25 round to zero
+        if(abs_bits < 0x38800000U) {
+            if(abs_bits < 0x33000000U) {
+                return sign;
+            }
+
+            const std::uint32_t shift = 126U - (abs_bits >> 23U);
+            const std::uint32_t mantissa = (abs_bits & 0x7FFFFFU) | 0x800000U;
+            const std::uint32_t remainder = mantissa & ((1U << shift) - 1U);
+            const std::uint32_t halfway = 1U << (shift - 1U);
+
+            std::uint32_t half_bits = mantissa >> shift;
+            if((remainder > halfway) || ((remainder == halfway) && ((half_bits & 1U) != 0))) {
+                half_bits++;
+            }
+            return sign | static_cast<std::uint16_t>(half_bits);
+        }
+
+        //normal results. Rebias the exponent from 127 to 15 and round the mantissa from 23 to 10 bits
+        std::uint32_t half_bits = (abs_bits - 0x38000000U) >> 13U;
+        const std::uint32_t remainder = abs_bits & 0x1FFFU;
+        if((remainder > 0x1000U) || ((remainder == 0x1000U) && ((half_bits & 1U) != 0))) {
+            half_bits++;
+        }
+        return sign | static_cast<std::uint16_t>(half_bits);
+#endif
+    }
+
+    /**
+    *\brief Convert the bit pattern of a half precision float to a float. This is always exact
+    *
+    */
+    inline float halfToFloat(std::uint16_t half) noexcept
+    {
+#if defined(__F16C__)
+        return _cvtsh_ss(half);
+#else
+        const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000U) << 16U;
+        const std::uint32_t exponent = (half >> 10U) & 0x1FU;
+        const std::uint32_t mantissa = half & 0x3FFU;
+
+        std::uint32_t bits = 0;
+        if(exponent == 0x1FU) {
+            bits = sign | 0x7F800000U | (mantissa << 13U);
+        } else if(exponent != 0) {
+            bits = sign | ((exponent + 112U) << 23U) | (mantissa << 13U);
+        } else if(mantissa == 0) {
+            bits = sign;
+        } else {
+            //subnormal: mantissa * 2^-24
+            const float value = static_cast<float>(mantissa) * 5.9604645e-8F;
+            return sign != 0 ? -value : value;
+        }
+
+        float value = 0;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+#endif
+    }
+
+}
+
+#endif //!RAYCHEL_HALF_H
@@ -0,0 +1,63 @@
+/**
+*\file Hash.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the integer hash used for stateless random numbers
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_HASH_H
+#define RAYCHEL_HASH_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace Raychel {
+
+    //integer finalizer with good avalanche behaviour (lowbias32 by Chris Wellons)
+    inline std::uint32_t hash(std::uint32_t value) noexcept
+    {
+        value ^= value >> 16U;
+        value *= 0x7FEB352DU;
+        value ^= value >> 15U;
+        value *= 0x846CA68BU;
+        value ^= value >> 16U;
+        return value;
+    }
+
+    //hash of the bit pattern of value
+    inline std::uint32_t hashFloat(float value) noexcept
+    {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return hash(bits);
+    }
+
+    //map a hash to [0; 1)
+    inline float unitFloat(std::uint32_t key) noexcept
+    {
+        return static_cast<float>(key >> 8U) * (1.0F / 16777216.0F);
+    }
+
+}
+
+#endif //!RAYCHEL_HASH_H
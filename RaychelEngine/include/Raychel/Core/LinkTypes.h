@@ -28,10 +28,21 @@
 #ifndef RAYCHEL_LINKERTYPES_H
 #define RAYCHEL_LINKERTYPES_H
 
+#include <array>
+
+#include "BoundingBox.h"
 #include "Types.h"
 
+//number of rays that are marched together in packet mode. Set by CMake
+#ifndef RAYCHEL_RAY_PACKET_WIDTH
+    #define RAYCHEL_RAY_PACKET_WIDTH 8
+#endif
+
 namespace Raychel {
 
+    constexpr size_t ray_packet_width = RAYCHEL_RAY_PACKET_WIDTH;
+    static_assert(ray_packet_width == 4 || ray_packet_width == 8 || ray_packet_width == 16, "RAYCHEL_RAY_PACKET_WIDTH must be 4, 8 or 16!");
+
 #pragma region initializer classes
 
     /**
@@ -58,10 +69,98 @@ namespace Raychel {
 
     };
 
+    /**
+    *\brief Where a reflection probe is baked and which part of the scene it reflects
+    *
+    */
+    struct ReflectionProbePlacement
+    {
+        //center of the cubemap. Should not be inside of an object
+        vec3 position;
+        //surfaces inside of this box use the probe. Reflections are corrected as if the box was the surrounding geometry
+        BoundingBox bounds;
+    };
+
 #pragma endregion
 
 #pragma region Render classes
 
+    /**
+    *\brief One value per lane of a ray packet
+    *
+    */
+    template<typename T>
+    using PacketLanes = std::array<T, ray_packet_width>;
+
+    /**
+    *\brief Structure-of-arrays vector with one entry per lane of a ray packet
+    *
+    */
+    struct alignas(64) vec3Packet
+    {
+        PacketLanes<number_t> x, y, z;
+
+        vec3 lane(size_t i) const noexcept
+        {
+            return {x[i], y[i], z[i]};
+        }
+
+        void setLane(size_t i, const vec3& v) noexcept
+        {
+            x[i] = v.x;
+            y[i] = v.y;
+            z[i] = v.z;
+        }
+    };
+
+    /**
+    *\brief How rays advance through the scene
+    *
+    */
+    enum class MarchingStrategy {
+        //step by exactly the scene distance
+        classic,
+        //step by over_relaxation times the scene distance and step back if that skipped past the surface
+        over_relaxed,
+    };
+
+    /**
+    *\brief Storage format for the bricks of the SDF cache
+    *
+    */
+    enum class SdfCacheFormat {
+        fp16,
+        //quantized to 8 bits. Half the memory, but less precise
+        unorm8,
+    };
+
+    /**
+    *\brief How the ambient occlusion of shaded points is computed
+    *
+    */
+    enum class AmbientOcclusionMode {
+        none,
+        //sample the scene distance a few times along the normal of every shaded point
+        sdf,
+        //look the occlusion up in a field that is baked over the scene bounds. Only use this for static scenes
+        baked,
+    };
+
+    /**
+    *\brief Pixel format of rendered framebuffers
+    *
+    */
+    enum class FramebufferFormat {
+        //12 bytes per pixel. Exact and unclamped
+        rgb32f,
+        //8 bytes per pixel. Unclamped, about 3 significant digits
+        rgba16f,
+        //4 bytes per pixel. Linear, clamped to [0; 1]
+        rgb10a2,
+        //4 bytes per pixel. sRGB encoded and clamped to [0; 1]. Meant for previews and displays
+        srgba8,
+    };
+
     /**
      * \brief Options for the raymarching step in rendering.
      * 
@@ -74,6 +173,28 @@ namespace Raychel {
 
         //maximum distance a point can be away form a surface while still being cosidered *on* the surface [m]
         float epsilon = 1e-5F;
+
+        //march primary rays in packets of ray_packet_width neighbouring pixels
+        bool use_ray_packets = false;
+
+        //render tiles in stages instead of one pixel after the other: march all rays of a tile, sort the hits by object,
+        //shade them in batches and march the secondary rays they emit in the next stage
+        bool use_wavefront = false;
+
+        MarchingStrategy marching_strategy = MarchingStrategy::classic;
+
+        //step scale for MarchingStrategy::over_relaxed. Must be in [1; 2)
+        float over_relaxation = 1.2F;
+
+        //march one cone per tile before the primary rays to skip the empty space in front of the camera
+        bool use_cone_prepass = false;
+
+        //bake the scene distance field and step through it until rays get close to a surface.
+        //Only use this for static scenes and call RenderController::invalidateScene() if the scene changes anyway
+        bool use_sdf_cache = false;
+        SdfCacheFormat sdf_cache_format = SdfCacheFormat::fp16;
+        //[bytes]
+        size_t sdf_cache_memory_budget = 64U << 20U;
     };
 
     /**
@@ -91,7 +212,81 @@ namespace Raychel {
     */
     struct RenderOptions : public RaymarchOptions, public PostprocessingOptions
     {
+        //adaptive anti-aliasing. Every pixel gets one sample, pixels on edges get additional stratified samples
         bool doAA = false;
+
+        //a pixel is on an edge if one of its neighbours hit another object, has a depth that differs by more than
+        //aa_depth_threshold (relative to the closer one) or a luminance that differs by more than aa_luminance_threshold
+        float aa_depth_threshold = 0.1F;
+        float aa_luminance_threshold = 0.1F;
+
+        //edge pixels are split into aa_grid_size x aa_grid_size strata with one jittered sample each
+        size_t aa_grid_size = 3;
+
+        //edge length of the square screen tiles that are handed out to the render threads [px]
+        size_t tile_size = 16;
+
+        //render every frame at 1/8, 1/4 and 1/2 resolution first. Each of these passes is handed to the preview callback
+        bool progressive = false;
+
+        //reuse the pixels of the last frame that are still visible. Only the other pixels are raymarched. Pixels that show a
+        //reflection are never reused. Scene changes must be announced with RenderController::invalidateScene()
+        bool temporal_reprojection = false;
+
+        //reprojected pixels are dropped if a neighbour is closer by more than this fraction of their depth
+        float temporal_depth_tolerance = 0.05F;
+
+        //reprojected pixels are raymarched again after at most this many frames, so view dependent shading catches up
+        size_t temporal_max_age = 8;
+
+        //start primary rays close to the depth the last frame found around their pixel, as far as a cone march proves the way
+        //there to be empty. Independent of temporal_reprojection
+        bool temporal_depth_seeding = false;
+
+        //seeded rays start this fraction of the reprojected depth in front of it
+        float temporal_seed_margin = 0.05F;
+
+        //lamps that add less than this to a surface point (per color channel) are skipped there, and shadow rays stop once the
+        //lamp cannot add more than this anymore. Also limits the range of every lamp
+        float light_cutoff = 1e-3F;
+
+        //0 shades every lamp that reaches a surface point. Otherwise this many lamps are picked per point from a light hierarchy, in
+        //proportion to how much they are estimated to add. Noisy, but the cost only grows with the logarithm of the lamp count
+        size_t light_samples = 0;
+
+        //light diffuse surfaces indirectly from a grid of irradiance probes over the scene. Each probe marches irradiance_probe_rays rays
+        //when it is baked, after that indirect light only costs a lookup. The probes see the lamps and the background, but not each other
+        bool use_irradiance_volume = false;
+        //distance between neighbouring probes [m]. Raised if the grid would get more than irradiance_max_probes probes
+        float irradiance_probe_spacing = 1.0F;
+        size_t irradiance_max_probes = 4096;
+        size_t irradiance_probe_rays = 128;
+        //RenderController::invalidateScene(changed_bounds) bakes the probes that are at most this far away from changed_bounds again [m]
+        float irradiance_update_radius = 2.0F;
+
+        //reflect the cubemaps of the probes added with Scene::addReflectionProbe() on rough surfaces instead of marching a reflection ray.
+        //Every probe renders 6 * reflection_probe_resolution^2 rays when it is baked and keeps reflection_probe_mip_count prefiltered roughness levels
+        bool use_reflection_probes = false;
+        size_t reflection_probe_resolution = 32;
+        size_t reflection_probe_mip_count = 5;
+        //smoother surfaces still march their reflections, the sharp probe level is too coarse for mirrors
+        float reflection_probe_min_roughness = 0.1F;
+        //RenderController::invalidateScene(changed_bounds) bakes the probes whose bounds are at most this far away from changed_bounds again [m]
+        float reflection_probe_update_radius = 1.0F;
+
+        //darken ambient light (the irradiance volume, or the albedo of unlit scenes) in creases and close to other objects
+        AmbientOcclusionMode ambient_occlusion = AmbientOcclusionMode::none;
+        //objects further away than this do not occlude [m]
+        float ao_distance = 0.5F;
+        //samples along the longest axis of the scene bounds for AmbientOcclusionMode::baked. The field uses one byte per sample
+        size_t ao_field_resolution = 64;
+
+        //pixel format of the rendered images. The renderer reads pixels back for anti-aliasing, previews and reprojection,
+        //so the compact formats quantize those as well
+        FramebufferFormat framebuffer_format = FramebufferFormat::rgb32f;
+
+        //back the framebuffers returned by RenderController::getImageRendered() with huge pages, if the platform supports it
+        bool framebuffer_huge_pages = false;
     };
 
 
@@ -132,12 +327,11 @@ namespace Raychel {
     
 
     /**
-    *\brief Data that leaves the rendering step. Can be used in Postprocessing
+    *\brief Data that leaves the rendering step. The pixel it belongs to follows from its place in the framebuffer
     *\todo add ray histograms for denoising via RHF
     */
     struct RenderResult
     {
-        vec2 uv;
         color output;
     };
 
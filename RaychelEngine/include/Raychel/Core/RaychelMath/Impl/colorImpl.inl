@@ -301,6 +301,12 @@ namespace Raychel {
     {
         return (c.r + c.g + c.b) / T(3.0);
     }
+
+    template <typename T>
+    constexpr T luminance(const colorImp<T>& c) noexcept
+    {
+        return static_cast<T>((0.2126 * c.r) + (0.7152 * c.g) + (0.0722 * c.b));
+    }
 } // namespace Raychel
 
 #endif /*RAYCHEL_COLOR_IMP*/
@@ -165,6 +165,10 @@ namespace Raychel {
 
     template <typename T>
     constexpr T brightness(const colorImp<T>&) noexcept;
+
+    //relative luminance of linear Rec. 709 primaries
+    template <typename T>
+    constexpr T luminance(const colorImp<T>&) noexcept;
 } // namespace Raychel
 
 #endif /*!RAYCHEL_COLOR_H*/
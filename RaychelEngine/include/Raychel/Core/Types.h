@@ -81,6 +81,7 @@ namespace Raychel {
 	using normalized3 = vec3;
 
 	using IRaymarchable_p = not_null<gsl::owner<IRaymarchable*>>;
+	using SdLamp_p = not_null<gsl::owner<SdLamp*>>;
 	using IMaterial_p = std::unique_ptr<IMaterial>;
 
 
@@ -28,6 +28,7 @@
 #ifndef RAYCHEL_SCENE_H
 #define RAYCHEL_SCENE_H
 
+#include "Raychel/Core/LinkTypes.h"
 #include "Raychel/Core/utils.h"
 #include "Raychel/Engine/Objects/Interface.h"
 #include "Raychel/Engine/Interface/Camera.h"
@@ -37,8 +38,9 @@ namespace Raychel {
 
 
     /**
-    *\brief Unique owner for Objects, a camera and a background texture
+    *\brief Unique owner for Objects, Lamps, a camera and a background texture
     *
+    * A RenderController picks up objects, lamps and reflection probes that were added to its current scene before the next frame.
     */
     class Scene {
 
@@ -60,6 +62,17 @@ namespace Raychel {
             static_assert(std::is_constructible_v<T, Args...>, "Raychel::Scene::addObject<T, Args...> requires T to be constructible from Args...!");
             
             objects_.push_back(new T(std::forward<Args>(args)...));
+            revision_++;
+        }
+
+        template<typename T, typename... Args>
+        void addLamp(Args&&... args)
+        {
+            static_assert(std::is_base_of_v<SdLamp, T>, "Only Lamps that derive from Raychel::SdLamp can be added to a scene!");
+            static_assert(std::is_constructible_v<T, Args...>, "Raychel::Scene::addLamp<T, Args...> requires T to be constructible from Args...!");
+
+            lamps_.push_back(new T(std::forward<Args>(args)...));
+            revision_++;
         }
 
         /**
@@ -70,6 +83,14 @@ namespace Raychel {
         */
         CubeTexture<color>& setBackgroundTexture(const CubeTexture<color>& texture);
 
+        /**
+        *\brief Add a cubemap that rough surfaces inside of bounds reflect. Only used if RenderOptions::use_reflection_probes is set
+        *
+        *\param position Where the cubemap is rendered from. Should be inside of bounds and outside of all objects
+        *\param bounds Surfaces inside of this box use the probe. Should roughly match the walls around it, reflections are projected onto it
+        */
+        void addReflectionProbe(const vec3& position, const BoundingBox& bounds);
+
         /**
         *\brief Set the Camera for the scene
         *
@@ -84,6 +105,9 @@ namespace Raychel {
             for(auto ptr : objects_) {
                 delete ptr;
             }
+            for(auto ptr : lamps_) {
+                delete ptr;
+            }
         }
 
     friend class RenderController;
@@ -92,6 +116,10 @@ namespace Raychel {
         Camera cam_;
         CubeTexture<color> background_texture_;
         std::vector<IRaymarchable_p> objects_{};
+        std::vector<SdLamp_p> lamps_{};
+        std::vector<ReflectionProbePlacement> reflection_probes_{};
+        //incremented by every change that the renderer has to compile again
+        size_t revision_{0};
         //TODO: implement
         //std::vector<Camera> cams_;
     };
@@ -56,9 +56,30 @@ namespace Raychel {
         *
         *\param data parameters for the Materials surface color equation
         *\return color 
+        *
+        *\note Called on the shading hot path, so this must not throw. Report errors with RAYCHEL_REPORT_SHADING_ERROR() instead
         */
         virtual color getSurfaceColor(const ShadingData& data)const =0;
 
+        /**
+        *\brief Get the surface colors of count hits at once. Used by the wavefront renderer, which shades all hits of a material together
+        *
+        *\note The default calls getSurfaceColor() for each hit. Must not throw either
+        */
+        virtual void getSurfaceColors(const ShadingData* data, size_t count, color* out_colors) const;
+
+        /**
+        *\brief Get the ray that continues the path at a hit, like a reflection
+        *
+        *\param data parameters of the hit
+        *\param out_direction normalized direction of the secondary ray. It starts at data.surface_point
+        *\param out_weight factor for the color seen along the ray. The result is added to getSurfaceColor()
+        *\return false if the path ends at the hit
+        *
+        *\note The default ends every path. Must not throw either
+        */
+        virtual bool getSecondaryRay(const ShadingData& data, vec3& out_direction, color& out_weight) const;
+
         /**
         *\brief Set the parent Renderer used for rendering callbacks
         *
@@ -84,6 +105,18 @@ namespace Raychel {
 
         RaymarchRenderer const* parent_renderer() const noexcept { return parent_renderer_; }
 
+        //light arriving at the hit from the lamps of the scene. 1 while the material is not attached to a renderer
+        color directLighting(const ShadingData& data) const noexcept;
+
+        //diffuse light bounced off the rest of the scene. 0 while the material is not attached to a renderer
+        color indirectLighting(const ShadingData& data) const noexcept;
+
+        //true if the renderer has a prefiltered reflection for the surface point, so no reflection ray is needed
+        bool hasReflectionProbe(const ShadingData& data, float roughness) const noexcept;
+
+        //only valid if hasReflectionProbe() is true
+        color probeReflection(const ShadingData& data, const normalized3& direction, float roughness) const noexcept;
+
     private:
         //Reference to renderer that renders this materials scene
         RaymarchRenderer const* parent_renderer_=nullptr;
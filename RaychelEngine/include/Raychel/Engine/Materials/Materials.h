@@ -35,7 +35,7 @@
 namespace Raychel {
 
     /**
-    *\brief Perfectly rough Material
+    *\brief Perfectly rough Material. Lit by the lamps of the scene
     *
     */
     class DiffuseMaterial final : public Material {
@@ -60,6 +60,41 @@ namespace Raychel {
         TextureProvider<color> albedo_;
     };
 
+    /**
+    *\brief Diffuse Material with a mirror on top. reflectivity blends between the two
+    *
+    * Rough mirrors reflect the prefiltered reflection probes if the renderer has one for the surface point. Otherwise, and on smooth
+    * mirrors, a perfect reflection is marched.
+    */
+    class ReflectiveMaterial final : public Material {
+
+    public:
+
+        ReflectiveMaterial(const TextureProvider<color>& albedo, float reflectivity, float roughness=0.0F)
+            :albedo_{albedo}, reflectivity_{reflectivity}, roughness_{roughness}
+        {
+            RAYCHEL_ASSERT(reflectivity >= 0.0F && reflectivity <= 1.0F);
+            RAYCHEL_ASSERT(roughness >= 0.0F && roughness <= 1.0F);
+        }
+
+        ReflectiveMaterial(ReflectiveMaterial&& rhs) noexcept
+            :albedo_{std::move(rhs.albedo_)}, reflectivity_{rhs.reflectivity_}, roughness_{rhs.roughness_}
+        {}
+
+        void initializeTextureProviders(const vec3& parent_position, const vec3& parent_bounding_box) override;
+
+        color getSurfaceColor(const ShadingData& data) const override;
+
+        bool getSecondaryRay(const ShadingData& data, vec3& out_direction, color& out_weight) const override;
+
+        ~ReflectiveMaterial() override=default;
+
+    private:
+        TextureProvider<color> albedo_;
+        float reflectivity_;
+        float roughness_;
+    };
+
 }
 
 #endif //!RAYCHEL_MATERIALS_H
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define SD_OBJECT_INTERFACE_H
 
 #include "Raychel/Core/Types.h"
+#include "Raychel/Core/BoundingBox.h"
 #include "Raychel/Core/LinkTypes.h"
 #include "Raychel/Engine/Materials/Interface.h"
 
@@ -23,10 +24,47 @@ namespace Raychel {
 
         virtual float eval(const vec3&) const=0;
 
+        //Evaluate the SDF for every lane of a ray packet. The default implementation calls eval() once per lane
+        virtual void evalPacket(const vec3Packet& points, PacketLanes<float>& out_distances) const;
+
+        /**
+        *\brief Get a conservative bounding box of the object, if it has one
+        *
+        * The box must contain the whole surface and eval() must not be smaller than the distance to the box
+        * anywhere outside of it. Objects without bounds are evaluated on every query.
+        */
+        virtual std::optional<BoundingBox> getBounds() const { return std::nullopt; }
+
+        /**
+        *\brief Add the object to the flattened primitive store, if its shape is supported there
+        *
+        *\return true if the object was added. The renderer then evaluates the store instead of calling eval()
+        */
+        virtual bool compileInto(PrimitiveStore&) const { return false; }
+
+        /**
+        *\brief Get the object that is actually hit at p. Compound objects return the member closest to p
+        *
+        */
+        virtual const IRaymarchable* resolveHitObject(const vec3&) const { return this; }
+
         virtual vec3 getDirectionToObject(const vec3&) const=0;
 
+        //must not throw. Report errors with RAYCHEL_REPORT_SHADING_ERROR() instead
         virtual color getSurfaceColor(const ShadingData&) const=0;
 
+        //shade count hits on this object at once. The default calls getSurfaceColor() for each of them
+        virtual void getSurfaceColors(const ShadingData* data, size_t count, color* out_colors) const;
+
+        /**
+        *\brief Get the ray that continues the path at a hit, like a reflection. Must not throw
+        *
+        * The color seen along out_direction is multiplied with out_weight and added to getSurfaceColor()
+        *
+        *\return false if the path ends at the hit, which is the default
+        */
+        virtual bool getSecondaryRay(const ShadingData&, vec3& /*out_direction*/, color& /*out_weight*/) const { return false; }
+
         virtual void onRendererAttached(const not_null<RaymarchRenderer*>)=0;
 
         virtual ~IRaymarchable()=default;
@@ -49,6 +87,10 @@ namespace Raychel {
 
         color getSurfaceColor(const ShadingData& data) const override;
 
+        void getSurfaceColors(const ShadingData* data, size_t count, color* out_colors) const override;
+
+        bool getSecondaryRay(const ShadingData& data, vec3& out_direction, color& out_weight) const override;
+
         void onRendererAttached(const not_null<RaymarchRenderer*> attached_renderer) override;
 
         virtual ~SdObject()=default;
@@ -73,25 +115,34 @@ namespace Raychel {
         return ObjectData{ transform, std::make_unique<Mat>(std::forward<Mat>(mat)) };
     }
 
-    class SdLamp : public IRaymarchable
+    /**
+    *\brief Base class for non-physical light sources. Lamps are not marched, they only light the surfaces around them
+    *
+    */
+    class SdLamp
     {
+    public:
         SdLamp(const SdLamp&)=delete;
         SdLamp& operator=(const SdLamp&)=delete;
         SdLamp(SdLamp&&)=delete;
         SdLamp& operator=(SdLamp&&)=delete;
-    
-    protected:
 
-        SdLamp(const LampData& _data)
-            :color_{_data.c}, brightness_{_data.b}, size_{_data.sz}
-        {}
+        //point the light is emitted from
+        virtual vec3 position() const noexcept=0;
 
         color lampColor() const noexcept { return color_; }
         float brightness() const noexcept { return brightness_; }
+        //radius of the lamp [m]. Larger lamps cast softer shadows, 0 casts hard ones
         float size() const noexcept { return size_; }
 
-        virtual ~SdLamp()=0;
-        
+        virtual ~SdLamp()=default;
+
+    protected:
+
+        SdLamp(const LampData& _data)
+            :color_{_data.c}, brightness_{_data.b}, size_{_data.sz}
+        {}
+
     private:
         color color_;
         float brightness_{1.0};
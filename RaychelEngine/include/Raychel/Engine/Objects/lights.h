@@ -12,6 +12,8 @@ namespace Raychel {
             :SdLamp(data), transform_{t}
         {}
 
+        vec3 position() const noexcept override { return transform_.position; }
+
     private:
         Transform transform_;
     };
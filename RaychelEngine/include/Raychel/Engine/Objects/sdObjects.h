@@ -14,6 +14,12 @@ namespace Raychel {
 
         float eval(const vec3& p) const override;
 
+        void evalPacket(const vec3Packet& points, PacketLanes<float>& out_distances) const override;
+
+        std::optional<BoundingBox> getBounds() const override;
+
+        bool compileInto(PrimitiveStore& store) const override;
+
         private:
             float radius=0;
     };
@@ -0,0 +1,461 @@
+/**
+*\file Framebuffer.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for index addressed framebuffers with compact pixel formats
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_FRAMEBUFFER_H
+#define RAYCHEL_FRAMEBUFFER_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "Raychel/Core/Half.h"
+#include "Raychel/Core/LinkTypes.h"
+
+namespace Raychel {
+
+    namespace details {
+
+        //32 bit words per pixel
+        constexpr size_t framebufferPixelWords(FramebufferFormat format) noexcept
+        {
+            switch(format) {
+                case FramebufferFormat::rgb32f:
+                    return 3;
+                case FramebufferFormat::rgba16f:
+                    return 2;
+                case FramebufferFormat::rgb10a2:
+                case FramebufferFormat::srgba8:
+                    return 1;
+            }
+            return 3;
+        }
+
+        inline std::uint32_t quantizeUnorm(float value, float max_value) noexcept
+        {
+            return static_cast<std::uint32_t>((std::clamp(value, 0.0F, 1.0F) * max_value) + 0.5F);
+        }
+
+        inline std::uint32_t encodeSrgb(float linear) noexcept
+        {
+            const float value = std::clamp(linear, 0.0F, 1.0F);
+            if(value <= 0.0031308F) {
+                return quantizeUnorm(value * 12.92F, 255.0F);
+            }
+            return quantizeUnorm((1.055F * std::pow(value, 1.0F / 2.4F)) - 0.055F, 255.0F);
+        }
+
+        inline float decodeSrgb(std::uint32_t code) noexcept
+        {
+            static const auto table = []{
+                std::array<float, 256> values{};
+                for(size_t i = 0; i < values.size(); i++) {
+                    const float value = static_cast<float>(i) / 255.0F;
+                    values[i] = (value <= 0.04045F) ? (value / 12.92F) : std::pow((value + 0.055F) / 1.055F, 2.4F);
+                }
+                return values;
+            }();
+            return table[code & 0xFFU];
+        }
+
+        inline void encodePixel(FramebufferFormat format, const color& c, std::uint32_t* out_words) noexcept
+        {
+            switch(format) {
+                case FramebufferFormat::rgb32f:
+                    std::memcpy(out_words, &c.r, sizeof(float));
+                    std::memcpy(out_words + 1, &c.g, sizeof(float));
+                    std::memcpy(out_words + 2, &c.b, sizeof(float));
+                    return;
+                case FramebufferFormat::rgba16f:
+                    out_words[0] = floatToHalf(c.r) | (static_cast<std::uint32_t>(floatToHalf(c.g)) << 16U);
+                    //alpha is always 1
+                    out_words[1] = floatToHalf(c.b) | (0x3C00U << 16U);
+                    return;
+                case FramebufferFormat::rgb10a2:
+                    out_words[0] = quantizeUnorm(c.r, 1023.0F) | (quantizeUnorm(c.g, 1023.0F) << 10U) | (quantizeUnorm(c.b, 1023.0F) << 20U) | (3U << 30U);
+                    return;
+                case FramebufferFormat::srgba8:
+                    out_words[0] = encodeSrgb(c.r) | (encodeSrgb(c.g) << 8U) | (encodeSrgb(c.b) << 16U) | (0xFFU << 24U);
+                    return;
+            }
+        }
+
+        inline color decodePixel(FramebufferFormat format, const std::uint32_t* words) noexcept
+        {
+            switch(format) {
+                case FramebufferFormat::rgb32f: {
+                    color c;
+                    std::memcpy(&c.r, words, sizeof(float));
+                    std::memcpy(&c.g, words + 1, sizeof(float));
+                    std::memcpy(&c.b, words + 2, sizeof(float));
+                    return c;
+                }
+                case FramebufferFormat::rgba16f:
+                    return {
+                        halfToFloat(static_cast<std::uint16_t>(words[0] & 0xFFFFU)),
+                        halfToFloat(static_cast<std::uint16_t>(words[0] >> 16U)),
+                        halfToFloat(static_cast<std::uint16_t>(words[1] & 0xFFFFU))};
+                case FramebufferFormat::rgb10a2:
+                    return {
+                        static_cast<float>(words[0] & 0x3FFU) / 1023.0F,
+                        static_cast<float>((words[0] >> 10U) & 0x3FFU) / 1023.0F,
+                        static_cast<float>((words[0] >> 20U) & 0x3FFU) / 1023.0F};
+                case FramebufferFormat::srgba8:
+                    return {decodeSrgb(words[0]), decodeSrgb(words[0] >> 8U), decodeSrgb(words[0] >> 16U)};
+            }
+            return color{0};
+        }
+
+    } // namespace details
+
+    /**
+    *\brief Size of one pixel of format [bytes]
+    *
+    */
+    constexpr size_t framebufferPixelSize(FramebufferFormat format) noexcept
+    {
+        return details::framebufferPixelWords(format) * sizeof(std::uint32_t);
+    }
+
+    /**
+    *\brief Non-owning, read only view of a framebuffer. Render targets read all pixel formats through this
+    *
+    * Pixels are stored row by row, starting at the bottom left of the image.
+    */
+    class FramebufferView {
+
+    public:
+
+        FramebufferView()=default;
+
+        FramebufferView(const std::uint32_t* pixels, const vec2i& size, FramebufferFormat format) noexcept
+            :pixels_{pixels}, size_{size}, format_{format}
+        {}
+
+        vec2i size() const noexcept
+        {
+            return size_;
+        }
+
+        FramebufferFormat format() const noexcept
+        {
+            return format_;
+        }
+
+        size_t pixelCount() const noexcept
+        {
+            return size_.x * size_.y;
+        }
+
+        //raw pixel data. Its layout depends on format()
+        const std::uint32_t* data() const noexcept
+        {
+            return pixels_;
+        }
+
+        color load(size_t index) const noexcept
+        {
+            RAYCHEL_ASSERT(index < pixelCount());
+            return details::decodePixel(format_, pixels_ + (index * details::framebufferPixelWords(format_)));
+        }
+
+        color at(const vec2i& pixel) const noexcept
+        {
+            return load((pixel.y * size_.x) + pixel.x);
+        }
+
+        /**
+        *\brief Decode one row of pixels
+        *
+        *\param y Row to decode
+        *\param out_colors Receives size().x colors
+        */
+        void loadRow(size_t y, color* out_colors) const noexcept
+        {
+            RAYCHEL_ASSERT(y < size_.y);
+
+            const size_t words = details::framebufferPixelWords(format_);
+            const std::uint32_t* row = pixels_ + (y * size_.x * words);
+            for(size_t x = 0; x < size_.x; x++) {
+                out_colors[x] = details::decodePixel(format_, row + (x * words));
+            }
+        }
+
+    private:
+
+        const std::uint32_t* pixels_{nullptr};
+        vec2i size_;
+        FramebufferFormat format_{FramebufferFormat::rgb32f};
+    };
+
+    /**
+    *\brief Non-owning, writable view of a framebuffer. Can point to a Framebuffer or to memory owned by the caller
+    *
+    * Writing through a span does not change the span itself, so const spans can be handed to the render threads.
+    */
+    class FramebufferSpan {
+
+    public:
+
+        FramebufferSpan()=default;
+
+        /**
+        *\brief Wrap caller memory
+        *
+        *\param pixels Must hold at least framebufferWordCount(size, format) words and outlive the span
+        */
+        FramebufferSpan(std::uint32_t* pixels, const vec2i& size, FramebufferFormat format) noexcept
+            :pixels_{pixels}, size_{size}, format_{format}
+        {}
+
+        vec2i size() const noexcept
+        {
+            return size_;
+        }
+
+        FramebufferFormat format() const noexcept
+        {
+            return format_;
+        }
+
+        size_t pixelCount() const noexcept
+        {
+            return size_.x * size_.y;
+        }
+
+        std::uint32_t* data() const noexcept
+        {
+            return pixels_;
+        }
+
+        void store(size_t index, const color& c) const noexcept
+        {
+            RAYCHEL_ASSERT(index < pixelCount());
+            details::encodePixel(format_, c, pixels_ + (index * details::framebufferPixelWords(format_)));
+        }
+
+        void store(const vec2i& pixel, const color& c) const noexcept
+        {
+            store((pixel.y * size_.x) + pixel.x, c);
+        }
+
+        color load(size_t index) const noexcept
+        {
+            return view().load(index);
+        }
+
+        color at(const vec2i& pixel) const noexcept
+        {
+            return view().at(pixel);
+        }
+
+        FramebufferView view() const noexcept
+        {
+            return {pixels_, size_, format_};
+        }
+
+        /*implicit*/ operator FramebufferView() const noexcept
+        {
+            return view();
+        }
+
+    private:
+
+        std::uint32_t* pixels_{nullptr};
+        vec2i size_;
+        FramebufferFormat format_{FramebufferFormat::rgb32f};
+    };
+
+    /**
+    *\brief Number of 32 bit words a framebuffer of size and format occupies
+    *
+    */
+    constexpr size_t framebufferWordCount(const vec2i& size, FramebufferFormat format) noexcept
+    {
+        return size.x * size.y * details::framebufferPixelWords(format);
+    }
+
+    /**
+    *\brief Uninitialized pixel memory of a Framebuffer.
+    *
+    * Huge page backed memory is mapped directly and aligned to huge page boundaries, so the kernel can back it with
+    * transparent huge pages. This cuts the TLB misses of the render threads on large framebuffers. Platforms that do not
+    * support this get normal heap memory.
+    */
+    class FramebufferMemory {
+
+    public:
+
+        FramebufferMemory()=default;
+
+        FramebufferMemory(size_t word_count, bool use_huge_pages);
+
+        FramebufferMemory(const FramebufferMemory&)=delete;
+        FramebufferMemory& operator=(const FramebufferMemory&)=delete;
+
+        FramebufferMemory(FramebufferMemory&& other) noexcept;
+        FramebufferMemory& operator=(FramebufferMemory&& other) noexcept;
+
+        std::uint32_t* data() const noexcept
+        {
+            return words_;
+        }
+
+        //[32 bit words]
+        size_t capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        bool usesHugePages() const noexcept
+        {
+            return mapped_bytes_ != 0;
+        }
+
+        ~FramebufferMemory();
+
+    private:
+
+        void _free() noexcept;
+
+        std::uint32_t* words_{nullptr};
+        size_t capacity_{0};
+        //size of the mapping if the memory was mapped for huge pages, 0 otherwise
+        size_t mapped_bytes_{0};
+    };
+
+    /**
+    *\brief Rendered image. Pixels are addressed by their index and stored in one of the FramebufferFormats
+    *
+    * Compact formats quantize the stored colors, so load() might not return exactly what was stored. Storing what load() returned
+    * does not change the pixel any further.
+    */
+    class Framebuffer {
+
+    public:
+
+        Framebuffer()=default;
+
+        Framebuffer(const vec2i& size, FramebufferFormat format)
+            :Framebuffer{FramebufferMemory{framebufferWordCount(size, format), false}, size, format}
+        {}
+
+        /**
+        *\brief Use existing memory, for example from a FramebufferPool
+        *
+        *\param memory Must hold at least framebufferWordCount(size, format) words
+        */
+        Framebuffer(FramebufferMemory&& memory, const vec2i& size, FramebufferFormat format) noexcept
+            :size_{size}, format_{format}, memory_{std::move(memory)}
+        {
+            RAYCHEL_ASSERT(memory_.capacity() >= framebufferWordCount(size_, format_));
+        }
+
+        vec2i size() const noexcept
+        {
+            return size_;
+        }
+
+        FramebufferFormat format() const noexcept
+        {
+            return format_;
+        }
+
+        size_t pixelCount() const noexcept
+        {
+            return size_.x * size_.y;
+        }
+
+        //memory used by the pixels [bytes]
+        size_t memoryUsage() const noexcept
+        {
+            return framebufferWordCount(size_, format_) * sizeof(std::uint32_t);
+        }
+
+        void store(size_t index, const color& c) noexcept
+        {
+            span().store(index, c);
+        }
+
+        void store(const vec2i& pixel, const color& c) noexcept
+        {
+            span().store(pixel, c);
+        }
+
+        color load(size_t index) const noexcept
+        {
+            return view().load(index);
+        }
+
+        color at(const vec2i& pixel) const noexcept
+        {
+            return view().at(pixel);
+        }
+
+        FramebufferView view() const noexcept
+        {
+            return {memory_.data(), size_, format_};
+        }
+
+        FramebufferSpan span() noexcept
+        {
+            return {memory_.data(), size_, format_};
+        }
+
+        /*implicit*/ operator FramebufferView() const noexcept
+        {
+            return view();
+        }
+
+        /*implicit*/ operator FramebufferSpan() noexcept
+        {
+            return span();
+        }
+
+        /**
+        *\brief Take the pixel memory out of the framebuffer, so it can be reused. Leaves an empty framebuffer behind
+        *
+        */
+        FramebufferMemory releaseMemory() noexcept
+        {
+            size_ = vec2i{};
+            return std::move(memory_);
+        }
+
+    private:
+
+        vec2i size_;
+        FramebufferFormat format_{FramebufferFormat::rgb32f};
+        FramebufferMemory memory_;
+    };
+
+}
+
+#endif //!RAYCHEL_FRAMEBUFFER_H
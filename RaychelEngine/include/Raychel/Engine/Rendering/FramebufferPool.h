@@ -0,0 +1,95 @@
+/**
+*\file FramebufferPool.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the framebuffer memory pool
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_FRAMEBUFFER_POOL_H
+#define RAYCHEL_FRAMEBUFFER_POOL_H
+
+#include <atomic>
+#include <mutex>
+
+#include "Raychel/Engine/Rendering/Framebuffer.h"
+
+namespace Raychel {
+
+    /**
+    *\brief Recycles the memory of framebuffers that are no longer needed.
+    *
+    * Once as many framebuffers as an application keeps alive at the same time have been released, acquire() does not allocate
+    * anymore. release() may be called from any thread.
+    */
+    class FramebufferPool {
+
+    public:
+
+        FramebufferPool()=default;
+
+        FramebufferPool(const FramebufferPool&)=delete;
+        FramebufferPool& operator=(const FramebufferPool&)=delete;
+        FramebufferPool(FramebufferPool&&)=delete;
+        FramebufferPool& operator=(FramebufferPool&&)=delete;
+
+        /**
+        *\brief Get a framebuffer with uninitialized pixels. Reuses released memory if any of it is large enough
+        *
+        */
+        Framebuffer acquire(const vec2i& size, FramebufferFormat format);
+
+        /**
+        *\brief Hand the memory of framebuffer back to the pool
+        *
+        */
+        void release(Framebuffer&& framebuffer) noexcept;
+
+        //new memory is mapped with huge pages if possible. Drops all pooled memory if the setting changes
+        void setUseHugePages(bool use_huge_pages) noexcept;
+
+        //free all pooled memory
+        void clear() noexcept;
+
+        //number of times the pool had to allocate memory
+        size_t allocationCount() const noexcept
+        {
+            return allocation_count_;
+        }
+
+    private:
+
+        //more free buffers than this are dropped. RenderController::renderToTarget() keeps queue_depth + 2 framebuffers alive
+        static constexpr size_t max_free_buffers = 8;
+
+        std::mutex mtx_;
+        std::array<FramebufferMemory, max_free_buffers> free_;
+        size_t free_count_{0};
+
+        bool use_huge_pages_{false};
+        //read without the mutex by allocationCount()
+        std::atomic_size_t allocation_count_{0};
+    };
+
+}
+
+#endif //!RAYCHEL_FRAMEBUFFER_POOL_H
@@ -0,0 +1,158 @@
+/**
+*\file AmbientOcclusionField.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the baked ambient occlusion field
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_AMBIENT_OCCLUSION_FIELD_H
+#define RAYCHEL_AMBIENT_OCCLUSION_FIELD_H
+
+#include <algorithm>
+#include <functional>
+
+#include "Raychel/Core/BoundingBox.h"
+#include "Raychel/Core/LinkTypes.h"
+#include "Raychel/Misc/Concurrency/CancellationToken.h"
+#include "Raychel/Misc/Concurrency/WorkStealingPool.h"
+
+namespace Raychel {
+
+    /**
+    *\brief Shape of an AmbientOcclusionField and the cost of its last update
+    *
+    */
+    struct AmbientOcclusionFieldStats
+    {
+        //samples per axis
+        std::array<size_t, 3> grid_size{0, 0, 0};
+        float sample_spacing{0.0F};
+
+        size_t block_count{0};
+        //blocks that were baked by the last update and the samples in them
+        size_t updated_block_count{0};
+        size_t updated_sample_count{0};
+
+        size_t memory_usage{0};
+    };
+
+    std::ostream& operator<<(std::ostream& os, const AmbientOcclusionFieldStats& stats);
+
+    /**
+    *\brief Ambient occlusion of a static scene, sampled on a regular grid and stored with 8 bits per sample
+    *
+    * The samples are grouped into blocks of block_samples^3, which are the unit of re-baking. Lookups interpolate the 8 samples
+    * around a point trilinearly.
+    */
+    class AmbientOcclusionField {
+
+    public:
+
+        //ambient occlusion in [0; 1] at p, where 1 is unoccluded. Called concurrently
+        using OcclusionFunction = std::function<float(const vec3& p)>;
+
+        AmbientOcclusionField()=default;
+
+        /**
+        *\brief Place the samples over bounds. All blocks are dirty afterwards
+        *
+        *\param resolution Samples along the longest axis of bounds
+        */
+        void setBounds(const BoundingBox& bounds, size_t resolution);
+
+        //mark the blocks that overlap region for the next update()
+        void markDirty(const BoundingBox& region) noexcept;
+
+        bool hasDirtyBlocks() const noexcept
+        {
+            return std::find(dirty_.cbegin(), dirty_.cend(), std::uint8_t{1}) != dirty_.cend();
+        }
+
+        //bake all dirty blocks in parallel. cancelled is checked before every block, the blocks that were not baked once it returns true stay dirty
+        void update(const OcclusionFunction& occlusion, WorkStealingPool& workers, const CancelFunction& cancelled={});
+
+        void clear() noexcept;
+
+        //reset the update counters of stats(), so frames without an update report 0 baked blocks
+        void clearUpdateStats() noexcept
+        {
+            stats_.updated_block_count = 0;
+            stats_.updated_sample_count = 0;
+        }
+
+        //true once every block was baked
+        bool isBaked() const noexcept
+        {
+            return baked_;
+        }
+
+        const BoundingBox& bounds() const noexcept
+        {
+            return bounds_;
+        }
+
+        /**
+        *\brief Interpolated ambient occlusion at p
+        *
+        *\param out_occlusion Set if p is inside of the baked field
+        *\return true if p is inside of the baked field
+        */
+        bool occlusion(const vec3& p, float& out_occlusion) const noexcept;
+
+        const AmbientOcclusionFieldStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+        //samples per block axis
+        static constexpr size_t block_samples = 8;
+
+    private:
+
+        size_t _sampleIndex(size_t x, size_t y, size_t z) const noexcept
+        {
+            return x + (grid_size_[0] * (y + (grid_size_[1] * z)));
+        }
+
+        size_t _blockIndex(size_t x, size_t y, size_t z) const noexcept
+        {
+            return x + (block_count_[0] * (y + (block_count_[1] * z)));
+        }
+
+        bool baked_{false};
+
+        BoundingBox bounds_;
+        std::array<size_t, 3> grid_size_{0, 0, 0};
+        std::array<size_t, 3> block_count_{0, 0, 0};
+        float spacing_{0.0F};
+
+        //occlusion quantized to [0; 255]
+        std::vector<std::uint8_t> samples_;
+        std::vector<std::uint8_t> dirty_;
+
+        AmbientOcclusionFieldStats stats_;
+    };
+
+}
+
+#endif //!RAYCHEL_AMBIENT_OCCLUSION_FIELD_H
@@ -0,0 +1,171 @@
+/**
+*\file IrradianceVolume.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the grid of spherical harmonic irradiance probes
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_IRRADIANCE_VOLUME_H
+#define RAYCHEL_IRRADIANCE_VOLUME_H
+
+#include <algorithm>
+#include <functional>
+
+#include "Raychel/Core/BoundingBox.h"
+#include "Raychel/Core/LinkTypes.h"
+#include "Raychel/Misc/Concurrency/CancellationToken.h"
+#include "Raychel/Misc/Concurrency/WorkStealingPool.h"
+
+namespace Raychel {
+
+    /**
+    *\brief Shape of an IrradianceVolume and the cost of its last update
+    *
+    */
+    struct IrradianceVolumeStats
+    {
+        //probes per axis
+        std::array<size_t, 3> grid_size{0, 0, 0};
+        float probe_spacing{0.0F};
+
+        size_t probe_count{0};
+        //probes outside of all objects. Only these are used for lookups
+        size_t valid_probe_count{0};
+
+        //probes that were baked by the last update and the rays they marched
+        size_t updated_probe_count{0};
+        size_t ray_count{0};
+
+        size_t memory_usage{0};
+    };
+
+    std::ostream& operator<<(std::ostream& os, const IrradianceVolumeStats& stats);
+
+    /**
+    *\brief Grid of probes that store the irradiance arriving from every direction as second order spherical harmonics.
+    *
+    * Every probe marches a fixed set of rays, projects the light they see onto 9 SH coefficients per color channel and convolves
+    * them with the cosine lobe (Ramamoorthi and Hanrahan, 2001). A lookup blends the 8 probes around a point and evaluates them
+    * for the surface normal, which replaces the secondary rays of diffuse indirect lighting.
+    *
+    * Probes are baked when they are marked dirty, so moving objects only costs the probes around them.
+    */
+    class IrradianceVolume {
+
+    public:
+
+        //light arriving at origin from direction. Called concurrently
+        using RadianceFunction = std::function<color(const vec3& origin, const normalized3& direction)>;
+        //signed scene distance. Probes with negative distances are inside of objects
+        using DistanceFunction = std::function<float(const vec3& p)>;
+
+        IrradianceVolume()=default;
+
+        /**
+        *\brief Place probes about spacing apart over bounds. All probes are dirty afterwards
+        *
+        *\param max_probe_count The spacing is increased until the grid has at most this many probes
+        */
+        void setBounds(const BoundingBox& bounds, float spacing, size_t max_probe_count);
+
+        //mark the probes that are at most radius away from region for the next update()
+        void markDirty(const BoundingBox& region, float radius) noexcept;
+
+        bool hasDirtyProbes() const noexcept
+        {
+            return std::find(dirty_.cbegin(), dirty_.cend(), std::uint8_t{1}) != dirty_.cend();
+        }
+
+        /**
+        *\brief Bake all dirty probes in parallel
+        *
+        *\param ray_count Rays per probe
+        *\param cancelled Checked before every probe. Probes that were not baked once it returns true stay dirty
+        */
+        void update(const DistanceFunction& distance, const RadianceFunction& radiance, size_t ray_count, WorkStealingPool& workers, const CancelFunction& cancelled={});
+
+        void clear() noexcept;
+
+        //reset the update counters of stats(), so frames without an update report 0 baked probes
+        void clearUpdateStats() noexcept
+        {
+            stats_.updated_probe_count = 0;
+            stats_.ray_count = 0;
+        }
+
+        //true once every probe was baked
+        bool isBaked() const noexcept
+        {
+            return baked_;
+        }
+
+        const BoundingBox& bounds() const noexcept
+        {
+            return bounds_;
+        }
+
+        /**
+        *\brief Irradiance divided by pi at p for a surface facing n, so diffuse materials only have to multiply it with their albedo
+        *
+        * Returns 0 outside of the volume and where no valid probe is close.
+        */
+        color irradiance(const vec3& p, const normalized3& n) const noexcept;
+
+        const IrradianceVolumeStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+        static constexpr size_t sh_coefficient_count = 9;
+
+    private:
+
+        using ShCoefficients = std::array<color, sh_coefficient_count>;
+
+        size_t _probeIndex(size_t x, size_t y, size_t z) const noexcept
+        {
+            return x + (grid_size_[0] * (y + (grid_size_[1] * z)));
+        }
+
+        vec3 _probePosition(size_t x, size_t y, size_t z) const noexcept
+        {
+            return bounds_.min + (vec3{static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)} * spacing_);
+        }
+
+        bool baked_{false};
+
+        BoundingBox bounds_;
+        std::array<size_t, 3> grid_size_{0, 0, 0};
+        float spacing_{0.0F};
+
+        //convolved coefficients of every probe, already divided by pi
+        std::vector<ShCoefficients> probes_;
+        std::vector<std::uint8_t> valid_;
+        std::vector<std::uint8_t> dirty_;
+
+        IrradianceVolumeStats stats_;
+    };
+
+}
+
+#endif //!RAYCHEL_IRRADIANCE_VOLUME_H
@@ -0,0 +1,122 @@
+/**
+*\file LightBvh.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the light hierarchy used to sample lamps by importance
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_LIGHT_BVH_H
+#define RAYCHEL_LIGHT_BVH_H
+
+#include "Raychel/Core/BoundingBox.h"
+#include "Raychel/Core/LinkTypes.h"
+
+namespace Raychel {
+
+    /**
+    *\brief What the light hierarchy needs to know about a lamp
+    *
+    */
+    struct LightBounds
+    {
+        vec3 position;
+        float radius{0.0F};
+        //largest color channel of the intensity
+        float power{0.0F};
+        //distance from position past which the lamp does not light anything
+        float range{0.0F};
+    };
+
+    /**
+    *\brief Lamp picked by LightBvh::sample()
+    *
+    */
+    struct LightSample
+    {
+        //index into the lights the hierarchy was built over
+        size_t light{0};
+        //probability of picking this lamp. 0 if the walk ended in a subtree that cannot light the point, light is invalid then
+        float pdf{0.0F};
+    };
+
+    /**
+    *\brief Bounding volume hierarchy over the lamps of a scene.
+    *
+    * Every node knows the summed power and the largest range of its lamps. Sampling walks from the root to a single lamp and picks
+    * each child in proportion to its estimated contribution, so picking a lamp costs O(log n) and bright, close lamps are picked most.
+    * Subtrees that are out of range or behind the surface are never picked.
+    */
+    class LightBvh {
+
+    public:
+
+        LightBvh()=default;
+
+        void build(const std::vector<LightBounds>& lights);
+
+        /**
+        *\brief Pick a lamp for the surface point p with normal n
+        *
+        *\param u Uniform random number in [0; 1). Stratifying u stratifies the picked lamps
+        */
+        LightSample sample(const vec3& p, const vec3& n, float u) const noexcept;
+
+        size_t lightCount() const noexcept
+        {
+            return lights_.size();
+        }
+
+        size_t nodeCount() const noexcept
+        {
+            return nodes_.size();
+        }
+
+    private:
+
+        //leaves hold exactly one lamp, inner nodes have their children at first and first+1
+        struct Node
+        {
+            BoundingBox bounds;
+            float power{0.0F};
+            float range{0.0F};
+            std::uint32_t first{0};
+            bool is_leaf{false};
+        };
+
+        void _buildNode(size_t node_index, size_t begin, size_t end);
+
+        //estimated contribution of the lamps below node to p. 0 if none of them can light p
+        float _importance(const Node& node, const vec3& p, const vec3& n) const noexcept;
+
+        //conservative test whether a lamp below node can light p. Exact for leaves
+        bool _canReach(const Node& node, const vec3& p, const vec3& n) const noexcept;
+
+        std::vector<Node> nodes_;
+        std::vector<LightBounds> lights_;
+        //lamp index of each entry of lights_ in the order of the tree
+        std::vector<std::uint32_t> light_indices_;
+    };
+
+}
+
+#endif //!RAYCHEL_LIGHT_BVH_H
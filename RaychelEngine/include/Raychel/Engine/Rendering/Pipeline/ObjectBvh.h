@@ -0,0 +1,177 @@
+/**
+*\file ObjectBvh.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the bounding volume hierarchy over scene objects
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_OBJECT_BVH_H
+#define RAYCHEL_OBJECT_BVH_H
+
+#include "Raychel/Core/BoundingBox.h"
+#include "Raychel/Core/LinkTypes.h"
+#include "Raychel/Misc/Concurrency/WorkStealingPool.h"
+
+namespace Raychel {
+
+    /**
+    *\brief Shape of a built ObjectBvh
+    *
+    */
+    struct BvhStats
+    {
+        //objects with bounds that live in the tree
+        size_t num_objects{0};
+        //objects without bounds that are evaluated on every query
+        size_t num_unbounded{0};
+
+        size_t node_count{0};
+        size_t leaf_count{0};
+        size_t max_depth{0};
+    };
+
+    std::ostream& operator<<(std::ostream& os, const BvhStats& stats);
+
+    /**
+    *\brief Result of a closest object query
+    *
+    */
+    struct ObjectDistance
+    {
+        float distance{0.0F};
+        //nullptr if no object is closer than the initial distance
+        const IRaymarchable* object{nullptr};
+    };
+
+    /**
+    *\brief Bounding volume hierarchy over the bounded objects of a scene.
+    *
+    * Distance queries skip every subtree whose bounding box is further away than the smallest distance found so far,
+    * which is only valid because IRaymarchable::getBounds() has to be conservative.
+    */
+    class ObjectBvh {
+
+    public:
+
+        ObjectBvh()=default;
+
+        /**
+        *\brief (Re-)build the hierarchy. Large scenes are split into subtrees that are built in parallel
+        *
+        *\param objects Objects to build the tree over. Must outlive the ObjectBvh
+        *\param workers Pool used for building the subtrees
+        */
+        void build(const std::vector<not_null<const IRaymarchable*>>& objects, WorkStealingPool& workers);
+
+        /**
+        *\brief Get min(current_min, min(obj.eval(p))) over all objects
+        *
+        */
+        float distance(const vec3& p, float current_min) const
+        {
+            return closestObject(p, current_min).distance;
+        }
+
+        /**
+        *\brief Same as distance(), but also return the object the distance belongs to
+        *
+        */
+        ObjectDistance closestObject(const vec3& p, float current_min) const;
+
+        /**
+        *\brief Lane-wise version of closestObject(). inout_objects is only written for lanes where a closer object was found
+        *
+        *\param active Lanes whose results are needed. The other lanes do not keep nodes from being skipped
+        */
+        void distancePacket(const vec3Packet& points, const PacketLanes<bool>& active, PacketLanes<float>& inout_distances, PacketLanes<const IRaymarchable*>& inout_objects) const;
+
+        /**
+        *\brief Collect all objects with obj.eval(p) <= max_distance
+        *
+        *\param out_objects Receives the first capacity objects
+        *\return size_t Total number of objects found. If this is larger than capacity, out_objects is incomplete
+        */
+        size_t objectsWithin(const vec3& p, float max_distance, const IRaymarchable** out_objects, size_t capacity) const;
+
+        const BvhStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+        /**
+        *\brief Bounds of all bounded objects. Empty if there are none
+        *
+        */
+        BoundingBox bounds() const noexcept
+        {
+            return nodes_.empty() ? BoundingBox{} : nodes_.front().bounds;
+        }
+
+    private:
+
+        static constexpr size_t max_leaf_objects = 4;
+        static constexpr size_t max_stack_depth = 64;
+
+        //inner nodes have object_count == 0 and their children at first and first+1
+        struct Node
+        {
+            BoundingBox bounds;
+            std::uint32_t first{0};
+            std::uint32_t object_count{0};
+        };
+
+        struct BuildItem
+        {
+            BoundingBox bounds;
+            vec3 centroid;
+            const IRaymarchable* object{nullptr};
+        };
+
+        struct PendingSubtree
+        {
+            size_t node_index{0};
+            size_t begin{0}, end{0};
+        };
+
+        void _buildNode(std::vector<Node>& nodes, size_t node_index, size_t begin, size_t end, std::vector<PendingSubtree>* pending, size_t pending_size);
+
+        void _spliceSubtree(size_t node_index, const std::vector<Node>& subtree);
+
+        void _collectStats();
+
+        //see IRaymarchable::getBounds()
+        static bool _canSkip(float box_distance, float current_min) noexcept
+        {
+            return (box_distance > 0.0F) && (box_distance >= current_min);
+        }
+
+        std::vector<Node> nodes_;
+        std::vector<BuildItem> items_;
+        std::vector<const IRaymarchable*> unbounded_;
+
+        BvhStats stats_;
+    };
+
+}
+
+#endif //!RAYCHEL_OBJECT_BVH_H
@@ -0,0 +1,116 @@
+/**
+*\file PrimitiveStore.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the flattened structure-of-arrays primitive store
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_PRIMITIVE_STORE_H
+#define RAYCHEL_PRIMITIVE_STORE_H
+
+#include "Raychel/Core/LinkTypes.h"
+
+namespace Raychel {
+
+    /**
+    *\brief All spheres of a scene as contiguous arrays
+    *
+    */
+    struct SphereBucket
+    {
+        std::vector<float> center_x, center_y, center_z, radius;
+
+        //object each sphere was compiled from. Used for identifying hit objects
+        std::vector<const IRaymarchable*> owners;
+
+        size_t size() const noexcept
+        {
+            return radius.size();
+        }
+
+        vec3 center(size_t i) const noexcept
+        {
+            return vec3{center_x[i], center_y[i], center_z[i]};
+        }
+    };
+
+    /**
+    *\brief Get min(|p - center| - radius) over the spheres [begin; end) of the bucket. Uses AVX2 or SSE2 if available
+    *
+    */
+    float sphereMinDistance(const SphereBucket& bucket, size_t begin, size_t end, const vec3& p) noexcept;
+
+    class SphereCluster;
+
+    /**
+    *\brief Flattened storage for simple primitives.
+    *
+    * Objects that support it (see IRaymarchable::compileInto()) are stored in one structure-of-arrays bucket per primitive type.
+    * finalize() sorts every bucket spatially and cuts it into small clusters. Each cluster is an IRaymarchable, so the clusters can be
+    * put into the ObjectBvh instead of the original objects, which replaces one virtual call per primitive with one per cluster.
+    */
+    class PrimitiveStore {
+
+    public:
+
+        PrimitiveStore();
+
+        PrimitiveStore(const PrimitiveStore&)=delete;
+        PrimitiveStore& operator=(const PrimitiveStore&)=delete;
+        PrimitiveStore(PrimitiveStore&&)=delete;
+        PrimitiveStore& operator=(PrimitiveStore&&)=delete;
+
+        void addSphere(const vec3& center, float radius, not_null<const IRaymarchable*> owner);
+
+        /**
+        *\brief Remove all primitives and clusters
+        *
+        */
+        void clear();
+
+        /**
+        *\brief Sort the buckets and build the clusters. Must be called after the last primitive was added
+        *
+        *\param out_objects Receives one object per cluster. The clusters are owned by the store and live until clear() is called
+        */
+        void finalize(std::vector<not_null<const IRaymarchable*>>& out_objects);
+
+        const SphereBucket& spheres() const noexcept
+        {
+            return spheres_;
+        }
+
+        ~PrimitiveStore();
+
+    private:
+
+        //spheres per cluster. One AVX2 register worth
+        static constexpr size_t cluster_size = 8;
+
+        SphereBucket spheres_;
+        std::vector<std::unique_ptr<SphereCluster>> clusters_;
+    };
+
+}
+
+#endif //!RAYCHEL_PRIMITIVE_STORE_H
@@ -0,0 +1,164 @@
+/**
+*\file ReflectionProbes.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the ReflectionProbes class
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_REFLECTION_PROBES_H
+#define RAYCHEL_REFLECTION_PROBES_H
+
+#include <algorithm>
+#include <functional>
+
+#include "Raychel/Core/BoundingBox.h"
+#include "Raychel/Core/LinkTypes.h"
+#include "Raychel/Misc/Concurrency/CancellationToken.h"
+#include "Raychel/Misc/Concurrency/WorkStealingPool.h"
+
+namespace Raychel {
+
+    /**
+    *\brief Size of the reflection probes and the cost of their last update
+    *
+    */
+    struct ReflectionProbeStats
+    {
+        size_t probe_count{0};
+        size_t resolution{0};
+        size_t mip_count{0};
+
+        //probes that were baked by the last update and the rays they marched
+        size_t updated_probe_count{0};
+        size_t ray_count{0};
+
+        size_t memory_usage{0};
+    };
+
+    std::ostream& operator<<(std::ostream& os, const ReflectionProbeStats& stats);
+
+    /**
+    *\brief Cubemaps of the scene, rendered from fixed positions and prefiltered for rough reflections
+    *
+    * Mip level 0 of every probe holds the sharp reflection, every further level halves the resolution and is convolved with a
+    * wider specular lobe, up to roughness 1 in the last level. A lookup picks the smallest probe around the surface point,
+    * intersects the reflected ray with the probe bounds (parallax correction) and blends the two mip levels of the roughness.
+    *
+    * Probes are baked when they are marked dirty, so moving objects only costs the probes around them.
+    */
+    class ReflectionProbes {
+
+    public:
+
+        //light arriving at origin from direction. Called concurrently
+        using RadianceFunction = std::function<color(const vec3& origin, const normalized3& direction)>;
+
+        ReflectionProbes()=default;
+
+        /**
+        *\brief Allocate the cubemaps of all probes. All probes are dirty afterwards
+        *
+        *\param resolution Texels per cubemap edge of mip level 0
+        *\param mip_count Number of roughness levels. Clamped so the last level still has one texel per face
+        */
+        void setProbes(const std::vector<ReflectionProbePlacement>& placements, size_t resolution, size_t mip_count);
+
+        //mark the probes whose bounds are at most radius away from region for the next update()
+        void markDirty(const BoundingBox& region, float radius) noexcept;
+
+        bool hasDirtyProbes() const noexcept
+        {
+            return std::find(dirty_.cbegin(), dirty_.cend(), std::uint8_t{1}) != dirty_.cend();
+        }
+
+        //render and prefilter all dirty probes in parallel. cancelled is checked before every row of a face, the probes that were not
+        //completely baked once it returns true stay dirty
+        void update(const RadianceFunction& radiance, WorkStealingPool& workers, const CancelFunction& cancelled={});
+
+        void clear() noexcept;
+
+        //reset the update counters of stats(), so frames without an update report 0 baked probes
+        void clearUpdateStats() noexcept
+        {
+            stats_.updated_probe_count = 0;
+            stats_.ray_count = 0;
+        }
+
+        size_t probeCount() const noexcept
+        {
+            return placements_.size();
+        }
+
+        /**
+        *\brief Light reflected towards a surface point from direction, blurred by roughness
+        *
+        *\param p Surface point
+        *\param direction Reflected direction
+        *\param roughness in [0; 1]
+        *\param out_color Set if a baked probe contains p
+        *\return true if a baked probe contains p
+        */
+        bool lookup(const vec3& p, const normalized3& direction, float roughness, color& out_color) const noexcept;
+
+        //true if a baked probe contains p
+        bool covers(const vec3& p) const noexcept
+        {
+            return _findProbe(p) != placements_.size();
+        }
+
+        const ReflectionProbeStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+    private:
+
+        size_t _levelResolution(size_t level) const noexcept
+        {
+            return std::max<size_t>(resolution_ >> level, 1);
+        }
+
+        //smallest baked probe that contains p, probeCount() if there is none
+        size_t _findProbe(const vec3& p) const noexcept;
+
+        //bilinear lookup in one mip level of one probe
+        color _sampleLevel(size_t probe, size_t level, const vec3& direction) const noexcept;
+
+        std::vector<ReflectionProbePlacement> placements_;
+        std::vector<std::uint8_t> baked_;
+        std::vector<std::uint8_t> dirty_;
+
+        size_t resolution_{0};
+        size_t mip_count_{0};
+
+        //first texel of every mip level inside of a probe and the texels of one probe
+        std::vector<size_t> level_offsets_;
+        size_t probe_stride_{0};
+        std::vector<color> texels_;
+
+        ReflectionProbeStats stats_;
+    };
+
+}
+
+#endif //!RAYCHEL_REFLECTION_PROBES_H
@@ -0,0 +1,170 @@
+/**
+*\file SdfCache.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the baked sparse brick map distance cache
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_SDF_CACHE_H
+#define RAYCHEL_SDF_CACHE_H
+
+#include "Raychel/Core/BoundingBox.h"
+#include "Raychel/Core/LinkTypes.h"
+#include "Raychel/Engine/Rendering/Pipeline/ObjectBvh.h"
+#include "Raychel/Misc/Concurrency/CancellationToken.h"
+#include "Raychel/Misc/Concurrency/WorkStealingPool.h"
+
+namespace Raychel {
+
+    /**
+    *\brief Shape of a baked SdfCache
+    *
+    */
+    struct SdfCacheStats
+    {
+        SdfCacheFormat format{SdfCacheFormat::fp16};
+
+        //coarse cells per axis
+        std::array<size_t, 3> grid_size{0, 0, 0};
+        float cell_size{0.0F};
+
+        //cells close enough to a surface to want a brick
+        size_t candidate_bricks{0};
+        //bricks that fit into the memory budget
+        size_t brick_count{0};
+
+        size_t memory_usage{0};
+    };
+
+    std::ostream& operator<<(std::ostream& os, const SdfCacheStats& stats);
+
+    /**
+    *\brief Sampled copy of a static scene distance field.
+    *
+    * The bounds of the scene are covered by a coarse grid of exact distances. Coarse cells close to a surface additionally get a
+    * brick of brick_samples^3 finer samples, which are stored as half floats or as 8 bit values. If the memory budget does not allow
+    * a brick for every such cell, the cells closest to a surface are preferred.
+    *
+    * distance() never returns more than the actual scene distance, so it can be used for stepping. Close to surfaces it becomes too
+    * pessimistic and the exact scene distance should be used instead (see exactThreshold()).
+    */
+    class SdfCache {
+
+    public:
+
+        SdfCache()=default;
+
+        /**
+        *\brief Sample the distance field of bvh
+        *
+        *\param bvh Scene to sample. Must not contain unbounded objects
+        *\param max_distance Distances are clamped to this value, like in RaymarchRenderer::sdScene()
+        *\param format Storage format of the bricks
+        *\param memory_budget Upper limit for the memory used by the cache [bytes]
+        *\param workers Pool used for sampling
+        *\param cancelled Checked before every slice and brick. The cache stays empty once it returns true
+        *\return true if the cache could be baked
+        */
+        bool bake(const ObjectBvh& bvh, float max_distance, SdfCacheFormat format, size_t memory_budget, WorkStealingPool& workers, const CancelFunction& cancelled={});
+
+        void clear() noexcept;
+
+        bool isBaked() const noexcept
+        {
+            return baked_;
+        }
+
+        /**
+        *\brief Get a lower bound of the scene distance at p
+        *
+        */
+        float distance(const vec3& p) const noexcept;
+
+        /**
+        *\brief Below this value, distance() is too pessimistic for stepping and the exact distance should be used
+        *
+        */
+        float exactThreshold() const noexcept
+        {
+            return brick_spacing_ * 2.0F;
+        }
+
+        const SdfCacheStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+        //samples per brick axis. A brick spans exactly one coarse cell, including the samples on its faces
+        static constexpr size_t brick_samples = 8;
+
+    private:
+
+        static constexpr std::uint32_t no_brick = std::numeric_limits<std::uint32_t>::max();
+
+        size_t _vertexIndex(size_t x, size_t y, size_t z) const noexcept
+        {
+            return x + ((grid_size_[0] + 1) * (y + ((grid_size_[1] + 1) * z)));
+        }
+
+        size_t _cellIndex(size_t x, size_t y, size_t z) const noexcept
+        {
+            return x + (grid_size_[0] * (y + (grid_size_[1] * z)));
+        }
+
+        float _brickSample(size_t brick, size_t x, size_t y, size_t z) const noexcept;
+
+        void _storeBrickSample(size_t brick, size_t x, size_t y, size_t z, float value) noexcept;
+
+        bool baked_{false};
+
+        //bounds of all objects. Outside of it, the distance to it is a lower bound of the scene distance
+        BoundingBox object_bounds_;
+
+        //bounds of the coarse grid
+        BoundingBox bounds_;
+        std::array<size_t, 3> grid_size_{0, 0, 0};
+        float cell_size_{0.0F};
+        float max_distance_{0.0F};
+
+        //exact distances at the coarse grid vertices
+        std::vector<float> coarse_;
+        //brick per coarse cell or no_brick
+        std::vector<std::uint32_t> brick_index_;
+
+        SdfCacheFormat format_{SdfCacheFormat::fp16};
+        std::vector<std::uint16_t> fp16_bricks_;
+        std::vector<std::uint8_t> unorm8_bricks_;
+        //brick samples are clamped to [-brick_range_; brick_range_]
+        float brick_range_{0.0F};
+        float brick_spacing_{0.0F};
+
+        //maximum amount that interpolated values can be above the actual distance
+        float coarse_margin_{0.0F};
+        float brick_margin_{0.0F};
+
+        SdfCacheStats stats_;
+    };
+
+}
+
+#endif //!RAYCHEL_SDF_CACHE_H
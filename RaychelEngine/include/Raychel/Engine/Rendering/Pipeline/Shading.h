@@ -2,10 +2,156 @@
 #define RAYCHEL_SHADING_H
 
 #include <atomic>
+#include <chrono>
+#include <functional>
 
 #include "Raychel/Core/LinkTypes.h"
+#include "Raychel/Engine/Rendering/Framebuffer.h"
+#include "Raychel/Engine/Rendering/Pipeline/AmbientOcclusionField.h"
+#include "Raychel/Engine/Rendering/Pipeline/IrradianceVolume.h"
+#include "Raychel/Engine/Rendering/Pipeline/LightBvh.h"
+#include "Raychel/Engine/Rendering/Pipeline/ReflectionProbes.h"
+#include "Raychel/Engine/Rendering/Pipeline/ObjectBvh.h"
+#include "Raychel/Engine/Rendering/Pipeline/PrimitiveStore.h"
+#include "Raychel/Engine/Rendering/Pipeline/SdfCache.h"
+#include "Raychel/Engine/Rendering/Pipeline/Tiles.h"
+#include "Raychel/Engine/Rendering/Pipeline/Wavefront.h"
+#include "Raychel/Misc/Concurrency/CancellationToken.h"
+#include "Raychel/Misc/Concurrency/WorkStealingPool.h"
+#include "Raychel/Misc/Exceptions/ShadingError.h"
+
 namespace Raychel {
 
+    /**
+    *\brief Raymarching counters of one frame
+    *
+    */
+    struct MarchStats
+    {
+        MarchingStrategy strategy{MarchingStrategy::classic};
+
+        //every marched ray, including the ones started by materials
+        size_t ray_count{0};
+        //scene evaluations done while marching
+        size_t step_count{0};
+        //over-relaxed steps that had to be undone
+        size_t backtrack_count{0};
+        //steps that were taken with the distance from the SDF cache
+        size_t cached_step_count{0};
+
+        double averageSteps() const noexcept
+        {
+            return ray_count == 0 ? 0.0 : static_cast<double>(step_count) / static_cast<double>(ray_count);
+        }
+    };
+
+    std::ostream& operator<<(std::ostream& os, const MarchStats& stats);
+
+    /**
+    *\brief Adaptive anti-aliasing counters of one frame
+    *
+    */
+    struct AntiAliasingStats
+    {
+        size_t pixel_count{0};
+        //pixels that were detected as edges and got additional samples
+        size_t refined_pixel_count{0};
+        size_t subsample_count{0};
+
+        double refinedFraction() const noexcept
+        {
+            return pixel_count == 0 ? 0.0 : static_cast<double>(refined_pixel_count) / static_cast<double>(pixel_count);
+        }
+    };
+
+    std::ostream& operator<<(std::ostream& os, const AntiAliasingStats& stats);
+
+    /**
+    *\brief Temporal reprojection counters of one frame
+    *
+    */
+    struct TemporalStats
+    {
+        size_t pixel_count{0};
+        //pixels that reused a sample of an earlier frame instead of being raymarched
+        size_t reprojected_pixel_count{0};
+        //raymarched pixels that started at a depth taken from the last frame
+        size_t seeded_pixel_count{0};
+
+        double reprojectedFraction() const noexcept
+        {
+            return pixel_count == 0 ? 0.0 : static_cast<double>(reprojected_pixel_count) / static_cast<double>(pixel_count);
+        }
+    };
+
+    std::ostream& operator<<(std::ostream& os, const TemporalStats& stats);
+
+    /**
+    *\brief Direct lighting counters of one frame
+    *
+    */
+    struct LightingStats
+    {
+        //surface points that asked for direct lighting
+        size_t point_count{0};
+        //lamps that were skipped because they were too far away, too dim or behind the surface
+        size_t culled_light_count{0};
+        size_t shadow_ray_count{0};
+        size_t shadow_step_count{0};
+        //shadow rays that stopped early because the lamp was occluded
+        size_t occluded_ray_count{0};
+
+        double shadowRaysPerPoint() const noexcept
+        {
+            return point_count == 0 ? 0.0 : static_cast<double>(shadow_ray_count) / static_cast<double>(point_count);
+        }
+    };
+
+    std::ostream& operator<<(std::ostream& os, const LightingStats& stats);
+
+    /**
+    *\brief Limits for rendering one frame. The renderer stops starting new tiles once either of them is hit
+    *
+    */
+    struct FrameBudget
+    {
+        //nullptr if the frame cannot be cancelled. Must stay alive until the frame is done
+        const CancellationToken* cancellation{nullptr};
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+    };
+
+    enum class FrameStatus {
+        //every pixel of the frame is final
+        complete,
+        //the frame budget ran out. Only the completed tiles hold final pixels
+        cancelled,
+        //shading code reported a fatal error. See RaymarchRenderer::shadingErrors()
+        failed,
+    };
+
+    struct FrameResult
+    {
+        FrameStatus status{FrameStatus::complete};
+        //tiles whose pixels are final. See RaymarchRenderer::tileCompleted() for which ones
+        size_t completed_tile_count{0};
+    };
+
+    /**
+    *\brief Called after each coarse pass of a progressive render.
+    *
+    * pixel_step is the distance between the pixels that were rendered in the pass. All other pixels hold a copy of the closest
+    * rendered pixel to their top left. The preview is only valid during the call.
+    */
+    using PreviewCallback = std::function<void(const FramebufferView& preview, size_t pixel_step)>;
+
+    /**
+    *\brief Called as soon as the pixels of a tile are final, while the rest of the frame is still rendering.
+    *
+    * Only the pixels inside of tile are valid, all other pixels of framebuffer may still change. The worker threads call this
+    * concurrently, so it must be thread-safe. It must not throw.
+    */
+    using TileCallback = std::function<void(const Tile& tile, const FramebufferView& framebuffer)>;
+
     class RaymarchRenderer {
 
     public:
@@ -14,60 +160,614 @@ namespace Raychel {
 
         void setRenderSize(const vec2i& new_size);
 
+        void setRenderOptions(const RenderOptions& options);
+
         void setSceneData(  const not_null<std::vector<IRaymarchable_p>*> objects,
+                            const not_null<std::vector<SdLamp_p>*> lamps,
                             const not_null<CubeTexture<color>*> background_texture);
 
-        std::optional<Texture<RenderResult>> renderImage(const Camera& cam);
+        //the probes are baked again before the next frame
+        void setReflectionProbes(const not_null<const std::vector<ReflectionProbePlacement>*> placements);
+
+        std::optional<Framebuffer> renderImage(const Camera& cam);
+
+        /**
+        *\brief Render into memory owned by the caller. Does not allocate once the buffers for the current settings exist
+        *
+        *\param output Must have the size set with setRenderSize(). Its format overrides RenderOptions::framebuffer_format
+        *\return false if rendering failed
+        */
+        bool renderImage(const Camera& cam, const FramebufferSpan& output);
+
+        /**
+        *\brief Render into memory owned by the caller until the frame is done or budget runs out
+        *
+        * Cancellation is checked before every tile, so the frame stops within the time of one tile per worker. A cancelled frame
+        * leaves the pixels of the tiles that were not completed undefined and does not update the temporal history.
+        * Baking the SDF cache, probes and ambient occlusion is checked between its jobs as well. What was not baked when the frame
+        * was cancelled stays dirty and is baked by the next frame.
+        *
+        *\param output Must have the size set with setRenderSize()
+        *\param budget Limits of this frame
+        *\return FrameResult
+        */
+        FrameResult renderImage(const Camera& cam, const FramebufferSpan& output, const FrameBudget& budget);
+
+        //tiles of the output, in the order of tileCompleted()
+        const std::vector<Tile>& tiles() const noexcept
+        {
+            return tiles_;
+        }
+
+        //whether tiles()[tile_index] holds its final pixels in the last rendered frame. Always true after a complete frame
+        bool tileCompleted(size_t tile_index) const noexcept
+        {
+            RAYCHEL_ASSERT(tile_index < tile_completed_.size());
+            return tile_completed_[tile_index] != 0;
+        }
+
+        FramebufferFormat framebufferFormat() const noexcept
+        {
+            return framebuffer_format_;
+        }
+
+        //only used if RenderOptions::progressive is set
+        void setPreviewCallback(PreviewCallback callback);
+
+        //pass an empty callback to stop streaming tiles
+        void setTileCallback(TileCallback callback);
+
+        /**
+        *\brief Rebuild all data derived from the scene objects. Must be called after objects were moved or changed
+        *
+        */
+        void invalidateScene();
+
+        /**
+        *\brief Same as invalidateScene(), but only the probes and ambient occlusion samples close to changed_bounds are baked again
+        *
+        *\param changed_bounds Must contain the old and the new bounds of everything that changed
+        */
+        void invalidateScene(const BoundingBox& changed_bounds);
+
+        const BvhStats& bvhStats() const noexcept
+        {
+            return bvh_.stats();
+        }
+
+        //counters of the last rendered frame
+        const MarchStats& marchStats() const noexcept
+        {
+            return march_stats_;
+        }
+
+        //empty if anti-aliasing is disabled
+        const AntiAliasingStats& antiAliasingStats() const noexcept
+        {
+            return aa_stats_;
+        }
+
+        //empty if temporal reprojection is disabled
+        const TemporalStats& temporalStats() const noexcept
+        {
+            return temporal_stats_;
+        }
+
+        //empty if the SDF cache is not baked
+        const SdfCacheStats& sdfCacheStats() const noexcept
+        {
+            return sdf_cache_.stats();
+        }
+
+        //errors that shading code reported while rendering the last frame
+        const ShadingErrorLog& shadingErrors() const noexcept
+        {
+            return frame_errors_;
+        }
+
+        //errors that shading code reported while baking the probes and ambient occlusion for the last frame. They never fail a frame
+        const ShadingErrorLog& bakeErrors() const noexcept
+        {
+            return bake_errors_;
+        }
+
+        //empty if the scene has no lamps
+        const LightingStats& lightingStats() const noexcept
+        {
+            return lighting_stats_;
+        }
+
+        //empty if the irradiance volume is disabled
+        const IrradianceVolumeStats& irradianceVolumeStats() const noexcept
+        {
+            return irradiance_volume_.stats();
+        }
+
+        //empty unless RenderOptions::ambient_occlusion is AmbientOcclusionMode::baked
+        const AmbientOcclusionFieldStats& ambientOcclusionFieldStats() const noexcept
+        {
+            return ao_field_.stats();
+        }
+
+        //empty if the reflection probes are disabled
+        const ReflectionProbeStats& reflectionProbeStats() const noexcept
+        {
+            return reflection_probes_.stats();
+        }
+
+        /**
+        *\brief Light arriving at a surface point from the lamps of the scene, including their shadows
+        *
+        * Materials multiply this with their diffuse color. Scenes without lamps are unlit and return the ambient occlusion, so every
+        * surface shows its albedo, unless the irradiance volume lights them.
+        *
+        *\param data hit to light. Points that face away from a lamp get no light from it
+        */
+        color getDirectLighting(const ShadingData& data) const noexcept;
+
+        /**
+        *\brief Diffuse light arriving at a surface point from the rest of the scene, divided by pi. 0 unless the irradiance volume is enabled
+        *
+        * Includes the ambient occlusion of the point.
+        */
+        color getIndirectLighting(const ShadingData& data) const noexcept;
+
+        //fraction of the ambient light that reaches a surface point in [0; 1]. 1 if RenderOptions::ambient_occlusion is none
+        float getAmbientOcclusion(const ShadingData& data) const noexcept;
+
+        //true if getProbeReflection() can replace the reflection ray of a surface point with this roughness
+        bool hasReflectionProbe(const ShadingData& data, float roughness) const noexcept;
+
+        /**
+        *\brief Reflection of the scene around a surface point, prefiltered for roughness. Only valid if hasReflectionProbe() is true
+        *
+        *\param direction Reflected direction
+        */
+        color getProbeReflection(const ShadingData& data, const normalized3& direction, float roughness) const noexcept;
 
     private:
 
         void set_scene_callback_renderer();
 
-        void _refillRequestBuffer();
+        void _compileScene();
+
+        void _bakeSdfCache();
+
+        void _refillTileBuffer();
+
+        void _refillSampleBuffers();
+
+        //x and y are in pixels, fractional values address points inside of a pixel
+        RaymarchData _getRootRequest(float x, float y) const;
+
+        //primary rays of one row of pixels. The unnormalized direction of a ray grows linearly along the row
+        struct PixelRow
+        {
+            vec3 direction_origin, direction_step;
+
+            vec3 direction(float x) const noexcept
+            {
+                return normalize(direction_origin + (direction_step * x));
+            }
+        };
+
+        PixelRow _getPixelRow(size_t y) const noexcept;
 
-        RaymarchData _getRootRequest(size_t x, size_t y) const;
+        bool _renderToFramebuffer(const FramebufferSpan& output);
 
-        bool _renderToTexture(Texture<RenderResult>& output) const;
+        //pixels rendered by one pass: every step-th pixel in x and y, except the ones that the previous, twice as coarse pass rendered
+        struct PixelLattice
+        {
+            size_t step{1};
+            bool skip_coarser{false};
+
+            //first row or column at or after begin that is on the lattice
+            size_t first(size_t begin) const noexcept
+            {
+                return ((begin + step - 1) / step) * step;
+            }
+
+            //rows of the coarser lattice only need its odd columns
+            void rowColumns(size_t y, size_t x_begin, size_t& out_first, size_t& out_step) const noexcept
+            {
+                out_first = first(x_begin);
+                out_step = step;
+                if(skip_coarser && (y % (2 * step)) == 0) {
+                    if((out_first % (2 * step)) == 0) {
+                        out_first += step;
+                    }
+                    out_step = 2 * step;
+                }
+            }
+        };
+
+        void _renderPass(const PixelLattice& lattice, const FramebufferSpan& output);
+
+        void _renderTile(size_t tile_index, const PixelLattice& lattice, size_t worker_index, const FramebufferSpan& output) const noexcept;
+
+        //cone march rect starting at start_depth, then refine the quadrants from there or render rect if it is small enough
+        void _renderConeRefined(const Tile& rect, const PixelLattice& lattice, float start_depth, size_t worker_index, const FramebufferSpan& output) const noexcept;
+
+        void _renderRect(const Tile& rect, const PixelLattice& lattice, float start_depth, size_t worker_index, const FramebufferSpan& output) const noexcept;
+
+        //mark a tile as completed and hand it to the tile callback
+        void _finishTile(size_t tile_index, const FramebufferView& output) const noexcept
+        {
+            if(frame_failed_) {
+                return;
+            }
+
+            tile_completed_[tile_index] = 1;
+            completed_tile_count_++;
+            if(tile_callback_) {
+                tile_callback_(tiles_[tile_index], output);
+            }
+        }
+
+        //true once the budget of the current frame ran out. Checked before every tile and every bake job
+        bool _isCancelled() const noexcept;
+
+        //_isCancelled() for the bakes
+        CancelFunction _cancelFunction() const;
+
+        //move the shading errors of the calling thread into the log of a tile. Called after every piece of work on a tile
+        void _flushShadingErrors(size_t tile_index) const noexcept;
+
+        //collect the tile logs into frame_errors_
+        void _mergeShadingErrors() noexcept;
+
+        //copy every rendered pixel of a step x step block into the rest of the block
+        void _fillPreview(const Tile& tile, size_t step, const FramebufferSpan& output) const noexcept;
 
         void _setupCamData(const Camera& cam) noexcept;
 
+        //these functions are defined in AntiAliasing.cpp
+        #pragma region Anti-aliasing functions
+
+        //add subsamples to all edge pixels of output. Expects primary_samples_ to be filled
+        void _antiAlias(const FramebufferSpan& output);
+
+        void _findEdges(const Tile& tile, const FramebufferView& output) const noexcept;
+
+        //returns the number of refined pixels
+        size_t _refineEdges(const Tile& tile, const FramebufferSpan& output) const noexcept;
+
+        #pragma endregion
+
+        //these functions are defined in Wavefront.cpp
+        #pragma region Wavefront functions
+
+        //state of one worker of the wavefront renderer. Sized for a whole tile, so rendering does not allocate
+        struct WavefrontBuffers
+        {
+            //rays of the current stage and the secondary rays they emit
+            RayQueue rays, next_rays;
+
+            //march results, one per ray of rays
+            std::vector<float> depths;
+            std::vector<size_t> step_counts;
+            std::vector<ObjectDistance> hits;
+            std::vector<std::uint8_t> hit_mask;
+            std::vector<RaymarchHitInfo> hit_infos;
+
+            //rays that hit something, sorted by the object they hit, and their shading data in the same order
+            std::vector<std::uint32_t> hit_rays;
+            std::vector<ShadingData> batch_data;
+            std::vector<color> batch_colors;
+
+            //framebuffer index and accumulated color of every pixel of the rendered rect
+            std::vector<std::uint32_t> pixel_indices;
+            std::vector<color> pixel_colors;
+        };
+
+        void _refillWavefrontBuffers();
+
+        //render rect in stages: march all rays, shade the hits in batches per object and repeat with the secondary rays
+        void _renderRectWavefront(const Tile& rect, const PixelLattice& lattice, float start_depth, WavefrontBuffers& buffers, const FramebufferSpan& output) const noexcept;
+
+        //fills the march results of buffers. Primary rays all start at the camera and are marched in packets if packet marching is enabled
+        void _marchWavefront(WavefrontBuffers& buffers, bool primary) const noexcept;
+
+        //sort the hits of the current stage by object and shade them. Queues the secondary rays into buffers.next_rays
+        void _shadeWavefront(WavefrontBuffers& buffers, size_t hit_count, size_t recursion_depth, bool record_samples) const noexcept;
+
+        #pragma endregion
+
+        //these functions are defined in Lighting.cpp
+        #pragma region Lighting functions
+
+        //lamp of the scene with everything the lighting code needs precomputed
+        struct LightSource
+        {
+            vec3 position;
+            //lamp color times brightness
+            color intensity;
+            float radius{0.0F};
+            //farther away the lamp adds less than light_cutoff_ to any point
+            float range{0.0F};
+        };
+
+        void _compileLights();
+
+        //light that one lamp adds to the point of data, multiplied with weight. Counts the culled lamps and shadow rays
+        color _lightContribution(const LightSource& light, const ShadingData& data, const vec3& shadow_origin, float weight) const noexcept;
+
+        //fraction of a lamp of angular radius atan(penumbra) that is visible from origin. Estimated along a single march by
+        //tracking how close the ray passes by other surfaces. Stops once the visibility drops below min_visibility
+        float _softShadow(const vec3& origin, const normalized3& direction, float max_depth, float penumbra, float min_visibility) const noexcept;
+
+        //add the counters of the calling thread to the frame totals
+        void _flushLightingCounters() const noexcept;
+
+        //true if getProbeReflection() was called on the calling thread since the last call of this function
+        bool _takeReflectionProbeRead() const noexcept;
+
+        //lay out the probes again if the scene bounds changed and bake the dirty ones
+        void _updateIrradianceVolume();
+
+        //allocate the probes again if they changed and bake the dirty ones
+        void _updateReflectionProbes();
+
+        //occlusion from distance samples along n, up to ao_distance_ away from p
+        float _sdfAmbientOcclusion(const vec3& p, const vec3& n) const noexcept;
+
+        //value of an ambient occlusion field sample at p, which is not necessarily close to a surface
+        float _ambientOcclusionFieldSample(const vec3& p) const noexcept;
+
+        //place the samples again if the scene bounds changed and bake the dirty blocks
+        void _updateAmbientOcclusionField();
+
+        //collect the counters and shading errors that the workers gathered while baking
+        void _finishBake();
+
+        #pragma endregion
+
+        //these functions are defined in Reprojection.cpp
+        #pragma region Temporal reprojection functions
+
+        //scatter the samples of the last frame into the current one. Fills output with the ones that are still valid and marks
+        //them in history_source_ if temporal_ is set, and finds depth hints for the other pixels if depth_seeding_ is set
+        void _reproject(const FramebufferSpan& output);
+
+        void _validateReprojection(const Tile& tile, const FramebufferSpan& output) noexcept;
+
+        //returns the number of seeded pixels
+        size_t _seedDepths(const Tile& tile) noexcept;
+
+        //lower the depth hints of rect to what a cone march from start_depth can prove to be empty
+        void _clampDepthHints(const Tile& rect, float start_depth) noexcept;
+
+        //depth the primary ray of a pixel can start at
+        float _depthHint(size_t pixel_index) const noexcept
+        {
+            return depth_seeding_ ? depth_hints_[pixel_index] : 0.0F;
+        }
+
+        //store the samples of output for the next frame
+        void _updateHistory(const FramebufferView& output);
+
+        //direction is relative to the camera position. Returns false for points behind the camera
+        bool _projectToPixel(const vec3& direction, vec2& out_pixel) const noexcept;
+
+        bool _isReprojected(size_t pixel_index) const noexcept
+        {
+            return temporal_ && history_source_[pixel_index] != no_history;
+        }
+
+        //true if no pixel of rect has to be raymarched
+        bool _isReprojected(const Tile& rect) const noexcept;
+
+        #pragma endregion
+
         //these functions are defined in RaymarchMath.cpp
         #pragma region Raymarching functions
 
         vec3 _getRayDirectionFromUV(const vec2&) const noexcept;
 
-        RenderResult _raymarchFunction(const RaymarchData& req) const noexcept;
+        //what the primary ray of a pixel hit
+        struct PrimarySample
+        {
+            //nullptr if the ray hit the background
+            const IRaymarchable* object{nullptr};
+            float depth{0.0F};
+            //the hit emitted a secondary ray or read a reflection probe, so its color changes with the view
+            bool view_dependent{false};
+        };
+
+        //out_sample may be nullptr
+        RenderResult _raymarchFunction(const vec3& direction, float start_depth, PrimarySample* out_sample) const noexcept;
+
+        //normalized directions of the rays of row through xs
+        void _getRowDirections(const PixelRow& row, const PacketLanes<float>& xs, vec3Packet& out_directions) const noexcept;
+
+        //only the first count lanes of directions are used. out_samples may be nullptr
+        void _raymarchPacketFunction(const vec3Packet& directions, size_t count, const PacketLanes<float>& start_depths, RenderResult* out_results, PrimarySample* out_samples) const noexcept;
 
-        color getShadedColor(const vec3& origin, const vec3& direction, size_t recursion_depth) const;
+        //get a depth that every primary ray of rect can safely start marching from. Stops once it is past end_depth
+        float _coneMarch(const Tile& rect, float start_depth, float end_depth) const noexcept;
 
+        //result of a primary ray that hit the background
+        RenderResult _backgroundFunction(const vec3& direction) const noexcept;
 
+        color getShadedColor(const vec3& origin, const vec3& direction, size_t recursion_depth, float start_depth=0.0F) const;
 
-        RaymarchHitInfo getHitInfo(const vec3& origin, const vec3& direction, float depth, size_t num_ray_steps, size_t recusion_depth) const noexcept;
+        //out_sample receives the object that was actually hit and whether its color is view dependent, if it is not nullptr
+        color _shadeHit(const vec3& origin, const vec3& direction, float depth, const ObjectDistance& hit, size_t num_ray_steps, size_t recursion_depth, PrimarySample* out_sample=nullptr) const;
 
-        vec3 getNormal(const vec3& p) const noexcept;
 
-        IRaymarchable* getHitObject(const vec3& p) const noexcept;
+
+        //hit is the closest object at the hit point, as found by raymarch()
+        RaymarchHitInfo getHitInfo(const vec3& origin, const vec3& direction, float depth, const ObjectDistance& hit, size_t num_ray_steps, size_t recusion_depth) const noexcept;
+
+        //only evaluates the objects close to p
+        vec3 getNormal(const vec3& p, const ObjectDistance& hit) const noexcept;
 
 
 
         float sdScene(const vec3& p) const;
 
-        bool raymarch(const vec3& origin, const vec3& direction, float max_depth, float* out_depth, size_t* out_num_raymarch_steps) const noexcept;
+        ObjectDistance sdSceneClosest(const vec3& p) const;
 
-        #pragma endregion
+        //distance for stepping. Far from surfaces this comes from the SDF cache, if it is baked. object is nullptr in that case
+        ObjectDistance _marchDistance(const vec3& p) const;
 
-        vec2 _getScreenspaceUV(const vec2& uv) const noexcept;
+        bool raymarch(const vec3& origin, const vec3& direction, float start_depth, float max_depth, float* out_depth, size_t* out_num_raymarch_steps, ObjectDistance* out_hit) const noexcept;
 
+        //packet version of _marchDistance(). Only the active lanes have to be valid
+        void sdScenePacket(const vec3Packet& points, const PacketLanes<bool>& active, PacketLanes<float>& out_distances, PacketLanes<const IRaymarchable*>& out_objects) const;
+
+        //inout_mask selects the lanes to march and holds the lanes that hit something afterwards
+        void raymarchPacket(const vec3& origin, const vec3Packet& directions, const PacketLanes<float>& start_depths, float max_depth, PacketLanes<bool>& inout_mask, PacketLanes<float>& out_depths, PacketLanes<size_t>& out_num_raymarch_steps, PacketLanes<ObjectDistance>& out_hits) const noexcept;
+
+        //add the counters of the calling thread to the frame totals
+        void _flushMarchCounters() const noexcept;
+
+        #pragma endregion
 
         vec2i output_size_;
         float aspect_ratio=0.0;
 
         //Non-owning references to scene specific data
         const std::vector<IRaymarchable_p>* objects_=nullptr;
+        const std::vector<SdLamp_p>* lamps_=nullptr;
         const CubeTexture<color>* background_texture_=nullptr;
 
-        //Buffer of all UVs for which to raymarch
-        std::vector<RaymarchData> requests_;
+        //lamps_ with the values for shading precomputed. Rebuilt with the scene and when light_cutoff_ changes
+        std::vector<LightSource> lights_;
+        //hierarchy over lights_. Only used if light_samples_ is set
+        LightBvh light_bvh_;
+        float light_cutoff_{1e-3F};
+        size_t light_samples_{0};
+
+        IrradianceVolume irradiance_volume_;
+        bool use_irradiance_volume_{false};
+        //set if the probes have to be placed again before the next frame
+        bool irradiance_layout_dirty_{true};
+        //set while the probes are baked. Probe rays get no indirect light, so every bake sees the same single bounce
+        bool irradiance_updating_{false};
+        float irradiance_probe_spacing_{1.0F};
+        size_t irradiance_max_probes_{4096};
+        size_t irradiance_probe_rays_{128};
+        float irradiance_update_radius_{2.0F};
+
+        AmbientOcclusionField ao_field_;
+        AmbientOcclusionMode ambient_occlusion_{AmbientOcclusionMode::none};
+        float ao_distance_{0.5F};
+        size_t ao_field_resolution_{64};
+        //set if the samples have to be placed again before the next frame
+        bool ao_field_layout_dirty_{true};
+        //set while the field is baked, lookups use the distance field instead
+        bool ao_field_updating_{false};
+
+        ReflectionProbes reflection_probes_;
+        const std::vector<ReflectionProbePlacement>* reflection_probe_placements_{nullptr};
+        bool use_reflection_probes_{false};
+        //set if the cubemaps have to be allocated again before the next frame
+        bool reflection_layout_dirty_{true};
+        //set while the probes are baked. The probe rays march their reflections instead of reading the probes that are written
+        bool reflection_probes_updating_{false};
+        size_t reflection_probe_resolution_{32};
+        size_t reflection_probe_mip_count_{5};
+        float reflection_probe_min_roughness_{0.1F};
+        float reflection_probe_update_radius_{1.0F};
+
+        //flattened copy of objects_. Rebuilt by setSceneData()
+        PrimitiveStore primitives_;
+        //objects that could not be compiled into primitives_ plus the primitive clusters. Owned by the scene and primitives_
+        std::vector<not_null<const IRaymarchable*>> compiled_objects_;
+        //acceleration structure over compiled_objects_
+        ObjectBvh bvh_;
+
+        //baked copy of the scene distance field. Baked before the next frame if sdf_cache_dirty_ is set
+        SdfCache sdf_cache_;
+        bool use_sdf_cache_{false};
+        bool sdf_cache_dirty_{true};
+        SdfCacheFormat sdf_cache_format_{SdfCacheFormat::fp16};
+        size_t sdf_cache_budget_{0};
+
+        //Screen tiles in Morton order. Each tile is one unit of work for the worker pool
+        std::vector<Tile> tiles_;
+        //non-zero for the tiles that were completed in the current frame
+        mutable std::vector<std::uint8_t> tile_completed_;
+        mutable std::atomic_size_t completed_tile_count_{0};
+        size_t tile_size_{16};
+        bool packet_marching_{false};
+        bool wavefront_{false};
+        //one per worker of workers_. Empty unless wavefront_ is set
+        mutable std::vector<WavefrontBuffers> wavefront_buffers_;
+        bool cone_prepass_{false};
+        bool progressive_{false};
+        PreviewCallback preview_callback_;
+        TileCallback tile_callback_;
+        FramebufferFormat framebuffer_format_{FramebufferFormat::rgb32f};
+        MarchingStrategy marching_strategy_{MarchingStrategy::classic};
+
+        mutable WorkStealingPool workers_;
+
+        //cone pre-pass and depth seeding rects are not split below this size [px]
+        static constexpr size_t min_cone_size = 8;
+        static constexpr size_t max_cone_steps = 64;
+
+        //pixel step of the first progressive pass. Every following pass halves it
+        static constexpr size_t progressive_start_step = 8;
+
+        bool do_aa_{false};
+        float aa_depth_threshold_{0.0F};
+        float aa_luminance_threshold_{0.0F};
+        size_t aa_grid_size_{1};
+        static constexpr size_t max_aa_grid_size = 4;
+
+        bool _keepsHistory() const noexcept
+        {
+            return temporal_ || depth_seeding_;
+        }
+
+        bool _recordsPrimarySamples() const noexcept
+        {
+            return do_aa_ || _keepsHistory();
+        }
+
+        //per pixel results of the primary rays. Only filled if anti-aliasing or temporal reprojection is enabled
+        mutable std::vector<PrimarySample> primary_samples_;
+        //non-zero for pixels that get additional samples
+        mutable std::vector<std::uint8_t> edge_mask_;
+        AntiAliasingStats aa_stats_;
+
+        //shaded pixel of an earlier frame
+        struct HistorySample
+        {
+            //world space hit point, or the ray direction if the ray hit the background
+            vec3 position;
+            color output;
+            //nullptr if the ray hit the background
+            const IRaymarchable* object{nullptr};
+            //frames since the sample was raymarched
+            std::uint32_t age{0};
+            //see PrimarySample. These samples keep their place for depth tests, but are never reused
+            bool view_dependent{false};
+        };
+
+        static constexpr std::uint32_t no_history = std::numeric_limits<std::uint32_t>::max();
+
+        bool temporal_{false};
+        float temporal_depth_tolerance_{0.0F};
+        std::uint32_t temporal_max_age_{0};
+
+        //samples of the last frame, one per pixel. Only valid if history_valid_ is set
+        std::vector<HistorySample> history_;
+        std::vector<HistorySample> next_history_;
+        bool history_valid_{false};
+        //sample of history_ that was reused for each pixel of the current frame, or no_history
+        std::vector<std::uint32_t> history_source_;
+        //closest sample of history_ that landed on each pixel. Depth in the upper, index in the lower 32 bits.
+        //Atomic, so all tiles can scatter at once
+        std::vector<std::atomic<std::uint64_t>> reprojected_samples_;
+
+        bool depth_seeding_{false};
+        float temporal_seed_margin_{0.0F};
+        //start depth of the primary ray of each pixel. Only valid if depth_seeding_ is set
+        std::vector<float> depth_hints_;
+        TemporalStats temporal_stats_;
 
         //size of this struct should be less than a cache line.
         //buffer forward, right and up vectors here
@@ -86,10 +786,27 @@ namespace Raychel {
             float distance_bias{1e-4F};
             float normal_bias{1e-5F};
             float surface_bias{5e-4F};
+
+            //1 for MarchingStrategy::classic
+            float over_relaxation{1.0F};
         } raymarch_data_;
 
-        mutable std::atomic_bool failed_ {false};
-        mutable exception_context current_exception_{"", "", false};
+        //totals of the frame that is currently rendered
+        mutable std::atomic_size_t frame_ray_count_{0}, frame_step_count_{0}, frame_backtrack_count_{0}, frame_cached_step_count_{0};
+        MarchStats march_stats_;
+
+        mutable std::atomic_size_t frame_lit_point_count_{0}, frame_culled_light_count_{0}, frame_shadow_ray_count_{0}, frame_shadow_step_count_{0}, frame_occluded_ray_count_{0};
+        LightingStats lighting_stats_;
+
+        FrameBudget frame_budget_;
+        mutable std::atomic_bool cancelled_{false};
+
+        //shading errors of each tile. Only read after the frame, so the render threads never share a log
+        mutable std::vector<ShadingErrorLog> tile_errors_;
+        ShadingErrorLog frame_errors_;
+        ShadingErrorLog bake_errors_;
+        //set once a tile reported a fatal error. The remaining tiles of the frame are skipped
+        mutable std::atomic_bool frame_failed_{false};
     };
 
 }
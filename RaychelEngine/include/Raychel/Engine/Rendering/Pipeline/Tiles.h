@@ -0,0 +1,91 @@
+/**
+*\file Tiles.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for screen space render tiles
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_TILES_H
+#define RAYCHEL_TILES_H
+
+#include "Raychel/Core/Types.h"
+
+#include <array>
+
+namespace Raychel {
+
+    /**
+    *\brief Rectangular region of the output image. Tiles at the right and bottom border may be smaller than the tile size
+    *
+    */
+    struct Tile
+    {
+        vec2i origin;
+        vec2i size;
+    };
+
+    /**
+    *\brief Interleave the bits of x and y into a Morton (Z-order) code
+    *
+    *\param x horizontal coordinate. Only the lower 16 bits are used
+    *\param y vertical coordinate. Only the lower 16 bits are used
+    *\return constexpr std::uint32_t
+    */
+    constexpr std::uint32_t mortonEncode(std::uint32_t x, std::uint32_t y) noexcept
+    {
+        const auto spread = [](std::uint32_t v) {
+            v &= 0x0000FFFFU;
+            v = (v | (v << 8U)) & 0x00FF00FFU;
+            v = (v | (v << 4U)) & 0x0F0F0F0FU;
+            v = (v | (v << 2U)) & 0x33333333U;
+            v = (v | (v << 1U)) & 0x55555555U;
+            return v;
+        };
+        return spread(x) | (spread(y) << 1U);
+    }
+
+    /**
+    *\brief Split an image into tiles of tile_size x tile_size pixels, sorted in Morton order
+    *
+    * Neighbouring tiles in the returned list are also neighbours on screen, so contiguous ranges of tiles
+    * cover compact regions of the image.
+    *
+    *\param image_size Size of the image in pixels
+    *\param tile_size Edge length of a tile in pixels. Must not be 0
+    *\return std::vector<Tile>
+    */
+    std::vector<Tile> makeTiles(const vec2i& image_size, size_t tile_size);
+
+    /**
+    *\brief Split rect into its four quadrants. The first one gets the larger half in both directions
+    *
+    * Quadrants of rects that are only one pixel wide or high have a size of 0 and should be skipped.
+    *
+    *\param rect Rect to split
+    *\return std::array<Tile, 4>
+    */
+    std::array<Tile, 4> splitIntoQuadrants(const Tile& rect) noexcept;
+
+}
+
+#endif //!RAYCHEL_TILES_H
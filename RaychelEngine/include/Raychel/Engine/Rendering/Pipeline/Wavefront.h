@@ -0,0 +1,117 @@
+/**
+*\file Wavefront.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the ray queues of the wavefront renderer
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_WAVEFRONT_H
+#define RAYCHEL_WAVEFRONT_H
+
+#include <vector>
+
+#include "Raychel/Core/LinkTypes.h"
+
+namespace Raychel {
+
+    /**
+    *\brief Rays of one wavefront stage in structure-of-arrays layout
+    *
+    * Consecutive rays sit next to each other in every array, so the march stage loads ray_packet_width of them with plain
+    * contiguous reads. The capacity is fixed by setCapacity(), so pushing never allocates.
+    */
+    struct RayQueue
+    {
+        std::vector<float> origin_x, origin_y, origin_z;
+        std::vector<float> direction_x, direction_y, direction_z;
+        std::vector<float> start_depth;
+        //factor the color seen by the ray is multiplied with
+        std::vector<float> weight_r, weight_g, weight_b;
+        //pixel the ray adds its color to
+        std::vector<std::uint32_t> pixel_slot;
+        size_t size{0};
+
+        void setCapacity(size_t capacity)
+        {
+            for(auto* channel : {&origin_x, &origin_y, &origin_z, &direction_x, &direction_y, &direction_z, &start_depth, &weight_r, &weight_g, &weight_b}) {
+                channel->resize(capacity);
+                channel->shrink_to_fit();
+            }
+            pixel_slot.resize(capacity);
+            pixel_slot.shrink_to_fit();
+            size = 0;
+        }
+
+        size_t capacity() const noexcept
+        {
+            return pixel_slot.size();
+        }
+
+        void clear() noexcept
+        {
+            size = 0;
+        }
+
+        void push(const vec3& origin, const vec3& direction, float depth, const color& weight, std::uint32_t slot) noexcept
+        {
+            RAYCHEL_ASSERT(size < capacity());
+            origin_x[size] = origin.x;
+            origin_y[size] = origin.y;
+            origin_z[size] = origin.z;
+            direction_x[size] = direction.x;
+            direction_y[size] = direction.y;
+            direction_z[size] = direction.z;
+            start_depth[size] = depth;
+            weight_r[size] = weight.r;
+            weight_g[size] = weight.g;
+            weight_b[size] = weight.b;
+            pixel_slot[size] = slot;
+            size++;
+        }
+
+        vec3 origin(size_t i) const noexcept
+        {
+            return {origin_x[i], origin_y[i], origin_z[i]};
+        }
+
+        vec3 direction(size_t i) const noexcept
+        {
+            return {direction_x[i], direction_y[i], direction_z[i]};
+        }
+
+        void setDirection(size_t i, const vec3& direction) noexcept
+        {
+            direction_x[i] = direction.x;
+            direction_y[i] = direction.y;
+            direction_z[i] = direction.z;
+        }
+
+        color weight(size_t i) const noexcept
+        {
+            return {weight_r[i], weight_g[i], weight_b[i]};
+        }
+    };
+
+}
+
+#endif //!RAYCHEL_WAVEFRONT_H
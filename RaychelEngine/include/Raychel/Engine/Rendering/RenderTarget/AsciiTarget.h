@@ -39,16 +39,28 @@ namespace Raychel {
             AsciiTarget(const vec2i& size, bool use_color);
             AsciiTarget(const vec2i& size, bool use_color, const std::vector<char>& char_set);
 
-            void writeFramebuffer(const Texture<RenderResult>& framebuffer) override;
+            void writeFramebuffer(const FramebufferView& framebuffer) override;
 
             void finishFramebufferWrite() override;
 
+            //the ncurses screen is updated as soon as a tile is finished
+            bool streamsTiles() const noexcept override;
+
+            void writeTile(const Tile& tile, const FramebufferView& framebuffer) override;
+
+            void endFrame() override;
+
             ~AsciiTarget() override;
 
         private:
 
             void _init_ncurses() const;
 
+            size_t _characterIndex(const color& col) const noexcept;
+
+            //rect is in framebuffer coordinates
+            void _drawTile(const Tile& rect, const FramebufferView& framebuffer) const;
+
             const std::vector<char> character_set_ = {'.', ':', ';', '~', '=', '#', '0', 'B', '8', '%', '&'};
             bool use_color_=false;
     };
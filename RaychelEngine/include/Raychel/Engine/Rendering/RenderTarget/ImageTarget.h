@@ -68,7 +68,7 @@ namespace Raychel {
         *
         *\param framebuffer the framebuffer to be saved
         */
-        void writeFramebuffer(const Texture<RenderResult>& framebuffer) override;
+        void writeFramebuffer(const FramebufferView& framebuffer) override;
 
     private:
 
@@ -30,12 +30,13 @@
 
 #include "Raychel/Core/Types.h"
 #include "Raychel/Core/LinkTypes.h"
-#include "Raychel/Misc/Texture/Texture.h"
+#include "Raychel/Engine/Rendering/Framebuffer.h"
+#include "Raychel/Engine/Rendering/Pipeline/Tiles.h"
 
 namespace Raychel {
 
     /**
-    *\brief Abstract base for render targets. The rendered image will be written in here as a texture of colors
+    *\brief Abstract base for render targets. The rendered image will be written in here as a framebuffer of any FramebufferFormat
     *
     */
     class RenderTarget {
@@ -67,9 +68,9 @@ namespace Raychel {
         /**
         *\brief Write the provided framebuffer into the target
         *
-        *\param framebuffer Framebuffer to write
+        *\param framebuffer Framebuffer to write. Only valid during the call
         */
-        virtual void writeFramebuffer(const Texture<RenderResult>& framebuffer)=0;
+        virtual void writeFramebuffer(const FramebufferView& framebuffer)=0;
 
         /**
         *\brief Finish up writing the framebuffer. Called right after writeFramebuffer()
@@ -78,6 +79,43 @@ namespace Raychel {
         */
         virtual void finishFramebufferWrite(){}
 
+        /**
+        *\brief Whether the target wants the tiles of a frame as soon as they are rendered.
+        *
+        * If this returns true, RenderController::renderToTarget() calls beginFrame(), then writeTile() for every tile and
+        * endFrame() instead of writing whole framebuffers. Never called concurrently, but writeTile() may be called from any thread
+        *
+        *\note Implementation is optional
+        */
+        virtual bool streamsTiles() const noexcept
+        {
+            return false;
+        }
+
+        /**
+        *\brief Start a new frame. Called before any tile of the frame is written
+        *
+        *\note Implementation is optional
+        */
+        virtual void beginFrame(){}
+
+        /**
+        *\brief Write a finished tile of the current frame
+        *
+        *\param tile Region of the image that is finished
+        *\param framebuffer Framebuffer the frame is rendered into. Only the pixels inside of tile are valid, and only during the call
+        *
+        *\note Implementation is optional
+        */
+        virtual void writeTile(const Tile& /*tile*/, const FramebufferView& /*framebuffer*/){}
+
+        /**
+        *\brief Finish the current frame. Called once for every beginFrame(), even if rendering the frame failed, unless the target threw
+        *
+        *\note Implementation is optional
+        */
+        virtual void endFrame(){}
+
         virtual ~RenderTarget()=default;
     
     private:
@@ -85,7 +123,7 @@ namespace Raychel {
 
     };
 
-    inline void operator<<(RenderTarget& t, const Texture<RenderResult>& framebuffer) {
+    inline void operator<<(RenderTarget& t, const FramebufferView& framebuffer) {
         t.writeFramebuffer(framebuffer);
     }
 
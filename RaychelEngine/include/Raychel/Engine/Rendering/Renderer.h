@@ -3,12 +3,22 @@
 
 #include "Raychel/Core/Types.h"
 #include "Raychel/Core/LinkTypes.h"
+#include "Raychel/Engine/Rendering/FramebufferPool.h"
 #include "Raychel/Engine/Rendering/Pipeline/Shading.h"
 #include "Raychel/Misc/Texture/Texture.h"
 
 namespace Raychel
 {
 
+    class RenderTarget;
+
+    /**
+    *\brief Called before each frame of RenderController::renderToTarget() is rendered, for example to move the camera.
+    *
+    * Returning false ends the frame loop. Runs on the thread that called renderToTarget()
+    */
+    using FrameCallback = std::function<bool(size_t frame_index)>;
+
     class RenderController
     {
         public:
@@ -17,10 +27,137 @@ namespace Raychel
 
             vec2i setOutputSize(const vec2i& newSize);
 
+            void setRenderOptions(const RenderOptions& options);
+
             void setCurrentScene(const not_null<Scene*> newScene);
 
-            //may become private later
-            std::optional<Texture<RenderResult>> getImageRendered();
+            //call after objects of the current scene were changed in place. Objects, lamps and probes added through the Scene are picked up automatically
+            void invalidateScene();
+
+            //same as invalidateScene(), but only the probes and ambient occlusion samples close to changed_bounds are baked again. changed_bounds must contain the old and new bounds of the change
+            void invalidateScene(const BoundingBox& changed_bounds);
+
+            //receives the coarse passes if RenderOptions::progressive is set
+            void setPreviewCallback(PreviewCallback callback);
+
+            //receives every tile as soon as its pixels are final. renderToTarget() replaces it while streaming to a target
+            void setTileCallback(TileCallback callback);
+
+            const BvhStats& getBvhStats() const noexcept
+            {
+                return renderer_.bvhStats();
+            }
+
+            const SdfCacheStats& getSdfCacheStats() const noexcept
+            {
+                return renderer_.sdfCacheStats();
+            }
+
+            //fraction of pixels that anti-aliasing refined in the last rendered frame
+            const AntiAliasingStats& getAntiAliasingStats() const noexcept
+            {
+                return renderer_.antiAliasingStats();
+            }
+
+            //fraction of pixels that were reused from the previous frame
+            const TemporalStats& getTemporalStats() const noexcept
+            {
+                return renderer_.temporalStats();
+            }
+
+            //errors that materials and objects reported while rendering the last frame
+            const ShadingErrorLog& getShadingErrors() const noexcept
+            {
+                return renderer_.shadingErrors();
+            }
+
+            //errors that materials reported while the last frame baked probes or ambient occlusion
+            const ShadingErrorLog& getBakeErrors() const noexcept
+            {
+                return renderer_.bakeErrors();
+            }
+
+            //raymarching counters of the last rendered frame
+            const MarchStats& getMarchStats() const noexcept
+            {
+                return renderer_.marchStats();
+            }
+
+            //lamps and shadow rays of the last rendered frame
+            const LightingStats& getLightingStats() const noexcept
+            {
+                return renderer_.lightingStats();
+            }
+
+            //probes of the irradiance volume and how many of them the last frame baked
+            const IrradianceVolumeStats& getIrradianceVolumeStats() const noexcept
+            {
+                return renderer_.irradianceVolumeStats();
+            }
+
+            //samples of the baked ambient occlusion field and how many of them the last frame baked
+            const AmbientOcclusionFieldStats& getAmbientOcclusionFieldStats() const noexcept
+            {
+                return renderer_.ambientOcclusionFieldStats();
+            }
+
+            //cubemaps of the reflection probes and how many of them the last frame baked
+            const ReflectionProbeStats& getReflectionProbeStats() const noexcept
+            {
+                return renderer_.reflectionProbeStats();
+            }
+
+            //may become private later. The framebuffer comes from a pool, hand it back with recycleFramebuffer() once it is not needed anymore
+            std::optional<Framebuffer> getImageRendered();
+
+            //render into a framebuffer owned by the caller. output must have the size set with setOutputSize(). Returns false if rendering failed
+            bool renderInto(const FramebufferSpan& output);
+
+            /**
+            *\brief Render into a framebuffer owned by the caller, but stop early once budget runs out
+            *
+            * Interactive applications can cancel the token of budget when the camera moves, so the stale frame is dropped right away.
+            * After a cancelled frame, isTileCompleted() tells which tiles of output hold final pixels
+            */
+            FrameResult renderInto(const FramebufferSpan& output, const FrameBudget& budget);
+
+            //tiles of the output, in the order of isTileCompleted()
+            const std::vector<Tile>& getTiles() const noexcept
+            {
+                return renderer_.tiles();
+            }
+
+            //whether getTiles()[tile_index] holds its final pixels in the last rendered frame
+            bool isTileCompleted(size_t tile_index) const noexcept
+            {
+                return renderer_.tileCompleted(tile_index);
+            }
+
+            //make the memory of framebuffer available to later getImageRendered() calls. May be called from any thread
+            void recycleFramebuffer(Framebuffer&& framebuffer) noexcept;
+
+            /**
+            *\brief Render frames and write them to target until prepare_frame returns false or a frame fails.
+            *
+            * Frames are written on a separate thread, so frame N+1 renders while frame N is written. Up to queue_depth finished
+            * frames wait for the writer. Once that many are waiting, rendering blocks until the writer catches up. All frames that
+            * were rendered are written before this returns, unless writing one of them threw.
+            *
+            * Targets that stream tiles (see RenderTarget::streamsTiles()) get every tile as soon as it is finished instead, so there
+            * is no queue and no writer thread. Their frames are written while they render.
+            *
+            *\param target Target to write to. Only used by the writer thread while this runs
+            *\param prepare_frame Called before each frame
+            *\param queue_depth Number of finished frames that can wait for the writer
+            *\return Number of frames that were written
+            */
+            size_t renderToTarget(RenderTarget& target, const FrameCallback& prepare_frame, size_t queue_depth=2);
+
+            //number of framebuffers that getImageRendered() had to allocate, because none were recycled
+            size_t getFramebufferAllocationCount() const noexcept
+            {
+                return framebuffer_pool_.allocationCount();
+            }
 
             std::optional<Texture<color>> getImagePostprocessed() const;
 
@@ -28,11 +165,21 @@ namespace Raychel
 
         private:
 
+            //renderToTarget() for targets that stream tiles
+            size_t _streamToTarget(RenderTarget& target, const FrameCallback& prepare_frame);
+
+            //hand the scene to the renderer again if something was added to it since the last frame
+            void _syncScene();
+
             //non-owning reference to current scene
             Scene* current_scene_{nullptr};
+            //Scene::revision_ of current_scene_ that the renderer was set up with
+            size_t scene_revision_{0};
             vec2i output_size_;
 
             RaymarchRenderer renderer_;
+            FramebufferPool framebuffer_pool_;
+            TileCallback tile_callback_;
             //PostProcessor postprecessor_;
     };
 
@@ -0,0 +1,143 @@
+/**
+*\file BoundedQueue.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the bounded blocking queue
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_BOUNDED_QUEUE_H
+#define RAYCHEL_BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "Raychel/Core/utils.h"
+
+namespace Raychel {
+
+    /**
+    *\brief Fixed capacity FIFO queue for handing work from one thread to another.
+    *
+    * push() blocks while the queue is full, which throttles the producer to the speed of the consumer. After close(), push() fails
+    * and pop() returns the remaining items before it fails as well. All storage is allocated by the constructor.
+    *
+    *\tparam T Item type. Must be move constructible
+    */
+    template<typename T>
+    class BoundedQueue {
+
+    public:
+
+        explicit BoundedQueue(size_t capacity)
+            :items_(capacity)
+        {
+            RAYCHEL_ASSERT(capacity != 0);
+        }
+
+        BoundedQueue(const BoundedQueue&)=delete;
+        BoundedQueue& operator=(const BoundedQueue&)=delete;
+        BoundedQueue(BoundedQueue&&)=delete;
+        BoundedQueue& operator=(BoundedQueue&&)=delete;
+
+        size_t capacity() const noexcept
+        {
+            return items_.size();
+        }
+
+        /**
+        *\brief Append item to the queue. Blocks while the queue is full
+        *
+        *\return false if the queue was closed. item is left untouched in that case
+        */
+        bool push(T&& item)
+        {
+            std::unique_lock lock{mtx_};
+            not_full_cv_.wait(lock, [this]{ return closed_ || size_ < items_.size(); });
+
+            if(closed_) {
+                return false;
+            }
+
+            items_[(front_ + size_) % items_.size()].emplace(std::move(item));
+            size_++;
+
+            lock.unlock();
+            not_empty_cv_.notify_one();
+            return true;
+        }
+
+        /**
+        *\brief Take the oldest item out of the queue. Blocks while the queue is empty and open
+        *
+        *\return false if the queue is closed and empty
+        */
+        bool pop(T& out_item)
+        {
+            std::unique_lock lock{mtx_};
+            not_empty_cv_.wait(lock, [this]{ return closed_ || size_ != 0; });
+
+            if(size_ == 0) {
+                return false;
+            }
+
+            out_item = std::move(*items_[front_]);
+            items_[front_].reset();
+            front_ = (front_ + 1) % items_.size();
+            size_--;
+
+            lock.unlock();
+            not_full_cv_.notify_one();
+            return true;
+        }
+
+        /**
+        *\brief Wake up all waiting threads and reject all further pushes
+        *
+        */
+        void close()
+        {
+            {
+                std::lock_guard lock{mtx_};
+                closed_ = true;
+            }
+            not_full_cv_.notify_all();
+            not_empty_cv_.notify_all();
+        }
+
+    private:
+
+        std::mutex mtx_;
+        std::condition_variable not_full_cv_;
+        std::condition_variable not_empty_cv_;
+
+        std::vector<std::optional<T>> items_;
+        size_t front_{0};
+        size_t size_{0};
+        bool closed_{false};
+    };
+
+}
+
+#endif //!RAYCHEL_BOUNDED_QUEUE_H
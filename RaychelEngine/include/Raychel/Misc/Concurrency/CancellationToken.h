@@ -0,0 +1,78 @@
+/**
+*\file CancellationToken.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for cooperative cancellation of long running work
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_CANCELLATION_TOKEN_H
+#define RAYCHEL_CANCELLATION_TOKEN_H
+
+#include <atomic>
+#include <functional>
+
+namespace Raychel {
+
+    /**
+    *\brief Flag that asks long running work to stop early. Work checks it at points where stopping is safe
+    *
+    * cancel() and isCancelled() may be called from any thread.
+    */
+    class CancellationToken {
+
+    public:
+
+        CancellationToken()=default;
+
+        CancellationToken(const CancellationToken&)=delete;
+        CancellationToken& operator=(const CancellationToken&)=delete;
+        CancellationToken(CancellationToken&&)=delete;
+        CancellationToken& operator=(CancellationToken&&)=delete;
+
+        void cancel() noexcept
+        {
+            cancelled_.store(true, std::memory_order_relaxed);
+        }
+
+        //make the token usable for the next piece of work
+        void reset() noexcept
+        {
+            cancelled_.store(false, std::memory_order_relaxed);
+        }
+
+        bool isCancelled() const noexcept
+        {
+            return cancelled_.load(std::memory_order_relaxed);
+        }
+
+    private:
+
+        std::atomic_bool cancelled_{false};
+    };
+
+    //true once long running work should stop. Empty functions never cancel. Called concurrently
+    using CancelFunction = std::function<bool()>;
+
+}
+
+#endif //!RAYCHEL_CANCELLATION_TOKEN_H
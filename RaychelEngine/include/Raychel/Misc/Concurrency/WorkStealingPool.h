@@ -0,0 +1,147 @@
+/**
+*\file WorkStealingPool.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the work stealing thread pool
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_WORK_STEALING_POOL_H
+#define RAYCHEL_WORK_STEALING_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Raychel/Core/utils.h"
+
+namespace Raychel {
+
+    /**
+    *\brief Persistent pool of worker threads that processes index ranges with work stealing.
+    *
+    * Every call to parallelFor() splits [0; count) into one contiguous range per worker.
+    * Workers consume their own range from the front and steal half of another workers range from the back once they run dry.
+    * The calling thread participates as worker 0, so a pool of size 1 does not start any threads.
+    *
+    *\note parallelFor() must not be called concurrently or from inside a job
+    */
+    class WorkStealingPool {
+
+    public:
+
+        explicit WorkStealingPool(size_t num_workers=defaultWorkerCount());
+
+        WorkStealingPool(const WorkStealingPool&)=delete;
+        WorkStealingPool& operator=(const WorkStealingPool&)=delete;
+        WorkStealingPool(WorkStealingPool&&)=delete;
+        WorkStealingPool& operator=(WorkStealingPool&&)=delete;
+
+        /**
+        *\brief Get the number of workers (including the calling thread)
+        */
+        size_t size() const noexcept
+        {
+            return num_workers_;
+        }
+
+        /**
+        *\brief Call f(index, worker_index) for every index in [0; count). Returns once all indices have been processed
+        *
+        *\param count Number of work items
+        *\param f Job function. Must be callable as f(size_t, size_t) const. worker_index is in [0; size())
+        */
+        template<typename F>
+        void parallelFor(size_t count, const F& f)
+        {
+            const auto call = [](const void* ctx, size_t index, size_t worker_index) {
+                (*static_cast<const F*>(ctx))(index, worker_index);
+            };
+            _run(count, call, &f, true);
+        }
+
+        /**
+        *\brief Call f(worker_index) exactly once on every worker, including the calling thread. Returns once all calls are done
+        *
+        * Used to reach thread_local state of the workers, which parallelFor() cannot do because one worker may steal all indices.
+        *
+        *\param f Must be callable as f(size_t) const
+        */
+        template<typename F>
+        void forEachWorker(const F& f)
+        {
+            const auto call = [](const void* ctx, size_t /*index*/, size_t worker_index) {
+                (*static_cast<const F*>(ctx))(worker_index);
+            };
+            //every worker gets a range of one index and nobody steals
+            _run(num_workers_, call, &f, false);
+        }
+
+        static size_t defaultWorkerCount() noexcept
+        {
+            return std::max(1U, std::thread::hardware_concurrency());
+        }
+
+        ~WorkStealingPool();
+
+    private:
+
+        using job_func = void (*)(const void*, size_t, size_t);
+
+        //[begin; end) packed into one word so pops and steals are a single CAS
+        struct alignas(64) WorkRange
+        {
+            std::atomic<std::uint64_t> bounds{0};
+        };
+
+        void _run(size_t count, job_func job, const void* ctx, bool allow_stealing);
+
+        void _workerMain(size_t worker_index);
+
+        void _processJob(size_t worker_index) noexcept;
+
+        bool _popFront(size_t worker_index, size_t& out_index) noexcept;
+
+        bool _stealHalf(size_t thief_index, size_t& out_index) noexcept;
+
+        const size_t num_workers_;
+
+        std::unique_ptr<WorkRange[]> ranges_;
+        std::vector<std::thread> threads_;
+
+        std::mutex mtx_;
+        std::condition_variable job_cv_;
+        std::condition_variable done_cv_;
+
+        job_func job_{nullptr};
+        const void* job_ctx_{nullptr};
+        bool allow_stealing_{true};
+        size_t generation_{0};
+        size_t busy_workers_{0};
+        bool shutdown_{false};
+    };
+
+}
+
+#endif //!RAYCHEL_WORK_STEALING_POOL_H
@@ -0,0 +1,131 @@
+/**
+*\file ShadingError.h
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Header file for the error channel of shading code
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+#ifndef RAYCHEL_SHADING_ERROR_H
+#define RAYCHEL_SHADING_ERROR_H
+
+#include <array>
+#include <iosfwd>
+#include <string_view>
+
+#include "Raychel/Core/utils.h"
+
+namespace Raychel {
+
+    /**
+    *\brief Error that shading code ran into. Reported with reportShadingError() instead of being thrown
+    *
+    */
+    struct ShadingError
+    {
+        //both have to point to string literals, because the error outlives the code that reported it
+        std::string_view what;
+        std::string_view origin;
+        bool fatal{false};
+        //number of times this error was reported
+        size_t count{0};
+    };
+
+    /**
+    *\brief Fixed size list of shading errors. Reports of an error that is already in the list only increase its count
+    *
+    * Never allocates, so it can be filled from the render threads. Errors that do not fit anymore are still counted.
+    */
+    class ShadingErrorLog {
+
+    public:
+
+        static constexpr size_t max_distinct_errors = 8;
+
+        void add(const ShadingError& error) noexcept;
+
+        void merge(const ShadingErrorLog& other) noexcept;
+
+        void clear() noexcept
+        {
+            size_ = 0;
+            total_count_ = 0;
+            has_fatal_ = false;
+        }
+
+        bool empty() const noexcept
+        {
+            return total_count_ == 0;
+        }
+
+        //true if any of the reported errors was fatal
+        bool hasFatal() const noexcept
+        {
+            return has_fatal_;
+        }
+
+        //number of reports, including the ones of errors that did not fit into the list
+        size_t totalCount() const noexcept
+        {
+            return total_count_;
+        }
+
+        const ShadingError* begin() const noexcept
+        {
+            return errors_.data();
+        }
+
+        const ShadingError* end() const noexcept
+        {
+            return errors_.data() + size_;
+        }
+
+    private:
+
+        std::array<ShadingError, max_distinct_errors> errors_;
+        size_t size_{0};
+        size_t total_count_{0};
+        bool has_fatal_{false};
+    };
+
+    std::ostream& operator<<(std::ostream& os, const ShadingErrorLog& log);
+
+    /**
+    *\brief Report an error from shading code, for example from Material::getSurfaceColor(). Shading code must not throw
+    *
+    * The error is stored for the calling thread and collected by the renderer after each tile, so reporting is cheap and does not
+    * touch shared memory. The pixel keeps the color that the shading code returns. Fatal errors fail the frame.
+    *
+    *\param what Description of the error. Must be a string literal
+    *\param origin Function that reported the error. Must be a string literal
+    *\param fatal true if the frame cannot be used anymore
+    */
+    void reportShadingError(std::string_view what, std::string_view origin, bool fatal) noexcept;
+
+    //move the errors reported on the calling thread into out_log
+    void takeThreadShadingErrors(ShadingErrorLog& out_log) noexcept;
+
+}
+
+#define RAYCHEL_REPORT_SHADING_ERROR(msg, fatal) ::Raychel::reportShadingError(msg, RAYCHEL_FUNC_NAME, fatal);
+
+#endif //!RAYCHEL_SHADING_ERROR_H
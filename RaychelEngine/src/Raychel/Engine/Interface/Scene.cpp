@@ -8,6 +8,13 @@ namespace Raychel {
         return background_texture_;
     }
 
+    void Scene::addReflectionProbe(const vec3& position, const BoundingBox& bounds)
+    {
+        RAYCHEL_ASSERT(!isEmpty(bounds));
+        reflection_probes_.push_back({position, bounds});
+        revision_++;
+    }
+
     Camera& Scene::setCamera(const Camera& cam)
     {
         cam_ = cam;
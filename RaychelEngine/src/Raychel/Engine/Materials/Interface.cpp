@@ -1,7 +1,47 @@
 #include "Raychel/Engine/Materials/Interface.h"
+#include "Raychel/Engine/Rendering/Pipeline/Shading.h"
 
 namespace Raychel {
 
+    void IMaterial::getSurfaceColors(const ShadingData* data, size_t count, color* out_colors) const
+    {
+        for(size_t i = 0; i < count; i++) {
+            out_colors[i] = getSurfaceColor(data[i]);
+        }
+    }
+
+    bool IMaterial::getSecondaryRay(const ShadingData& /*unused*/, vec3& /*unused*/, color& /*unused*/) const
+    {
+        return false;
+    }
+
+    color Material::directLighting(const ShadingData& data) const noexcept
+    {
+        if(!parent_renderer_) {
+            return color{1};
+        }
+        return parent_renderer_->getDirectLighting(data);
+    }
+
+    color Material::indirectLighting(const ShadingData& data) const noexcept
+    {
+        if(!parent_renderer_) {
+            return color{0};
+        }
+        return parent_renderer_->getIndirectLighting(data);
+    }
+
+    bool Material::hasReflectionProbe(const ShadingData& data, float roughness) const noexcept
+    {
+        return parent_renderer_ && parent_renderer_->hasReflectionProbe(data, roughness);
+    }
+
+    color Material::probeReflection(const ShadingData& data, const normalized3& direction, float roughness) const noexcept
+    {
+        RAYCHEL_ASSERT(parent_renderer_);
+        return parent_renderer_->getProbeReflection(data, direction, roughness);
+    }
+
     void Material::setParentRenderer(not_null<RaymarchRenderer*> new_renderer)
     {
             parent_renderer_ = new_renderer;
@@ -9,7 +9,32 @@ namespace Raychel {
 
     color DiffuseMaterial::getSurfaceColor(const ShadingData& data) const
     {
-        return albedo_(data.surface_point, data.hit_normal);
+        return albedo_(data.surface_point, data.hit_normal) * (directLighting(data) + indirectLighting(data));
+    }
+
+    void ReflectiveMaterial::initializeTextureProviders(const vec3&, const vec3&)
+    {
+        RAYCHEL_LOG("Initializing texture providers");
+    }
+
+    color ReflectiveMaterial::getSurfaceColor(const ShadingData& data) const
+    {
+        const color diffuse = albedo_(data.surface_point, data.hit_normal) * (directLighting(data) + indirectLighting(data)) * (1.0F - reflectivity_);
+        if(reflectivity_ == 0.0F || !hasReflectionProbe(data, roughness_)) {
+            return diffuse;
+        }
+        return diffuse + (probeReflection(data, reflect(data.in_direction, data.hit_normal), roughness_) * reflectivity_);
+    }
+
+    bool ReflectiveMaterial::getSecondaryRay(const ShadingData& data, vec3& out_direction, color& out_weight) const
+    {
+        //the probe reflection was already added by getSurfaceColor()
+        if(reflectivity_ == 0.0F || hasReflectionProbe(data, roughness_)) {
+            return false;
+        }
+        out_direction = reflect(data.in_direction, data.hit_normal);
+        out_weight = color{reflectivity_};
+        return true;
     }
 
 }
\ No newline at end of file
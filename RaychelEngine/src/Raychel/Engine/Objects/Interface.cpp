@@ -3,6 +3,20 @@
 
 namespace Raychel {
 
+    void IRaymarchable::evalPacket(const vec3Packet& points, PacketLanes<float>& out_distances) const
+    {
+        for(size_t i = 0; i < ray_packet_width; i++) {
+            out_distances[i] = eval(points.lane(i));
+        }
+    }
+
+    void IRaymarchable::getSurfaceColors(const ShadingData* data, size_t count, color* out_colors) const
+    {
+        for(size_t i = 0; i < count; i++) {
+            out_colors[i] = getSurfaceColor(data[i]);
+        }
+    }
+
     vec3 SdObject::getDirectionToObject(const vec3& p) const
     {
         return transform().position-p;
@@ -13,6 +27,16 @@ namespace Raychel {
         return material()->getSurfaceColor(data);
     }
 
+    void SdObject::getSurfaceColors(const ShadingData* data, size_t count, color* out_colors) const
+    {
+        material()->getSurfaceColors(data, count, out_colors);
+    }
+
+    bool SdObject::getSecondaryRay(const ShadingData& data, vec3& out_direction, color& out_weight) const
+    {
+        return material()->getSecondaryRay(data, out_direction, out_weight);
+    }
+
     void SdObject::onRendererAttached(const not_null<RaymarchRenderer*> new_renderer){
         material()->setParentRenderer(new_renderer);
     }
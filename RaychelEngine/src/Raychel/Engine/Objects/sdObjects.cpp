@@ -1,7 +1,33 @@
 #include "Raychel/Raychel.h"
 #include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Pipeline/PrimitiveStore.h"
 
 float Raychel::SdSphere::eval(const vec3& _p) const
 {
     return dist(_p, transform().position) - radius;
+}
+
+void Raychel::SdSphere::evalPacket(const vec3Packet& points, PacketLanes<float>& out_distances) const
+{
+    const vec3 center = transform().position;
+
+    //straight-line loop over the lanes so the compiler can turn it into SIMD code
+    for(size_t i = 0; i < ray_packet_width; i++) {
+        const float dx = points.x[i] - center.x;
+        const float dy = points.y[i] - center.y;
+        const float dz = points.z[i] - center.z;
+        out_distances[i] = std::sqrt((dx*dx) + (dy*dy) + (dz*dz)) - radius;
+    }
+}
+
+std::optional<Raychel::BoundingBox> Raychel::SdSphere::getBounds() const
+{
+    const vec3 center = transform().position;
+    return BoundingBox{center - vec3{radius, radius, radius}, center + vec3{radius, radius, radius}};
+}
+
+bool Raychel::SdSphere::compileInto(PrimitiveStore& store) const
+{
+    store.addSphere(transform().position, radius, this);
+    return true;
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "Raychel/Engine/Rendering/Framebuffer.h"
+
+#include <new>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+namespace Raychel {
+
+    namespace {
+
+        //size of a transparent huge page on x86_64 and most aarch64 kernels
+        constexpr size_t huge_page_size = 2U << 20U;
+
+    }
+
+    FramebufferMemory::FramebufferMemory(size_t word_count, bool use_huge_pages)
+        :capacity_{word_count}
+    {
+        if(word_count == 0) {
+            return;
+        }
+
+        const size_t bytes = word_count * sizeof(std::uint32_t);
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if(use_huge_pages) {
+            //map one extra huge page, so the memory can be aligned to a huge page boundary
+            const size_t aligned_bytes = ((bytes + huge_page_size - 1) / huge_page_size) * huge_page_size;
+            const size_t mapped_bytes = aligned_bytes + huge_page_size;
+
+            void* const mapping = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(mapping != MAP_FAILED) {
+                const auto address = reinterpret_cast<std::uintptr_t>(mapping);
+                const std::uintptr_t aligned_address = (address + huge_page_size - 1) & ~(static_cast<std::uintptr_t>(huge_page_size) - 1);
+
+                const size_t head = aligned_address - address;
+                const size_t tail = mapped_bytes - head - aligned_bytes;
+                if(head != 0) {
+                    munmap(mapping, head);
+                }
+                if(tail != 0) {
+                    munmap(reinterpret_cast<void*>(aligned_address + aligned_bytes), tail);
+                }
+
+                //only a hint. Without available huge pages the kernel uses normal ones
+                madvise(reinterpret_cast<void*>(aligned_address), aligned_bytes, MADV_HUGEPAGE);
+
+                words_ = reinterpret_cast<std::uint32_t*>(aligned_address);
+                mapped_bytes_ = aligned_bytes;
+                return;
+            }
+
+            Logger::warn("Could not map ", aligned_bytes, " bytes for a huge page framebuffer, using the heap instead\n");
+        }
+#else
+        (void)use_huge_pages;
+#endif
+
+        words_ = static_cast<std::uint32_t*>(::operator new(bytes));
+    }
+
+    FramebufferMemory::FramebufferMemory(FramebufferMemory&& other) noexcept
+        :words_{std::exchange(other.words_, nullptr)}, capacity_{std::exchange(other.capacity_, 0)}, mapped_bytes_{std::exchange(other.mapped_bytes_, 0)}
+    {}
+
+    FramebufferMemory& FramebufferMemory::operator=(FramebufferMemory&& other) noexcept
+    {
+        if(this != &other) {
+            _free();
+            words_ = std::exchange(other.words_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0);
+            mapped_bytes_ = std::exchange(other.mapped_bytes_, 0);
+        }
+        return *this;
+    }
+
+    FramebufferMemory::~FramebufferMemory()
+    {
+        _free();
+    }
+
+    void FramebufferMemory::_free() noexcept
+    {
+        if(!words_) {
+            return;
+        }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if(mapped_bytes_ != 0) {
+            munmap(words_, mapped_bytes_);
+            words_ = nullptr;
+            return;
+        }
+#endif
+
+        ::operator delete(words_);
+        words_ = nullptr;
+    }
+
+}
@@ -0,0 +1,79 @@
+#include "Raychel/Engine/Rendering/FramebufferPool.h"
+
+namespace Raychel {
+
+    Framebuffer FramebufferPool::acquire(const vec2i& size, FramebufferFormat format)
+    {
+        const size_t word_count = framebufferWordCount(size, format);
+        bool use_huge_pages = false;
+
+        {
+            std::lock_guard lock{mtx_};
+
+            //the smallest buffer that fits, so the large ones stay available for large requests
+            size_t best = free_count_;
+            for(size_t i = 0; i < free_count_; i++) {
+                if(free_[i].capacity() >= word_count && (best == free_count_ || free_[i].capacity() < free_[best].capacity())) {
+                    best = i;
+                }
+            }
+
+            if(best != free_count_) {
+                FramebufferMemory memory = std::move(free_[best]);
+                free_[best] = std::move(free_[--free_count_]);
+                return Framebuffer{std::move(memory), size, format};
+            }
+
+            allocation_count_++;
+            use_huge_pages = use_huge_pages_;
+        }
+
+        return Framebuffer{FramebufferMemory{word_count, use_huge_pages}, size, format};
+    }
+
+    void FramebufferPool::release(Framebuffer&& framebuffer) noexcept
+    {
+        FramebufferMemory memory = framebuffer.releaseMemory();
+        if(memory.capacity() == 0) {
+            return;
+        }
+
+        std::lock_guard lock{mtx_};
+
+        if(free_count_ < max_free_buffers) {
+            free_[free_count_++] = std::move(memory);
+            return;
+        }
+
+        //keep the largest buffers
+        size_t smallest = 0;
+        for(size_t i = 1; i < free_count_; i++) {
+            if(free_[i].capacity() < free_[smallest].capacity()) {
+                smallest = i;
+            }
+        }
+        if(free_[smallest].capacity() < memory.capacity()) {
+            free_[smallest] = std::move(memory);
+        }
+    }
+
+    void FramebufferPool::setUseHugePages(bool use_huge_pages) noexcept
+    {
+        std::lock_guard lock{mtx_};
+
+        if(use_huge_pages != use_huge_pages_) {
+            use_huge_pages_ = use_huge_pages;
+            free_count_ = 0;
+            free_ = {};
+        }
+    }
+
+    void FramebufferPool::clear() noexcept
+    {
+        std::lock_guard lock{mtx_};
+
+        free_count_ = 0;
+        free_ = {};
+    }
+
+}
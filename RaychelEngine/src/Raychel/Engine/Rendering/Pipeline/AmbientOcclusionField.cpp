@@ -0,0 +1,168 @@
+#include <atomic>
+#include <cmath>
+
+#include "Raychel/Engine/Rendering/Pipeline/AmbientOcclusionField.h"
+
+namespace Raychel {
+
+    std::ostream& operator<<(std::ostream& os, const AmbientOcclusionFieldStats& stats)
+    {
+        return os << "{ grid: " << stats.grid_size[0] << "x" << stats.grid_size[1] << "x" << stats.grid_size[2] << ", spacing: " << stats.sample_spacing
+                  << ", updated blocks: " << stats.updated_block_count << "/" << stats.block_count << ", samples: " << stats.updated_sample_count
+                  << ", memory: " << (stats.memory_usage / 1024) << "KiB }";
+    }
+
+    void AmbientOcclusionField::setBounds(const BoundingBox& bounds, size_t resolution)
+    {
+        RAYCHEL_ASSERT(!isEmpty(bounds) && resolution >= 2);
+
+        clear();
+
+        const vec3 size = extent(bounds);
+        const std::array<float, 3> axis_sizes{size.x, size.y, size.z};
+        spacing_ = std::max(*std::max_element(axis_sizes.cbegin(), axis_sizes.cend()) / static_cast<float>(resolution - 1), 1e-4F);
+        for(size_t axis = 0; axis < 3; axis++) {
+            grid_size_[axis] = std::max<size_t>(static_cast<size_t>(std::ceil(axis_sizes[axis] / spacing_)) + 1, 2);
+            block_count_[axis] = (grid_size_[axis] + block_samples - 1) / block_samples;
+        }
+
+        bounds_.min = bounds.min;
+        bounds_.max = bounds.min + (vec3{static_cast<float>(grid_size_[0] - 1), static_cast<float>(grid_size_[1] - 1), static_cast<float>(grid_size_[2] - 1)} * spacing_);
+
+        samples_.assign(grid_size_[0] * grid_size_[1] * grid_size_[2], std::uint8_t{255});
+        dirty_.assign(block_count_[0] * block_count_[1] * block_count_[2], 1U);
+
+        stats_.grid_size = grid_size_;
+        stats_.sample_spacing = spacing_;
+        stats_.block_count = dirty_.size();
+        stats_.memory_usage = samples_.size() + dirty_.size();
+    }
+
+    void AmbientOcclusionField::markDirty(const BoundingBox& region) noexcept
+    {
+        if(isEmpty(bounds_) || isEmpty(region)) {
+            return;
+        }
+
+        //samples are shared by neighbouring blocks, so the range is grown by one sample
+        const vec3 low = (region.min - bounds_.min) / spacing_;
+        const vec3 high = (region.max - bounds_.min) / spacing_;
+        const std::array<float, 3> lows{low.x, low.y, low.z};
+        const std::array<float, 3> highs{high.x, high.y, high.z};
+        std::array<size_t, 3> first{};
+        std::array<size_t, 3> last{};
+        for(size_t axis = 0; axis < 3; axis++) {
+            const float max_sample = static_cast<float>(grid_size_[axis] - 1);
+            if(highs[axis] < -1.0F || lows[axis] > max_sample + 1.0F) {
+                return;
+            }
+            first[axis] = static_cast<size_t>(std::clamp(lows[axis] - 1.0F, 0.0F, max_sample)) / block_samples;
+            last[axis] = static_cast<size_t>(std::clamp(highs[axis] + 1.0F, 0.0F, max_sample)) / block_samples;
+        }
+
+        for(size_t z = first[2]; z <= last[2]; z++) {
+            for(size_t y = first[1]; y <= last[1]; y++) {
+                for(size_t x = first[0]; x <= last[0]; x++) {
+                    dirty_[_blockIndex(x, y, z)] = 1U;
+                }
+            }
+        }
+    }
+
+    void AmbientOcclusionField::update(const OcclusionFunction& occlusion, WorkStealingPool& workers, const CancelFunction& cancelled)
+    {
+        std::vector<size_t> dirty_blocks;
+        for(size_t i = 0; i < dirty_.size(); i++) {
+            if(dirty_[i] != 0) {
+                dirty_blocks.push_back(i);
+            }
+        }
+
+        //blocks do not overlap, so every job writes its own samples
+        std::atomic_size_t sample_count{0};
+        std::vector<std::uint8_t> finished(dirty_blocks.size(), 0U);
+        workers.parallelFor(dirty_blocks.size(), [&](size_t k, size_t /*worker_index*/) {
+            if(cancelled && cancelled()) {
+                return;
+            }
+            finished[k] = 1U;
+
+            const size_t block = dirty_blocks[k];
+            const std::array<size_t, 3> block_position{block % block_count_[0], (block / block_count_[0]) % block_count_[1], block / (block_count_[0] * block_count_[1])};
+            std::array<size_t, 3> begin{};
+            std::array<size_t, 3> end{};
+            for(size_t axis = 0; axis < 3; axis++) {
+                begin[axis] = block_position[axis] * block_samples;
+                end[axis] = std::min(begin[axis] + block_samples, grid_size_[axis]);
+            }
+
+            for(size_t z = begin[2]; z < end[2]; z++) {
+                for(size_t y = begin[1]; y < end[1]; y++) {
+                    for(size_t x = begin[0]; x < end[0]; x++) {
+                        const vec3 p = bounds_.min + (vec3{static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)} * spacing_);
+                        const float value = std::clamp(occlusion(p), 0.0F, 1.0F);
+                        samples_[_sampleIndex(x, y, z)] = static_cast<std::uint8_t>(std::lround(value * 255.0F));
+                    }
+                }
+            }
+            sample_count += (end[0] - begin[0]) * (end[1] - begin[1]) * (end[2] - begin[2]);
+        });
+
+        size_t updated_block_count = 0;
+        for(size_t k = 0; k < dirty_blocks.size(); k++) {
+            if(finished[k] != 0) {
+                dirty_[dirty_blocks[k]] = 0U;
+                updated_block_count++;
+            }
+        }
+        if(!hasDirtyBlocks()) {
+            baked_ = true;
+        }
+
+        stats_.updated_block_count = updated_block_count;
+        stats_.updated_sample_count = sample_count;
+
+        RAYCHEL_LOG("Updated ambient occlusion field: ", stats_);
+    }
+
+    void AmbientOcclusionField::clear() noexcept
+    {
+        baked_ = false;
+        bounds_ = {};
+        grid_size_ = {0, 0, 0};
+        block_count_ = {0, 0, 0};
+        spacing_ = 0.0F;
+        samples_.clear();
+        dirty_.clear();
+        stats_ = {};
+    }
+
+    bool AmbientOcclusionField::occlusion(const vec3& p, float& out_occlusion) const noexcept
+    {
+        if(!baked_ || !contains(bounds_, p)) {
+            return false;
+        }
+
+        const vec3 grid_position = (p - bounds_.min) / spacing_;
+        const std::array<float, 3> coordinates{grid_position.x, grid_position.y, grid_position.z};
+        std::array<size_t, 3> cell{};
+        std::array<float, 3> t{};
+        for(size_t axis = 0; axis < 3; axis++) {
+            cell[axis] = std::min(static_cast<size_t>(std::max(coordinates[axis], 0.0F)), grid_size_[axis] - 2);
+            t[axis] = std::clamp(coordinates[axis] - static_cast<float>(cell[axis]), 0.0F, 1.0F);
+        }
+
+        const auto sample = [&](size_t dx, size_t dy, size_t dz) {
+            return static_cast<float>(samples_[_sampleIndex(cell[0] + dx, cell[1] + dy, cell[2] + dz)]);
+        };
+        const auto lerp = [](float a, float b, float f) {
+            return a + ((b - a) * f);
+        };
+
+        const float y0 = lerp(lerp(sample(0, 0, 0), sample(1, 0, 0), t[0]), lerp(sample(0, 1, 0), sample(1, 1, 0), t[0]), t[1]);
+        const float y1 = lerp(lerp(sample(0, 0, 1), sample(1, 0, 1), t[0]), lerp(sample(0, 1, 1), sample(1, 1, 1), t[0]), t[1]);
+        out_occlusion = lerp(y0, y1, t[2]) / 255.0F;
+        return true;
+    }
+
+}
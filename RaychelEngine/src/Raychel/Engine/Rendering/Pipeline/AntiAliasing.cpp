@@ -0,0 +1,155 @@
+/**
+*\file AntiAliasing.cpp
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Definitions for the adaptive anti-aliasing functions found in Shading.h
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,#
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "Raychel/Core/Hash.h"
+#include "Raychel/Engine/Rendering/Pipeline/Shading.h"
+
+namespace Raychel {
+
+    namespace {
+
+        //jitter in [0; 1) that only depends on its arguments, so still images do not flicker
+        float jitter(size_t x, size_t y, size_t stratum, std::uint32_t axis) noexcept
+        {
+            const std::uint32_t key = hash(static_cast<std::uint32_t>(x) ^ hash(static_cast<std::uint32_t>(y) ^ hash(static_cast<std::uint32_t>(stratum * 2U) + axis)));
+            return unitFloat(key);
+        }
+
+    }
+
+    void RaymarchRenderer::_antiAlias(const FramebufferSpan& output_texture)
+    {
+        workers_.parallelFor(tiles_.size(), [&](size_t tile_index, size_t /*worker_index*/) {
+            _findEdges(tiles_[tile_index], output_texture);
+        });
+
+        std::atomic_size_t refined_pixel_count{0};
+        workers_.parallelFor(tiles_.size(), [&](size_t tile_index, size_t /*worker_index*/) {
+            if(frame_failed_ || _isCancelled()) {
+                return;
+            }
+
+            refined_pixel_count += _refineEdges(tiles_[tile_index], output_texture);
+            _flushShadingErrors(tile_index);
+            _finishTile(tile_index, output_texture);
+        });
+
+        aa_stats_.pixel_count = output_size_.x * output_size_.y;
+        aa_stats_.refined_pixel_count = refined_pixel_count;
+        aa_stats_.subsample_count = refined_pixel_count * ((aa_grid_size_ * aa_grid_size_) - 1);
+
+        RAYCHEL_LOG("Anti-aliased ", aa_stats_);
+    }
+
+    void RaymarchRenderer::_findEdges(const Tile& tile, const FramebufferView& output_texture) const noexcept
+    {
+        const auto differs = [&](const vec2i& a, const vec2i& b) {
+            const PrimarySample& sample_a = primary_samples_[(a.y * output_size_.x) + a.x];
+            const PrimarySample& sample_b = primary_samples_[(b.y * output_size_.x) + b.x];
+
+            if(sample_a.object != sample_b.object) {
+                return true;
+            }
+            if(sample_a.object && std::abs(sample_a.depth - sample_b.depth) > aa_depth_threshold_ * std::min(sample_a.depth, sample_b.depth)) {
+                return true;
+            }
+            return std::abs(luminance(output_texture.at(a)) - luminance(output_texture.at(b))) > aa_luminance_threshold_;
+        };
+
+        for(size_t y = tile.origin.y; y < tile.origin.y + tile.size.y; y++) {
+            for(size_t x = tile.origin.x; x < tile.origin.x + tile.size.x; x++) {
+                const vec2i p{x, y};
+
+                const bool is_edge = (x != 0 && differs(p, vec2i{x - 1, y})) ||
+                                     (y != 0 && differs(p, vec2i{x, y - 1})) ||
+                                     (x + 1 < output_size_.x && differs(p, vec2i{x + 1, y})) ||
+                                     (y + 1 < output_size_.y && differs(p, vec2i{x, y + 1}));
+
+                edge_mask_[(y * output_size_.x) + x] = is_edge ? 1U : 0U;
+            }
+        }
+    }
+
+    size_t RaymarchRenderer::_refineEdges(const Tile& tile, const FramebufferSpan& output_texture) const noexcept
+    {
+        //the primary sample sits on the corner of the first stratum, so that stratum needs no extra sample
+        std::array<vec3, (max_aa_grid_size * max_aa_grid_size) - 1> directions;
+        std::array<RenderResult, directions.size()> results;
+        const size_t subsample_count = (aa_grid_size_ * aa_grid_size_) - 1;
+        const float stratum_size = 1.0F / static_cast<float>(aa_grid_size_);
+        const PacketLanes<float> start_depths{};
+
+        size_t refined_count = 0;
+        for(size_t y = tile.origin.y; y < tile.origin.y + tile.size.y; y++) {
+            for(size_t x = tile.origin.x; x < tile.origin.x + tile.size.x; x++) {
+                if(edge_mask_[(y * output_size_.x) + x] == 0 || subsample_count == 0) {
+                    continue;
+                }
+
+                for(size_t i = 0; i < subsample_count; i++) {
+                    const size_t stratum = i + 1;
+                    const float offset_x = (static_cast<float>(stratum % aa_grid_size_) + jitter(x, y, stratum, 0U)) * stratum_size;
+                    const float offset_y = (static_cast<float>(stratum / aa_grid_size_) + jitter(x, y, stratum, 1U)) * stratum_size;
+                    directions[i] = _getRayDirectionFromUV(_getRootRequest(static_cast<float>(x) + offset_x, static_cast<float>(y) + offset_y).uv);
+                }
+
+                if(packet_marching_) {
+                    for(size_t i = 0; i < subsample_count; i += ray_packet_width) {
+                        const size_t count = std::min(ray_packet_width, subsample_count - i);
+
+                        vec3Packet packet_directions;
+                        for(size_t lane = 0; lane < count; lane++) {
+                            packet_directions.setLane(lane, directions[i + lane]);
+                        }
+                        _raymarchPacketFunction(packet_directions, count, start_depths, &results[i], nullptr);
+                    }
+                } else {
+                    for(size_t i = 0; i < subsample_count; i++) {
+                        results[i] = _raymarchFunction(directions[i], 0.0F, nullptr);
+                    }
+                }
+
+                color sum = output_texture.at(vec2i{x, y});
+                for(size_t i = 0; i < subsample_count; i++) {
+                    sum += results[i].output;
+                }
+                output_texture.store(vec2i{x, y}, sum / static_cast<float>(subsample_count + 1));
+
+                refined_count++;
+            }
+        }
+
+        _flushMarchCounters();
+
+        return refined_count;
+    }
+
+}
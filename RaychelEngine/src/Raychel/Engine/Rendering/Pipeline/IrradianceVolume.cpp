@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Raychel/Engine/Rendering/Pipeline/IrradianceVolume.h"
+
+namespace Raychel {
+
+    namespace {
+
+        using ShBasis = std::array<float, IrradianceVolume::sh_coefficient_count>;
+
+        //real spherical harmonics up to l = 2 for the normalized direction d
+        ShBasis shBasis(const vec3& d) noexcept
+        {
+            return {
+                0.282095F,
+                0.488603F * d.y,
+                0.488603F * d.z,
+                0.488603F * d.x,
+                1.092548F * d.x * d.y,
+                1.092548F * d.y * d.z,
+                0.315392F * ((3.0F * d.z * d.z) - 1.0F),
+                1.092548F * d.x * d.z,
+                0.546274F * ((d.x * d.x) - (d.y * d.y)),
+            };
+        }
+
+        //cosine lobe convolution per band divided by pi, so the coefficients give irradiance / pi
+        constexpr std::array<float, IrradianceVolume::sh_coefficient_count> band_factors{
+            1.0F,
+            2.0F / 3.0F, 2.0F / 3.0F, 2.0F / 3.0F,
+            0.25F, 0.25F, 0.25F, 0.25F, 0.25F,
+        };
+
+        //evenly spread directions on the unit sphere
+        std::vector<vec3> fibonacciSphere(size_t count)
+        {
+            constexpr float golden_angle = 2.3999632F;
+
+            std::vector<vec3> directions(count);
+            for(size_t i = 0; i < count; i++) {
+                const float z = 1.0F - ((2.0F * (static_cast<float>(i) + 0.5F)) / static_cast<float>(count));
+                const float r = std::sqrt(std::max(1.0F - (z * z), 0.0F));
+                const float phi = golden_angle * static_cast<float>(i);
+                directions[i] = vec3{r * std::cos(phi), r * std::sin(phi), z};
+            }
+            return directions;
+        }
+
+    }
+
+    std::ostream& operator<<(std::ostream& os, const IrradianceVolumeStats& stats)
+    {
+        return os << "{ grid: " << stats.grid_size[0] << "x" << stats.grid_size[1] << "x" << stats.grid_size[2] << ", spacing: " << stats.probe_spacing
+                  << ", probes: " << stats.valid_probe_count << "/" << stats.probe_count << ", updated: " << stats.updated_probe_count
+                  << ", rays: " << stats.ray_count << ", memory: " << (stats.memory_usage / 1024) << "KiB }";
+    }
+
+    void IrradianceVolume::setBounds(const BoundingBox& bounds, float spacing, size_t max_probe_count)
+    {
+        RAYCHEL_ASSERT(!isEmpty(bounds) && spacing > 0.0F && max_probe_count >= 8);
+
+        clear();
+
+        const vec3 size = extent(bounds);
+        spacing_ = spacing;
+        while(true) {
+            //at least two probes per axis, so every point inside of the bounds has probes on both sides
+            for(size_t axis = 0; axis < 3; axis++) {
+                const float axis_size = axis == 0 ? size.x : (axis == 1 ? size.y : size.z);
+                grid_size_[axis] = std::max<size_t>(static_cast<size_t>(std::ceil(axis_size / spacing_)) + 1, 2);
+            }
+            if(grid_size_[0] * grid_size_[1] * grid_size_[2] <= max_probe_count) {
+                break;
+            }
+            spacing_ *= 1.25F;
+        }
+
+        bounds_.min = bounds.min;
+        bounds_.max = _probePosition(grid_size_[0] - 1, grid_size_[1] - 1, grid_size_[2] - 1);
+
+        const size_t probe_count = grid_size_[0] * grid_size_[1] * grid_size_[2];
+        probes_.assign(probe_count, ShCoefficients{});
+        valid_.assign(probe_count, 0U);
+        dirty_.assign(probe_count, 1U);
+
+        stats_.grid_size = grid_size_;
+        stats_.probe_spacing = spacing_;
+        stats_.probe_count = probe_count;
+        stats_.memory_usage = probe_count * (sizeof(ShCoefficients) + 2);
+    }
+
+    void IrradianceVolume::markDirty(const BoundingBox& region, float radius) noexcept
+    {
+        for(size_t z = 0; z < grid_size_[2]; z++) {
+            for(size_t y = 0; y < grid_size_[1]; y++) {
+                for(size_t x = 0; x < grid_size_[0]; x++) {
+                    if(distance(region, _probePosition(x, y, z)) <= radius) {
+                        dirty_[_probeIndex(x, y, z)] = 1U;
+                    }
+                }
+            }
+        }
+    }
+
+    void IrradianceVolume::update(const DistanceFunction& distance, const RadianceFunction& radiance, size_t ray_count, WorkStealingPool& workers, const CancelFunction& cancelled)
+    {
+        RAYCHEL_ASSERT(ray_count != 0);
+
+        std::vector<size_t> dirty_probes;
+        for(size_t i = 0; i < dirty_.size(); i++) {
+            if(dirty_[i] != 0) {
+                dirty_probes.push_back(i);
+            }
+        }
+
+        const std::vector<vec3> directions = fibonacciSphere(ray_count);
+        std::vector<ShBasis> basis(ray_count);
+        std::transform(directions.cbegin(), directions.cend(), basis.begin(), shBasis);
+
+        //the probes are only written after all of them are baked, so lookups during the update see a consistent volume
+        std::vector<ShCoefficients> baked(dirty_probes.size());
+        std::vector<std::uint8_t> baked_valid(dirty_probes.size());
+        std::vector<std::uint8_t> finished(dirty_probes.size(), 0U);
+        workers.parallelFor(dirty_probes.size(), [&](size_t k, size_t /*worker_index*/) {
+            if(cancelled && cancelled()) {
+                return;
+            }
+            finished[k] = 1U;
+
+            const size_t index = dirty_probes[k];
+            const size_t x = index % grid_size_[0];
+            const size_t y = (index / grid_size_[0]) % grid_size_[1];
+            const size_t z = index / (grid_size_[0] * grid_size_[1]);
+            const vec3 position = _probePosition(x, y, z);
+
+            baked_valid[k] = distance(position) > 0.0F ? 1U : 0U;
+            if(baked_valid[k] == 0) {
+                return;
+            }
+
+            //Monte Carlo projection with equal weights of 4pi / ray_count
+            ShCoefficients coefficients{};
+            for(size_t i = 0; i < ray_count; i++) {
+                const color light = radiance(position, directions[i]);
+                for(size_t c = 0; c < sh_coefficient_count; c++) {
+                    coefficients[c] += light * basis[i][c];
+                }
+            }
+
+            const float weight = (4.0F * pi<float>) / static_cast<float>(ray_count);
+            for(size_t c = 0; c < sh_coefficient_count; c++) {
+                coefficients[c] *= weight * band_factors[c];
+            }
+            baked[k] = coefficients;
+        });
+
+        size_t updated_probe_count = 0;
+        size_t updated_valid_count = 0;
+        for(size_t k = 0; k < dirty_probes.size(); k++) {
+            if(finished[k] == 0) {
+                continue;
+            }
+            probes_[dirty_probes[k]] = baked[k];
+            valid_[dirty_probes[k]] = baked_valid[k];
+            dirty_[dirty_probes[k]] = 0U;
+            updated_probe_count++;
+            updated_valid_count += baked_valid[k];
+        }
+        if(!hasDirtyProbes()) {
+            baked_ = true;
+        }
+
+        stats_.valid_probe_count = static_cast<size_t>(std::count(valid_.cbegin(), valid_.cend(), std::uint8_t{1}));
+        stats_.updated_probe_count = updated_probe_count;
+        stats_.ray_count = updated_valid_count * ray_count;
+
+        RAYCHEL_LOG("Updated irradiance volume: ", stats_);
+    }
+
+    void IrradianceVolume::clear() noexcept
+    {
+        baked_ = false;
+        bounds_ = {};
+        grid_size_ = {0, 0, 0};
+        spacing_ = 0.0F;
+        probes_.clear();
+        valid_.clear();
+        dirty_.clear();
+        stats_ = {};
+    }
+
+    color IrradianceVolume::irradiance(const vec3& p, const normalized3& n) const noexcept
+    {
+        if(!baked_ || !contains(bounds_, p)) {
+            return color{0};
+        }
+
+        const vec3 grid_position = (p - bounds_.min) / spacing_;
+        std::array<size_t, 3> cell{};
+        std::array<float, 3> t{};
+        const std::array<float, 3> coordinates{grid_position.x, grid_position.y, grid_position.z};
+        for(size_t axis = 0; axis < 3; axis++) {
+            cell[axis] = std::min(static_cast<size_t>(std::max(coordinates[axis], 0.0F)), grid_size_[axis] - 2);
+            t[axis] = std::clamp(coordinates[axis] - static_cast<float>(cell[axis]), 0.0F, 1.0F);
+        }
+
+        //trilinear blend of the valid corner probes. Probes inside of objects would leak the dark inside
+        const ShBasis basis = shBasis(n);
+        color result{0};
+        float weight_sum = 0.0F;
+        for(size_t corner = 0; corner < 8; corner++) {
+            const size_t x = cell[0] + (corner & 1U);
+            const size_t y = cell[1] + ((corner >> 1U) & 1U);
+            const size_t z = cell[2] + ((corner >> 2U) & 1U);
+            const size_t index = _probeIndex(x, y, z);
+            if(valid_[index] == 0) {
+                continue;
+            }
+
+            const float weight = ((corner & 1U) ? t[0] : 1.0F - t[0]) * (((corner >> 1U) & 1U) ? t[1] : 1.0F - t[1]) * (((corner >> 2U) & 1U) ? t[2] : 1.0F - t[2]);
+            color probe{0};
+            for(size_t c = 0; c < sh_coefficient_count; c++) {
+                probe += probes_[index][c] * basis[c];
+            }
+            result += probe * weight;
+            weight_sum += weight;
+        }
+
+        if(weight_sum <= 0.0F) {
+            return color{0};
+        }
+
+        //second order SH can ring below zero opposite of bright light
+        return max(result / weight_sum, color{0});
+    }
+
+}
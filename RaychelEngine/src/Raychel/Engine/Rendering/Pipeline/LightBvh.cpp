@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <numeric>
+
+#include "Raychel/Engine/Rendering/Pipeline/LightBvh.h"
+
+namespace Raychel {
+
+    void LightBvh::build(const std::vector<LightBounds>& lights)
+    {
+        nodes_.clear();
+        lights_ = lights;
+        light_indices_.resize(lights_.size());
+        std::iota(light_indices_.begin(), light_indices_.end(), 0U);
+
+        if(lights_.empty()) {
+            return;
+        }
+
+        RAYCHEL_ASSERT(lights_.size() < std::numeric_limits<std::uint32_t>::max());
+
+        nodes_.reserve((2 * lights_.size()) - 1);
+        nodes_.emplace_back();
+        _buildNode(0, 0, lights_.size());
+
+        RAYCHEL_LOG("Built light BVH with ", nodes_.size(), " nodes over ", lights_.size(), " lamps");
+    }
+
+    void LightBvh::_buildNode(size_t node_index, size_t begin, size_t end)
+    {
+        BoundingBox bounds;
+        BoundingBox centroid_bounds;
+        float power = 0.0F;
+        float range = 0.0F;
+        for(size_t i = begin; i < end; i++) {
+            const LightBounds& light = lights_[i];
+            const vec3 half_size{light.radius, light.radius, light.radius};
+            bounds = merge(bounds, BoundingBox{light.position - half_size, light.position + half_size});
+            centroid_bounds = merge(centroid_bounds, light.position);
+            power += light.power;
+            range = std::max(range, light.range);
+        }
+        nodes_[node_index].bounds = bounds;
+        nodes_[node_index].power = power;
+        nodes_[node_index].range = range;
+
+        if((end - begin) == 1) {
+            nodes_[node_index].first = static_cast<std::uint32_t>(begin);
+            nodes_[node_index].is_leaf = true;
+            return;
+        }
+
+        //median split along the axis with the largest spread, like the object BVH
+        const vec3 spread = extent(centroid_bounds);
+        const auto axis_of = [](const vec3& v, int axis) {
+            return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+        };
+        const int axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 : (spread.y >= spread.z ? 1 : 2);
+
+        //lights_ and light_indices_ are sorted together through a permutation of the range
+        std::vector<std::uint32_t> order(end - begin);
+        std::iota(order.begin(), order.end(), static_cast<std::uint32_t>(begin));
+        const size_t mid = (end - begin) / 2;
+        std::nth_element(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(mid), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return axis_of(lights_[a].position, axis) < axis_of(lights_[b].position, axis);
+        });
+
+        std::vector<LightBounds> sorted_lights(order.size());
+        std::vector<std::uint32_t> sorted_indices(order.size());
+        for(size_t i = 0; i < order.size(); i++) {
+            sorted_lights[i] = lights_[order[i]];
+            sorted_indices[i] = light_indices_[order[i]];
+        }
+        std::copy(sorted_lights.begin(), sorted_lights.end(), lights_.begin() + static_cast<std::ptrdiff_t>(begin));
+        std::copy(sorted_indices.begin(), sorted_indices.end(), light_indices_.begin() + static_cast<std::ptrdiff_t>(begin));
+
+        const size_t first_child = nodes_.size();
+        nodes_.emplace_back();
+        nodes_.emplace_back();
+        nodes_[node_index].first = static_cast<std::uint32_t>(first_child);
+
+        _buildNode(first_child, begin, begin + mid);
+        _buildNode(first_child + 1, begin + mid, end);
+    }
+
+    bool LightBvh::_canReach(const Node& node, const vec3& p, const vec3& n) const noexcept
+    {
+        if(node.power <= 0.0F || distance(node.bounds, p) > node.range) {
+            return false;
+        }
+
+        if(node.is_leaf) {
+            return dot(n, lights_[node.first].position - p) > 0.0F;
+        }
+
+        //the lamps can only light p if one corner of the box is above its surface
+        const BoundingBox& b = node.bounds;
+        for(size_t corner = 0; corner < 8; corner++) {
+            const vec3 c{(corner & 1U) ? b.max.x : b.min.x, (corner & 2U) ? b.max.y : b.min.y, (corner & 4U) ? b.max.z : b.min.z};
+            if(dot(n, c - p) > 0.0F) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    float LightBvh::_importance(const Node& node, const vec3& p, const vec3& n) const noexcept
+    {
+        if(node.power <= 0.0F || distance(node.bounds, p) > node.range) {
+            return 0.0F;
+        }
+
+        if(node.is_leaf) {
+            //the unshadowed contribution the lighting code computes for the lamp, or 0 if it culls it
+            const LightBounds& light = lights_[node.first];
+            const vec3 to_light = light.position - p;
+            const float distance_squared = magSq(to_light);
+            const float cos_theta = dot(n, to_light);
+            if(cos_theta <= 0.0F) {
+                return 0.0F;
+            }
+            return light.power * (cos_theta / std::sqrt(distance_squared)) / std::max(distance_squared, light.radius * light.radius);
+        }
+
+        //the box of the node has corners that none of its children have, so testing it would let sampling walk into subtrees
+        //where both children are 0. Testing the children keeps every node with an importance above 0 one step from a dead end
+        if(!_canReach(nodes_[node.first], p, n) && !_canReach(nodes_[node.first + 1], p, n)) {
+            return 0.0F;
+        }
+
+        const BoundingBox& b = node.bounds;
+        //close to the box the distance to its center says nothing, so it is clamped to half of the box diagonal
+        const float distance_squared = std::max(magSq(center(b) - p), magSq(extent(b)) * 0.25F);
+        return node.power / distance_squared;
+    }
+
+    LightSample LightBvh::sample(const vec3& p, const vec3& n, float u) const noexcept
+    {
+        if(nodes_.empty() || _importance(nodes_.front(), p, n) <= 0.0F) {
+            return {};
+        }
+
+        float pdf = 1.0F;
+        size_t node_index = 0;
+        while(!nodes_[node_index].is_leaf) {
+            const size_t first = nodes_[node_index].first;
+            const float left = _importance(nodes_[first], p, n);
+            const float right = _importance(nodes_[first + 1], p, n);
+            if((left + right) <= 0.0F) {
+                //only possible further down than the children test of _importance() reaches
+                return {};
+            }
+
+            //pick a child and rescale u to [0; 1) within the picked part, so it can be used again further down
+            const float p_left = left / (left + right);
+            if(u < p_left) {
+                u /= p_left;
+                pdf *= p_left;
+                node_index = first;
+            } else {
+                u = (u - p_left) / (1.0F - p_left);
+                pdf *= 1.0F - p_left;
+                node_index = first + 1;
+            }
+            u = std::min(u, 0x1.fffffep-1F);
+        }
+
+        return {light_indices_[nodes_[node_index].first], pdf};
+    }
+
+}
@@ -0,0 +1,400 @@
+/**
+*\file Lighting.cpp
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Definitions for the lighting and ambient occlusion functions found in Shading.h
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,#
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "Raychel/Core/Hash.h"
+#include "Raychel/Engine/Rendering/Pipeline/Shading.h"
+#include "Raychel/Engine/Objects/Interface.h"
+
+namespace Raychel {
+
+    namespace {
+
+        struct LightingCounters
+        {
+            size_t points{0}, culled_lights{0}, shadow_rays{0}, shadow_steps{0}, occluded_rays{0};
+        };
+
+        //counters of the calling thread. Flushed together with the march counters
+        thread_local LightingCounters thread_lighting_counters;
+
+        //set by getProbeReflection(). Primary rays use it to tell whether their color depends on the view
+        thread_local bool thread_read_reflection_probe = false;
+
+        float maxComponent(const color& c) noexcept
+        {
+            return std::max({c.r, c.g, c.b});
+        }
+
+    }
+
+    void RaymarchRenderer::_flushLightingCounters() const noexcept
+    {
+        frame_lit_point_count_ += thread_lighting_counters.points;
+        frame_culled_light_count_ += thread_lighting_counters.culled_lights;
+        frame_shadow_ray_count_ += thread_lighting_counters.shadow_rays;
+        frame_shadow_step_count_ += thread_lighting_counters.shadow_steps;
+        frame_occluded_ray_count_ += thread_lighting_counters.occluded_rays;
+        thread_lighting_counters = {};
+    }
+
+    void RaymarchRenderer::_compileLights()
+    {
+        lights_.clear();
+        if(!lamps_) {
+            return;
+        }
+
+        for(const auto lamp : *lamps_) {
+            const color intensity = lamp->lampColor() * lamp->brightness();
+            if(maxComponent(intensity) <= 0.0F) {
+                continue;
+            }
+
+            //intensity falls off with the squared distance, so past range the lamp adds less than light_cutoff_
+            const float range = std::sqrt(maxComponent(intensity) / light_cutoff_);
+            lights_.push_back(LightSource{lamp->position(), intensity, std::max(lamp->size(), 0.0F), range});
+        }
+
+        std::vector<LightBounds> bounds;
+        if(light_samples_ != 0) {
+            bounds.reserve(lights_.size());
+            for(const auto& light : lights_) {
+                bounds.push_back(LightBounds{light.position, light.radius, maxComponent(light.intensity), light.range});
+            }
+        }
+        light_bvh_.build(bounds);
+
+        RAYCHEL_LOG("Compiled ", lights_.size(), " of ", lamps_->size(), " lamps");
+    }
+
+    color RaymarchRenderer::getDirectLighting(const ShadingData& data) const noexcept
+    {
+        if(lights_.empty()) {
+            return use_irradiance_volume_ ? color{0} : color{getAmbientOcclusion(data)};
+        }
+
+        thread_lighting_counters.points++;
+
+        //start shadow rays above the surface, so they do not hit it right away
+        const vec3 shadow_origin = data.surface_point + (data.hit_normal * raymarch_data_.surface_bias);
+
+        color result{0};
+        if(light_samples_ == 0 || lights_.size() <= light_samples_) {
+            for(const auto& light : lights_) {
+                result += _lightContribution(light, data, shadow_origin, 1.0F);
+            }
+            return result;
+        }
+
+        //stratified picks from the light hierarchy. The random numbers only depend on the point, so still images do not flicker
+        const vec3& p = data.surface_point;
+        const std::uint32_t seed = hash(hashFloat(p.x) ^ hash(hashFloat(p.y) ^ hashFloat(p.z)));
+        const float sample_weight = 1.0F / static_cast<float>(light_samples_);
+        for(size_t i = 0; i < light_samples_; i++) {
+            const float u = (static_cast<float>(i) + unitFloat(hash(seed + static_cast<std::uint32_t>(i)))) * sample_weight;
+            const LightSample sample = light_bvh_.sample(p, data.hit_normal, std::min(u, 0x1.fffffep-1F));
+            if(sample.pdf <= 0.0F) {
+                //the walk ended in a subtree that cannot light the point. Other strata may still find a lamp, so skipping
+                //this one keeps the estimate unbiased
+                continue;
+            }
+            result += _lightContribution(lights_[sample.light], data, shadow_origin, sample_weight / sample.pdf);
+        }
+        return result;
+    }
+
+    color RaymarchRenderer::_lightContribution(const LightSource& light, const ShadingData& data, const vec3& shadow_origin, float weight) const noexcept
+    {
+        const vec3 to_light = light.position - data.surface_point;
+        const float distance_squared = magSq(to_light);
+        if(distance_squared > (light.range * light.range)) {
+            thread_lighting_counters.culled_lights++;
+            return color{0};
+        }
+
+        const float distance = std::sqrt(distance_squared);
+        const vec3 direction = to_light / distance;
+        const float cos_theta = dot(data.hit_normal, direction);
+        if(cos_theta <= 0.0F) {
+            thread_lighting_counters.culled_lights++;
+            return color{0};
+        }
+
+        //points inside of a lamp are lit as if they were on its surface
+        const color unshadowed = light.intensity * (weight * cos_theta / std::max(distance_squared, light.radius * light.radius));
+        const float strength = maxComponent(unshadowed);
+        if(strength < light_cutoff_) {
+            thread_lighting_counters.culled_lights++;
+            return color{0};
+        }
+
+        const float max_depth = distance - light.radius;
+        if(max_depth <= 0.0F) {
+            return unshadowed;
+        }
+
+        return unshadowed * _softShadow(shadow_origin, direction, max_depth, light.radius / distance, light_cutoff_ / strength);
+    }
+
+    color RaymarchRenderer::getIndirectLighting(const ShadingData& data) const noexcept
+    {
+        if(!use_irradiance_volume_ || irradiance_updating_) {
+            return color{0};
+        }
+
+        //look up slightly above the surface, so the probes behind it count less
+        const float offset = irradiance_volume_.stats().probe_spacing * 0.25F;
+        return irradiance_volume_.irradiance(data.surface_point + (data.hit_normal * offset), data.hit_normal) * getAmbientOcclusion(data);
+    }
+
+    float RaymarchRenderer::getAmbientOcclusion(const ShadingData& data) const noexcept
+    {
+        switch(ambient_occlusion_) {
+            case AmbientOcclusionMode::none:
+                return 1.0F;
+            case AmbientOcclusionMode::baked:
+                if(float occlusion = 1.0F; !ao_field_updating_ && ao_field_.occlusion(data.surface_point, occlusion)) {
+                    return occlusion;
+                }
+                //unbounded objects are outside of the field
+                return _sdfAmbientOcclusion(data.surface_point, data.hit_normal);
+            case AmbientOcclusionMode::sdf:
+                return _sdfAmbientOcclusion(data.surface_point, data.hit_normal);
+        }
+        RAYCHEL_ASSERT_NOT_REACHED;
+    }
+
+    float RaymarchRenderer::_sdfAmbientOcclusion(const vec3& p, const vec3& n) const noexcept
+    {
+        //every sample is occluded by how much closer the scene is than the sample is to p. Closer samples count more
+        constexpr size_t sample_count = 5;
+        float occlusion = 0.0F;
+        float max_occlusion = 0.0F;
+        float weight = 1.0F;
+        for(size_t i = 1; i <= sample_count; i++) {
+            const float h = ao_distance_ * static_cast<float>(i) / static_cast<float>(sample_count);
+            occlusion += std::max(h - sdScene(p + (n * h)), 0.0F) * weight;
+            max_occlusion += h * weight;
+            weight *= 0.5F;
+        }
+        return std::clamp(1.0F - (occlusion / max_occlusion), 0.0F, 1.0F);
+    }
+
+    float RaymarchRenderer::_ambientOcclusionFieldSample(const vec3& p) const noexcept
+    {
+        //the distance gradient points away from the closest surface, which is the normal surface points close to p will have
+        const float e = ao_field_.stats().sample_spacing * 0.5F;
+        const vec3 gradient{sdScene(p + vec3{e, 0, 0}) - sdScene(p - vec3{e, 0, 0}),
+                            sdScene(p + vec3{0, e, 0}) - sdScene(p - vec3{0, e, 0}),
+                            sdScene(p + vec3{0, 0, e}) - sdScene(p - vec3{0, 0, e})};
+        if(magSq(gradient) < 1e-12F) {
+            return _sdfAmbientOcclusion(p, vec3{0, 1, 0});
+        }
+        const vec3 n = normalize(gradient);
+
+        //samples inside of objects take the occlusion of the closest surface point, so lookups next to the surface are not darkened
+        const float d = sdScene(p);
+        const vec3 origin = d < 0.0F ? p - (n * (d - raymarch_data_.surface_bias)) : p;
+        return _sdfAmbientOcclusion(origin, n);
+    }
+
+    void RaymarchRenderer::_updateAmbientOcclusionField()
+    {
+        if(ao_field_layout_dirty_) {
+            ao_field_layout_dirty_ = false;
+            ao_field_.clear();
+
+            const BoundingBox object_bounds = bvh_.bounds();
+            if(isEmpty(object_bounds)) {
+                RAYCHEL_LOG("Not baking ambient occlusion because the scene has no bounded objects");
+                return;
+            }
+
+            //objects occlude points up to ao_distance_ away from them
+            const vec3 padding{ao_distance_, ao_distance_, ao_distance_};
+            ao_field_.setBounds(BoundingBox{object_bounds.min - padding, object_bounds.max + padding}, ao_field_resolution_);
+        }
+
+        if(!ao_field_.hasDirtyBlocks()) {
+            return;
+        }
+
+        ao_field_updating_ = true;
+        ao_field_.update(
+            [this](const vec3& p) {
+                return _ambientOcclusionFieldSample(p);
+            },
+            workers_, _cancelFunction());
+        ao_field_updating_ = false;
+
+        _finishBake();
+    }
+
+    void RaymarchRenderer::_finishBake()
+    {
+        //every worker may have baked, so every worker has to drop what it counted and reported. The frame counters should not
+        //include the bake rays and errors of the bake should not end up in the log of the next tile the worker renders
+        std::vector<ShadingErrorLog> worker_errors(workers_.size());
+        workers_.forEachWorker([&](size_t worker_index) {
+            _flushMarchCounters();
+            takeThreadShadingErrors(worker_errors[worker_index]);
+        });
+
+        for(const auto& log : worker_errors) {
+            bake_errors_.merge(log);
+        }
+    }
+
+    void RaymarchRenderer::_updateIrradianceVolume()
+    {
+        if(irradiance_layout_dirty_) {
+            irradiance_layout_dirty_ = false;
+            irradiance_volume_.clear();
+
+            const BoundingBox object_bounds = bvh_.bounds();
+            if(isEmpty(object_bounds)) {
+                RAYCHEL_LOG("Not placing irradiance probes because the scene has no bounded objects");
+                return;
+            }
+
+            //one probe layer of padding around the objects
+            const vec3 padding{irradiance_probe_spacing_, irradiance_probe_spacing_, irradiance_probe_spacing_};
+            irradiance_volume_.setBounds(BoundingBox{object_bounds.min - padding, object_bounds.max + padding}, irradiance_probe_spacing_, irradiance_max_probes_);
+        }
+
+        if(!irradiance_volume_.hasDirtyProbes()) {
+            return;
+        }
+
+        irradiance_updating_ = true;
+        irradiance_volume_.update(
+            [this](const vec3& p) {
+                return sdScene(p);
+            },
+            [this](const vec3& origin, const normalized3& direction) {
+                //only the first hit is shaded, reflections of it see the background
+                return getShadedColor(origin, direction, raymarch_data_.max_recursion_depth);
+            },
+            irradiance_probe_rays_, workers_, _cancelFunction());
+        irradiance_updating_ = false;
+
+        _finishBake();
+    }
+
+    bool RaymarchRenderer::hasReflectionProbe(const ShadingData& data, float roughness) const noexcept
+    {
+        return use_reflection_probes_ && !reflection_probes_updating_ && (roughness >= reflection_probe_min_roughness_) &&
+               reflection_probes_.covers(data.surface_point);
+    }
+
+    color RaymarchRenderer::getProbeReflection(const ShadingData& data, const normalized3& direction, float roughness) const noexcept
+    {
+        thread_read_reflection_probe = true;
+
+        color result{0};
+        reflection_probes_.lookup(data.surface_point, direction, roughness, result);
+        return result;
+    }
+
+    bool RaymarchRenderer::_takeReflectionProbeRead() const noexcept
+    {
+        return std::exchange(thread_read_reflection_probe, false);
+    }
+
+    void RaymarchRenderer::_updateReflectionProbes()
+    {
+        if(reflection_layout_dirty_) {
+            reflection_layout_dirty_ = false;
+            reflection_probes_.clear();
+            if(!reflection_probe_placements_ || reflection_probe_placements_->empty()) {
+                return;
+            }
+            reflection_probes_.setProbes(*reflection_probe_placements_, reflection_probe_resolution_, reflection_probe_mip_count_);
+        }
+
+        if(!reflection_probes_.hasDirtyProbes()) {
+            return;
+        }
+
+        reflection_probes_updating_ = true;
+        reflection_probes_.update(
+            [this](const vec3& origin, const normalized3& direction) {
+                return getShadedColor(origin, direction, 0);
+            },
+            workers_, _cancelFunction());
+        reflection_probes_updating_ = false;
+
+        _finishBake();
+    }
+
+    float RaymarchRenderer::_softShadow(const vec3& origin, const normalized3& direction, float max_depth, float penumbra, float min_visibility) const noexcept
+    {
+        RAYCHEL_ASSERT_NORMALIZED(direction);
+
+        thread_lighting_counters.shadow_rays++;
+
+        //single pass penumbra estimate (Quilez, 2010): a surface at distance d from the ray at depth t covers about d / t of the
+        //view towards the lamp, so the smallest of these ratios relative to the lamp size tells how much of it is visible
+        float visibility = 1.0F;
+        float depth = 0.0F;
+        while(depth < max_depth) {
+            const float distance = _marchDistance(origin + (depth * direction)).distance;
+            thread_lighting_counters.shadow_steps++;
+
+            if(distance < raymarch_data_.distance_bias) {
+                visibility = 0.0F;
+                break;
+            }
+
+            if(penumbra > 0.0F && depth > 0.0F) {
+                visibility = std::min(visibility, distance / (penumbra * depth));
+            }
+
+            //the lamp cannot add enough anymore to be worth marching on
+            if(visibility < min_visibility) {
+                visibility = 0.0F;
+                break;
+            }
+
+            depth += distance;
+        }
+
+        if(visibility == 0.0F) {
+            thread_lighting_counters.occluded_rays++;
+            return 0.0F;
+        }
+
+        //smooth the linear estimate, so the penumbra has no visible edges
+        return visibility * visibility * (3.0F - (2.0F * visibility));
+    }
+
+}
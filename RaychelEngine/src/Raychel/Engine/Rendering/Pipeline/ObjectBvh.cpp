@@ -0,0 +1,315 @@
+#include <algorithm>
+
+#include "Raychel/Engine/Rendering/Pipeline/ObjectBvh.h"
+#include "Raychel/Engine/Objects/Interface.h"
+
+namespace Raychel {
+
+    std::ostream& operator<<(std::ostream& os, const BvhStats& stats)
+    {
+        return os << "{ objects: " << stats.num_objects << ", unbounded objects: " << stats.num_unbounded << ", nodes: " << stats.node_count
+                  << ", leaves: " << stats.leaf_count << ", max depth: " << stats.max_depth << " }";
+    }
+
+    void ObjectBvh::build(const std::vector<not_null<const IRaymarchable*>>& objects, WorkStealingPool& workers)
+    {
+        nodes_.clear();
+        items_.clear();
+        unbounded_.clear();
+
+        for(const auto obj : objects) {
+            if(const auto bounds = obj->getBounds(); bounds && !isEmpty(*bounds)) {
+                items_.push_back({*bounds, center(*bounds), obj});
+            } else {
+                unbounded_.push_back(obj);
+            }
+        }
+
+        if(!items_.empty()) {
+            RAYCHEL_ASSERT(items_.size() < std::numeric_limits<std::uint32_t>::max());
+
+            //build the top of the tree here and leave subtrees of about this size to the workers
+            const size_t pending_size = std::max<size_t>(items_.size() / (workers.size() * 4), 256);
+
+            std::vector<PendingSubtree> pending;
+            nodes_.emplace_back();
+            _buildNode(nodes_, 0, 0, items_.size(), &pending, pending_size);
+
+            std::vector<std::vector<Node>> subtrees(pending.size());
+            workers.parallelFor(pending.size(), [&](size_t i, size_t /*worker_index*/) {
+                subtrees[i].emplace_back();
+                _buildNode(subtrees[i], 0, pending[i].begin, pending[i].end, nullptr, 0);
+            });
+
+            for(size_t i = 0; i < pending.size(); i++) {
+                _spliceSubtree(pending[i].node_index, subtrees[i]);
+            }
+        }
+
+        _collectStats();
+
+        RAYCHEL_LOG("Built object BVH: ", stats_);
+    }
+
+    void ObjectBvh::_buildNode(std::vector<Node>& nodes, size_t node_index, size_t begin, size_t end, std::vector<PendingSubtree>* pending, size_t pending_size)
+    {
+        BoundingBox bounds;
+        BoundingBox centroid_bounds;
+        for(size_t i = begin; i < end; i++) {
+            bounds = merge(bounds, items_[i].bounds);
+            centroid_bounds = merge(centroid_bounds, items_[i].centroid);
+        }
+        nodes[node_index].bounds = bounds;
+
+        const size_t count = end - begin;
+        if(count <= max_leaf_objects) {
+            nodes[node_index].first = static_cast<std::uint32_t>(begin);
+            nodes[node_index].object_count = static_cast<std::uint32_t>(count);
+            return;
+        }
+
+        if(pending && count <= pending_size) {
+            pending->push_back({node_index, begin, end});
+            return;
+        }
+
+        //median split along the axis with the largest centroid spread
+        const vec3 spread = extent(centroid_bounds);
+        const auto axis_of = [](const vec3& v, int axis) {
+            return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+        };
+        const int axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 : (spread.y >= spread.z ? 1 : 2);
+
+        const size_t mid = begin + (count / 2);
+        std::nth_element(items_.begin() + begin, items_.begin() + mid, items_.begin() + end, [&](const BuildItem& a, const BuildItem& b) {
+            return axis_of(a.centroid, axis) < axis_of(b.centroid, axis);
+        });
+
+        const size_t first_child = nodes.size();
+        nodes.emplace_back();
+        nodes.emplace_back();
+        nodes[node_index].first = static_cast<std::uint32_t>(first_child);
+        nodes[node_index].object_count = 0;
+
+        _buildNode(nodes, first_child, begin, mid, pending, pending_size);
+        _buildNode(nodes, first_child + 1, mid, end, pending, pending_size);
+    }
+
+    void ObjectBvh::_spliceSubtree(size_t node_index, const std::vector<Node>& subtree)
+    {
+        //subtree nodes keep their order, so child indices only have to be shifted. The subtree root replaces the placeholder node
+        const size_t offset = nodes_.size() - 1;
+        const auto relocate = [offset](Node node) {
+            if(node.object_count == 0) {
+                node.first = static_cast<std::uint32_t>(node.first + offset);
+            }
+            return node;
+        };
+
+        nodes_[node_index] = relocate(subtree.front());
+        std::transform(subtree.begin() + 1, subtree.end(), std::back_inserter(nodes_), relocate);
+    }
+
+    void ObjectBvh::_collectStats()
+    {
+        stats_ = {};
+        stats_.num_objects = items_.size();
+        stats_.num_unbounded = unbounded_.size();
+        stats_.node_count = nodes_.size();
+
+        if(nodes_.empty()) {
+            return;
+        }
+
+        std::vector<std::pair<std::uint32_t, size_t>> stack{{0, 1}};
+        while(!stack.empty()) {
+            const auto [index, depth] = stack.back();
+            stack.pop_back();
+
+            stats_.max_depth = std::max(stats_.max_depth, depth);
+
+            const Node& node = nodes_[index];
+            if(node.object_count != 0) {
+                stats_.leaf_count++;
+            } else {
+                stack.emplace_back(node.first, depth + 1);
+                stack.emplace_back(node.first + 1, depth + 1);
+            }
+        }
+
+        RAYCHEL_ASSERT(stats_.max_depth < max_stack_depth);
+    }
+
+    ObjectDistance ObjectBvh::closestObject(const vec3& p, float current_min) const
+    {
+        ObjectDistance closest{current_min, nullptr};
+        const auto check_object = [&](const IRaymarchable* obj) {
+            const float object_distance = obj->eval(p);
+            if(object_distance < closest.distance) {
+                closest = {object_distance, obj};
+            }
+        };
+
+        for(const auto obj : unbounded_) {
+            check_object(obj);
+        }
+
+        if(nodes_.empty()) {
+            return closest;
+        }
+
+        struct StackEntry
+        {
+            std::uint32_t index;
+            float box_distance;
+        };
+        std::array<StackEntry, max_stack_depth> stack;
+        size_t stack_size = 0;
+
+        stack[stack_size++] = {0, Raychel::distance(nodes_.front().bounds, p)};
+        while(stack_size != 0) {
+            const StackEntry entry = stack[--stack_size];
+            if(_canSkip(entry.box_distance, closest.distance)) {
+                continue;
+            }
+
+            const Node& node = nodes_[entry.index];
+            if(node.object_count != 0) {
+                for(size_t i = node.first; i < node.first + node.object_count; i++) {
+                    check_object(items_[i].object);
+                }
+                continue;
+            }
+
+            //visit the closer child first so the other one is more likely to be skipped
+            StackEntry a{node.first, Raychel::distance(nodes_[node.first].bounds, p)};
+            StackEntry b{node.first + 1, Raychel::distance(nodes_[node.first + 1].bounds, p)};
+            if(a.box_distance < b.box_distance) {
+                std::swap(a, b);
+            }
+            stack[stack_size++] = a;
+            stack[stack_size++] = b;
+        }
+
+        return closest;
+    }
+
+    void ObjectBvh::distancePacket(const vec3Packet& points, const PacketLanes<bool>& active, PacketLanes<float>& inout_distances, PacketLanes<const IRaymarchable*>& inout_objects) const
+    {
+        PacketLanes<float> object_distances;
+        const auto merge_object = [&](const IRaymarchable* obj) {
+            obj->evalPacket(points, object_distances);
+            for(size_t i = 0; i < ray_packet_width; i++) {
+                if(object_distances[i] < inout_distances[i]) {
+                    inout_distances[i] = object_distances[i];
+                    inout_objects[i] = obj;
+                }
+            }
+        };
+
+        for(const auto obj : unbounded_) {
+            merge_object(obj);
+        }
+
+        if(nodes_.empty()) {
+            return;
+        }
+
+        struct StackEntry
+        {
+            std::uint32_t index;
+            PacketLanes<float> box_distances;
+            //closest box distance of the active lanes
+            float min_box_distance;
+        };
+        const auto make_entry = [&](std::uint32_t index) {
+            StackEntry entry{index, {}, std::numeric_limits<float>::max()};
+            for(size_t i = 0; i < ray_packet_width; i++) {
+                entry.box_distances[i] = Raychel::distance(nodes_[index].bounds, points.lane(i));
+                if(active[i]) {
+                    entry.min_box_distance = std::min(entry.min_box_distance, entry.box_distances[i]);
+                }
+            }
+            return entry;
+        };
+
+        std::array<StackEntry, max_stack_depth> stack;
+        size_t stack_size = 0;
+
+        stack[stack_size++] = make_entry(0);
+        while(stack_size != 0) {
+            const StackEntry entry = stack[--stack_size];
+
+            //a node can only be skipped if it is too far away for every active lane
+            bool skip = true;
+            for(size_t i = 0; i < ray_packet_width; i++) {
+                skip &= !active[i] || _canSkip(entry.box_distances[i], inout_distances[i]);
+            }
+            if(skip) {
+                continue;
+            }
+
+            const Node& node = nodes_[entry.index];
+            if(node.object_count != 0) {
+                for(size_t i = node.first; i < node.first + node.object_count; i++) {
+                    merge_object(items_[i].object);
+                }
+                continue;
+            }
+
+            //visit the child that is closer to the packet first so the other one is more likely to be skipped
+            StackEntry a = make_entry(node.first);
+            StackEntry b = make_entry(node.first + 1);
+            if(a.min_box_distance < b.min_box_distance) {
+                std::swap(a, b);
+            }
+            stack[stack_size++] = a;
+            stack[stack_size++] = b;
+        }
+    }
+
+    size_t ObjectBvh::objectsWithin(const vec3& p, float max_distance, const IRaymarchable** out_objects, size_t capacity) const
+    {
+        size_t count = 0;
+        const auto check_object = [&](const IRaymarchable* obj) {
+            if(obj->eval(p) <= max_distance) {
+                if(count < capacity) {
+                    out_objects[count] = obj;
+                }
+                count++;
+            }
+        };
+
+        for(const auto obj : unbounded_) {
+            check_object(obj);
+        }
+
+        if(nodes_.empty()) {
+            return count;
+        }
+
+        std::array<std::uint32_t, max_stack_depth> stack;
+        size_t stack_size = 0;
+
+        stack[stack_size++] = 0;
+        while(stack_size != 0) {
+            const Node& node = nodes_[stack[--stack_size]];
+
+            if(_canSkip(Raychel::distance(node.bounds, p), max_distance)) {
+                continue;
+            }
+
+            if(node.object_count != 0) {
+                for(size_t i = node.first; i < node.first + node.object_count; i++) {
+                    check_object(items_[i].object);
+                }
+            } else {
+                stack[stack_size++] = node.first + 1;
+                stack[stack_size++] = node.first;
+            }
+        }
+
+        return count;
+    }
+
+}
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <numeric>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include "Raychel/Engine/Rendering/Pipeline/PrimitiveStore.h"
+#include "Raychel/Engine/Objects/Interface.h"
+
+namespace Raychel {
+
+    float sphereMinDistance(const SphereBucket& bucket, size_t begin, size_t end, const vec3& p) noexcept
+    {
+        float min_distance = std::numeric_limits<float>::max();
+        size_t i = begin;
+
+#if defined(__AVX2__)
+        const __m256 px = _mm256_set1_ps(p.x);
+        const __m256 py = _mm256_set1_ps(p.y);
+        const __m256 pz = _mm256_set1_ps(p.z);
+        __m256 min8 = _mm256_set1_ps(min_distance);
+
+        for(; (i + 8) <= end; i += 8) {
+            const __m256 dx = _mm256_sub_ps(px, _mm256_loadu_ps(&bucket.center_x[i]));
+            const __m256 dy = _mm256_sub_ps(py, _mm256_loadu_ps(&bucket.center_y[i]));
+            const __m256 dz = _mm256_sub_ps(pz, _mm256_loadu_ps(&bucket.center_z[i]));
+
+            const __m256 len_sq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+            const __m256 d = _mm256_sub_ps(_mm256_sqrt_ps(len_sq), _mm256_loadu_ps(&bucket.radius[i]));
+
+            min8 = _mm256_min_ps(min8, d);
+        }
+
+        //horizontal minimum of the 8 lanes
+        __m128 min4 = _mm_min_ps(_mm256_castps256_ps128(min8), _mm256_extractf128_ps(min8, 1));
+        min4 = _mm_min_ps(min4, _mm_movehl_ps(min4, min4));
+        min4 = _mm_min_ss(min4, _mm_shuffle_ps(min4, min4, 0x1));
+        min_distance = _mm_cvtss_f32(min4);
+#elif defined(__SSE2__)
+        const __m128 px = _mm_set1_ps(p.x);
+        const __m128 py = _mm_set1_ps(p.y);
+        const __m128 pz = _mm_set1_ps(p.z);
+        __m128 min4 = _mm_set1_ps(min_distance);
+
+        for(; (i + 4) <= end; i += 4) {
+            const __m128 dx = _mm_sub_ps(px, _mm_loadu_ps(&bucket.center_x[i]));
+            const __m128 dy = _mm_sub_ps(py, _mm_loadu_ps(&bucket.center_y[i]));
+            const __m128 dz = _mm_sub_ps(pz, _mm_loadu_ps(&bucket.center_z[i]));
+
+            const __m128 len_sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            min4 = _mm_min_ps(min4, _mm_sub_ps(_mm_sqrt_ps(len_sq), _mm_loadu_ps(&bucket.radius[i])));
+        }
+
+        //horizontal minimum of the 4 lanes
+        min4 = _mm_min_ps(min4, _mm_movehl_ps(min4, min4));
+        min4 = _mm_min_ss(min4, _mm_shuffle_ps(min4, min4, 0x1));
+        min_distance = _mm_cvtss_f32(min4);
+#endif
+
+        for(; i < end; i++) {
+            const float dx = p.x - bucket.center_x[i];
+            const float dy = p.y - bucket.center_y[i];
+            const float dz = p.z - bucket.center_z[i];
+            min_distance = std::min(min_distance, std::sqrt((dx*dx) + (dy*dy) + (dz*dz)) - bucket.radius[i]);
+        }
+
+        return min_distance;
+    }
+
+    /**
+    *\brief Spatially compact range of a SphereBucket that acts as a single object
+    *
+    */
+    class SphereCluster final : public IRaymarchable
+    {
+
+    public:
+
+        SphereCluster(const SphereBucket& bucket, size_t begin, size_t end)
+            :bucket_{bucket}, begin_{begin}, end_{end}
+        {
+            for(size_t i = begin_; i < end_; i++) {
+                const vec3 c = bucket_.center(i);
+                const vec3 r{bucket_.radius[i], bucket_.radius[i], bucket_.radius[i]};
+                bounds_ = merge(bounds_, BoundingBox{c - r, c + r});
+            }
+        }
+
+        float eval(const vec3& p) const override
+        {
+            return sphereMinDistance(bucket_, begin_, end_, p);
+        }
+
+        void evalPacket(const vec3Packet& points, PacketLanes<float>& out_distances) const override
+        {
+            out_distances.fill(std::numeric_limits<float>::max());
+
+            for(size_t s = begin_; s < end_; s++) {
+                const float cx = bucket_.center_x[s];
+                const float cy = bucket_.center_y[s];
+                const float cz = bucket_.center_z[s];
+                const float r = bucket_.radius[s];
+
+                for(size_t i = 0; i < ray_packet_width; i++) {
+                    const float dx = points.x[i] - cx;
+                    const float dy = points.y[i] - cy;
+                    const float dz = points.z[i] - cz;
+                    out_distances[i] = std::min(out_distances[i], std::sqrt((dx*dx) + (dy*dy) + (dz*dz)) - r);
+                }
+            }
+        }
+
+        std::optional<BoundingBox> getBounds() const override
+        {
+            return bounds_;
+        }
+
+        const IRaymarchable* resolveHitObject(const vec3& p) const override
+        {
+            return bucket_.owners[_closestSphere(p)];
+        }
+
+        vec3 getDirectionToObject(const vec3& p) const override
+        {
+            const size_t i = _closestSphere(p);
+            return bucket_.center(i) - p;
+        }
+
+        color getSurfaceColor(const ShadingData& data) const override
+        {
+            return resolveHitObject(data.surface_point)->getSurfaceColor(data);
+        }
+
+        bool getSecondaryRay(const ShadingData& data, vec3& out_direction, color& out_weight) const override
+        {
+            return resolveHitObject(data.surface_point)->getSecondaryRay(data, out_direction, out_weight);
+        }
+
+        //the original objects are still attached to the renderer themselves
+        void onRendererAttached(const not_null<RaymarchRenderer*>) override {}
+
+    private:
+
+        size_t _closestSphere(const vec3& p) const noexcept
+        {
+            size_t closest = begin_;
+            float min_distance = std::numeric_limits<float>::max();
+            for(size_t i = begin_; i < end_; i++) {
+                const float d = std::abs(dist(p, bucket_.center(i)) - bucket_.radius[i]);
+                if(d < min_distance) {
+                    min_distance = d;
+                    closest = i;
+                }
+            }
+            return closest;
+        }
+
+        const SphereBucket& bucket_;
+        size_t begin_, end_;
+        BoundingBox bounds_;
+    };
+
+    namespace {
+
+        //recursively split the range at the median of its widest axis until every part fits into one cluster
+        void splitIntoClusters(const SphereBucket& bucket, std::vector<size_t>& permutation, size_t begin, size_t end, size_t max_size)
+        {
+            if((end - begin) <= max_size) {
+                return;
+            }
+
+            BoundingBox center_bounds;
+            for(size_t i = begin; i < end; i++) {
+                center_bounds = merge(center_bounds, bucket.center(permutation[i]));
+            }
+
+            const vec3 spread = extent(center_bounds);
+            const auto axis_of = [](const vec3& v, int axis) {
+                return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+            };
+            const int axis = (spread.x >= spread.y && spread.x >= spread.z) ? 0 : (spread.y >= spread.z ? 1 : 2);
+
+            //round the split point to a multiple of max_size so only the last cluster can be partially filled
+            const size_t mid = begin + std::max<size_t>(((end - begin) / 2) / max_size, 1) * max_size;
+            std::nth_element(permutation.begin() + begin, permutation.begin() + mid, permutation.begin() + end, [&](size_t a, size_t b) {
+                return axis_of(bucket.center(a), axis) < axis_of(bucket.center(b), axis);
+            });
+
+            splitIntoClusters(bucket, permutation, begin, mid, max_size);
+            splitIntoClusters(bucket, permutation, mid, end, max_size);
+        }
+
+        template<typename T>
+        void applyPermutation(std::vector<T>& values, const std::vector<size_t>& permutation)
+        {
+            std::vector<T> sorted;
+            sorted.reserve(values.size());
+            for(const auto i : permutation) {
+                sorted.push_back(values[i]);
+            }
+            values = std::move(sorted);
+        }
+
+    }
+
+    PrimitiveStore::PrimitiveStore()=default;
+
+    void PrimitiveStore::addSphere(const vec3& center, float radius, not_null<const IRaymarchable*> owner)
+    {
+        spheres_.center_x.push_back(center.x);
+        spheres_.center_y.push_back(center.y);
+        spheres_.center_z.push_back(center.z);
+        spheres_.radius.push_back(radius);
+        spheres_.owners.push_back(owner);
+    }
+
+    void PrimitiveStore::clear()
+    {
+        clusters_.clear();
+        spheres_ = {};
+    }
+
+    void PrimitiveStore::finalize(std::vector<not_null<const IRaymarchable*>>& out_objects)
+    {
+        RAYCHEL_ASSERT(clusters_.empty());
+
+        //reorder the spheres so every cluster covers a compact region
+        std::vector<size_t> permutation(spheres_.size());
+        std::iota(permutation.begin(), permutation.end(), 0);
+        splitIntoClusters(spheres_, permutation, 0, permutation.size(), cluster_size);
+
+        applyPermutation(spheres_.center_x, permutation);
+        applyPermutation(spheres_.center_y, permutation);
+        applyPermutation(spheres_.center_z, permutation);
+        applyPermutation(spheres_.radius, permutation);
+        applyPermutation(spheres_.owners, permutation);
+
+        for(size_t begin = 0; begin < spheres_.size(); begin += cluster_size) {
+            const size_t end = std::min(begin + cluster_size, spheres_.size());
+            clusters_.push_back(std::make_unique<SphereCluster>(spheres_, begin, end));
+            out_objects.push_back(clusters_.back().get());
+        }
+
+        RAYCHEL_LOG("Compiled ", spheres_.size(), " spheres into ", clusters_.size(), " clusters");
+    }
+
+    PrimitiveStore::~PrimitiveStore()=default;
+
+}
@@ -26,12 +26,37 @@
 *
 */
 
+#include <algorithm>
+
 #include "Raychel/Engine/Rendering/Pipeline/Shading.h"
 #include "Raychel/Engine/Objects/Interface.h"
 #include "Raychel/Misc/Texture/CubeTexture.h"
 
 namespace Raychel {
 
+    namespace {
+
+        struct MarchCounters
+        {
+            size_t rays{0}, steps{0}, backtracks{0}, cached_steps{0};
+        };
+
+        //counters of the calling thread. Added to the frame totals after every tile, so the hot loop does not touch shared memory
+        thread_local MarchCounters thread_march_counters;
+
+    }
+
+    void RaymarchRenderer::_flushMarchCounters() const noexcept
+    {
+        frame_ray_count_ += thread_march_counters.rays;
+        frame_step_count_ += thread_march_counters.steps;
+        frame_backtrack_count_ += thread_march_counters.backtracks;
+        frame_cached_step_count_ += thread_march_counters.cached_steps;
+        thread_march_counters = {};
+
+        _flushLightingCounters();
+    }
+
     vec3 RaymarchRenderer::_getRayDirectionFromUV(const vec2& uv) const noexcept
     {
         return normalize(   (cam_data_.forward*cam_data_.zoom) +
@@ -39,123 +64,376 @@ namespace Raychel {
                             (cam_data_.up * uv.y) );
     }
 
-    RenderResult RaymarchRenderer::_raymarchFunction(const RaymarchData& req) const noexcept
+    RenderResult RaymarchRenderer::_raymarchFunction(const vec3& direction, float start_depth, PrimarySample* out_sample) const noexcept
     {
-        const vec2 screenspace_uv = _getScreenspaceUV(req.uv);
         const vec3 origin = cam_data_.position;
-        const vec3 direction = _getRayDirectionFromUV(req.uv);
-
-        if(!failed_) {
-            try {
-                color res = getShadedColor(origin, direction, 0);
-                return {screenspace_uv, res};
-            
-            }catch(const exception_context& exception) {
-                new (&current_exception_) exception_context(exception);
-                failed_ = true;
-            }catch(...) {
-                RAYCHEL_TERMINATE("RaymarchRenderer::getShadedColor() threw unexpected exception!");
+
+        PrimarySample sample{nullptr, raymarch_data_.max_ray_depth};
+        RenderResult result;
+
+        float depth = 0;
+        size_t num_ray_steps = 0;
+        ObjectDistance hit;
+        if(raymarch(origin, direction, start_depth, raymarch_data_.max_ray_depth, &depth, &num_ray_steps, &hit)) {
+            sample.depth = depth;
+            result.output = _shadeHit(origin, direction, depth, hit, num_ray_steps, 0, &sample);
+        } else {
+            result.output = (*background_texture_)(direction);
+        }
+
+        if(out_sample) {
+            *out_sample = sample;
+        }
+        return result;
+    }
+
+    void RaymarchRenderer::_getRowDirections(const PixelRow& row, const PacketLanes<float>& xs, vec3Packet& out_directions) const noexcept
+    {
+        //plain lane loops, so the compiler can vectorize them
+        for(size_t i = 0; i < ray_packet_width; i++) {
+            out_directions.x[i] = row.direction_origin.x + (xs[i] * row.direction_step.x);
+            out_directions.y[i] = row.direction_origin.y + (xs[i] * row.direction_step.y);
+            out_directions.z[i] = row.direction_origin.z + (xs[i] * row.direction_step.z);
+        }
+
+        for(size_t i = 0; i < ray_packet_width; i++) {
+            const float inverse_length = 1.0F / std::sqrt((out_directions.x[i] * out_directions.x[i]) + (out_directions.y[i] * out_directions.y[i]) + (out_directions.z[i] * out_directions.z[i]));
+            out_directions.x[i] *= inverse_length;
+            out_directions.y[i] *= inverse_length;
+            out_directions.z[i] *= inverse_length;
+        }
+    }
+
+    void RaymarchRenderer::_raymarchPacketFunction(const vec3Packet& in_directions, size_t count, const PacketLanes<float>& start_depths, RenderResult* out_results, PrimarySample* out_samples) const noexcept
+    {
+        RAYCHEL_ASSERT(count != 0 && count <= ray_packet_width);
+
+        const vec3 origin = cam_data_.position;
+
+        //lanes past count repeat the last ray and are masked off
+        vec3Packet directions = in_directions;
+        PacketLanes<bool> hit_mask{};
+        for(size_t i = 0; i < ray_packet_width; i++) {
+            if(i >= count) {
+                directions.setLane(i, in_directions.lane(count-1));
             }
+            hit_mask[i] = i < count;
         }
 
-        return {screenspace_uv, color{0}};
+        PacketLanes<float> depths;
+        PacketLanes<size_t> num_ray_steps;
+        PacketLanes<ObjectDistance> hits;
+        raymarchPacket(origin, directions, start_depths, raymarch_data_.max_ray_depth, hit_mask, depths, num_ray_steps, hits);
+
+        for(size_t i = 0; i < count; i++) {
+            const vec3 direction = directions.lane(i);
+
+            PrimarySample sample{nullptr, raymarch_data_.max_ray_depth};
+            if(hit_mask[i]) {
+                sample.depth = depths[i];
+                out_results[i].output = _shadeHit(origin, direction, depths[i], hits[i], num_ray_steps[i], 0, &sample);
+            } else {
+                out_results[i].output = (*background_texture_)(direction);
+            }
+
+            if(out_samples) {
+                out_samples[i] = sample;
+            }
+        }
     }
 
-    color RaymarchRenderer::getShadedColor(const vec3& origin, const normalized3& direction, size_t recursion_depth) const
+    RenderResult RaymarchRenderer::_backgroundFunction(const vec3& direction) const noexcept
+    {
+        return {(*background_texture_)(direction)};
+    }
+
+    color RaymarchRenderer::getShadedColor(const vec3& origin, const normalized3& direction, size_t recursion_depth, float start_depth) const
     {
         RAYCHEL_ASSERT_NORMALIZED(direction);
 
         if(recursion_depth <= raymarch_data_.max_recursion_depth) {
             float depth = 0;
             size_t num_ray_steps = 0;
-            if(raymarch(origin, direction, raymarch_data_.max_ray_depth, &depth, &num_ray_steps)){
-                const RaymarchHitInfo hit_info = getHitInfo(origin, direction, depth, num_ray_steps, recursion_depth);
-
-                return hit_info.hit_object->getSurfaceColor(hit_info.shading_data);
+            ObjectDistance hit;
+            if(raymarch(origin, direction, start_depth, raymarch_data_.max_ray_depth, &depth, &num_ray_steps, &hit)){
+                return _shadeHit(origin, direction, depth, hit, num_ray_steps, recursion_depth);
             }
         }
         return (*background_texture_)(direction);
     }
 
+    color RaymarchRenderer::_shadeHit(const vec3& origin, const normalized3& direction, float depth, const ObjectDistance& hit, size_t num_ray_steps, size_t recursion_depth, PrimarySample* out_sample) const
+    {
+        const RaymarchHitInfo hit_info = getHitInfo(origin, direction, depth, hit, num_ray_steps, recursion_depth);
+
+        if(out_sample) {
+            out_sample->object = hit_info.hit_object;
+            //only reads by this hit count
+            _takeReflectionProbeRead();
+        }
+
+        color result = hit_info.hit_object->getSurfaceColor(hit_info.shading_data);
+
+        if(out_sample) {
+            out_sample->view_dependent = _takeReflectionProbeRead();
+        }
+
+        vec3 secondary_direction;
+        color secondary_weight;
+        if(hit_info.hit_object->getSecondaryRay(hit_info.shading_data, secondary_direction, secondary_weight)) {
+            result += secondary_weight * getShadedColor(hit_info.shading_data.surface_point, secondary_direction, hit_info.shading_data.recursion_depth);
+            if(out_sample) {
+                out_sample->view_dependent = true;
+            }
+        }
+
+        return result;
+    }
+
 
 
-    RaymarchHitInfo RaymarchRenderer::getHitInfo(const vec3& origin, const normalized3& direction, float depth, size_t num_ray_steps, size_t recursion_depth) const noexcept
+    RaymarchHitInfo RaymarchRenderer::getHitInfo(const vec3& origin, const normalized3& direction, float depth, const ObjectDistance& hit, size_t num_ray_steps, size_t recursion_depth) const noexcept
     {
         RAYCHEL_ASSERT_NORMALIZED(direction);
+        RAYCHEL_ASSERT(hit.object);
 
         const vec3 hit_point = origin + (direction * depth);
 
-        const vec3 normal = getNormal(hit_point);
+        const vec3 normal = getNormal(hit_point, hit);
         const vec3 surface_point = hit_point + (normal * raymarch_data_.surface_bias);
-        
-        const IRaymarchable* hit_obj = getHitObject(hit_point);
+
+        //the closest object was already found by the last raymarching step
+        const IRaymarchable* hit_obj = hit.object->resolveHitObject(hit_point);
         RAYCHEL_ASSERT(hit_obj);
 
         return {{surface_point, normal, direction, num_ray_steps, depth, recursion_depth+1}, hit_obj};
     }
 
-    vec3 RaymarchRenderer::getNormal(const vec3& p) const noexcept
+    vec3 RaymarchRenderer::getNormal(const vec3& p, const ObjectDistance& hit) const noexcept
     {
+        //tetrahedral gradient estimate. Every sample is sqrt(3)*k away from p, so only objects that are
+        //at most 2*sqrt(3)*k further away than the hit object can be the closest one at any of the samples
         const float k = raymarch_data_.normal_bias;
-        return normalize(vec3{
-            sdScene(p+vec3{k, 0, 0}) - sdScene(p + vec3{-k, 0, 0}),
-            sdScene(p+vec3{0, k, 0}) - sdScene(p + vec3{0, -k, 0}),
-            sdScene(p+vec3{0, 0, k}) - sdScene(p + vec3{0, 0, -k}),
-        });
-    }
+        constexpr float sqrt3 = 1.7320508F;
 
-    IRaymarchable* RaymarchRenderer::getHitObject(const vec3& p) const noexcept
-    {
-        float min_distance = raymarch_data_.max_ray_depth;
-        IRaymarchable* closest_object = nullptr;
-        for(const auto& object : *objects_) {
-            float object_distance = object->eval(p);
+        std::array<const IRaymarchable*, 8> nearby_objects;
+        const size_t nearby_count = bvh_.objectsWithin(p, hit.distance + (2.0F * sqrt3 * k), nearby_objects.data(), nearby_objects.size());
 
-            if(object_distance < raymarch_data_.distance_bias && std::abs(object_distance) < min_distance) {
-                min_distance = std::abs(object_distance);
-                closest_object = object;
+        const auto sd_nearby = [&](const vec3& q) {
+            if(nearby_count > nearby_objects.size()) {
+                return sdScene(q);
             }
+            float d = std::numeric_limits<float>::max();
+            for(size_t i = 0; i < nearby_count; i++) {
+                d = std::min(d, nearby_objects[i]->eval(q));
+            }
+            return d;
+        };
 
-        }
-        return closest_object;
+        const vec3 a{1, -1, -1}, b{-1, -1, 1}, c{-1, 1, -1}, d{1, 1, 1};
+        return normalize(   (a * sd_nearby(p + (a * k))) +
+                            (b * sd_nearby(p + (b * k))) +
+                            (c * sd_nearby(p + (c * k))) +
+                            (d * sd_nearby(p + (d * k))) );
     }
 
 
 
     float RaymarchRenderer::sdScene(const vec3& p) const
     {
-        float min = 10.0;
-        for(const auto obj : *objects_) {
-            min = std::min(min, obj->eval(p));
+        return bvh_.distance(p, 10.0F);
+    }
+
+    ObjectDistance RaymarchRenderer::sdSceneClosest(const vec3& p) const
+    {
+        return bvh_.closestObject(p, 10.0F);
+    }
+
+    ObjectDistance RaymarchRenderer::_marchDistance(const vec3& p) const
+    {
+        if(sdf_cache_.isBaked()) {
+            //the cached distance is never too large, and close to surfaces the exact distance is used, so hits are always exact
+            const float cached = sdf_cache_.distance(p);
+            if(cached >= sdf_cache_.exactThreshold()) {
+                thread_march_counters.cached_steps++;
+                return {cached, nullptr};
+            }
         }
-        return min;
+        return sdSceneClosest(p);
     }
 
     
 
-    bool RaymarchRenderer::raymarch(const vec3& origin, const normalized3& direction, float max_depth, float* out_depth, size_t* out_num_ray_steps) const noexcept
+    float RaymarchRenderer::_coneMarch(const Tile& rect, float start_depth, float end_depth) const noexcept
+    {
+        const vec3 origin = cam_data_.position;
+
+        //the rays of rect lie between the rays of its corner pixels
+        const vec2i last = rect.origin + rect.size - vec2i{1, 1};
+        const std::array<vec3, 4> corners{
+            _getRayDirectionFromUV(_getRootRequest(static_cast<float>(rect.origin.x), static_cast<float>(rect.origin.y)).uv),
+            _getRayDirectionFromUV(_getRootRequest(static_cast<float>(last.x), static_cast<float>(rect.origin.y)).uv),
+            _getRayDirectionFromUV(_getRootRequest(static_cast<float>(rect.origin.x), static_cast<float>(last.y)).uv),
+            _getRayDirectionFromUV(_getRootRequest(static_cast<float>(last.x), static_cast<float>(last.y)).uv),
+        };
+
+        const vec3 axis = normalize(corners[0] + corners[1] + corners[2] + corners[3]);
+
+        //at depth t, every ray of the rect is at most t*spread away from the axis
+        float spread = 0.0F;
+        for(const auto& corner : corners) {
+            spread = std::max(spread, dist(corner, axis));
+        }
+
+        //A ray point at depth s is at most s*spread + (s - t) away from the axis point at depth t. With the scene distance d at
+        //the axis point, there can't be a surface on any of the rays before s = (d + t) / (1 + spread)
+        float depth = start_depth;
+        for(size_t i = 0; (i < max_cone_steps) && (depth < end_depth); i++) {
+            const float free_distance = _marchDistance(origin + (depth * axis)).distance - (depth * spread);
+            thread_march_counters.steps++;
+
+            if(free_distance < raymarch_data_.distance_bias) {
+                break;
+            }
+            depth += free_distance / (1.0F + spread);
+        }
+
+        return std::min(depth, raymarch_data_.max_ray_depth);
+    }
+
+    bool RaymarchRenderer::raymarch(const vec3& origin, const normalized3& direction, float start_depth, float max_depth, float* out_depth, size_t* out_num_ray_steps, ObjectDistance* out_hit) const noexcept
     {
         RAYCHEL_ASSERT_NORMALIZED(direction);
 
+        //over-relaxed sphere tracing (Keinert et al., 2014). With over_relaxation == 1 this is classic sphere tracing
+        const float omega = raymarch_data_.over_relaxation;
+        float step_length = 0;
+        float previous_distance = 0;
+
+        thread_march_counters.rays++;
+
         size_t i = 0;
-        float depth = 0;
+        float depth = start_depth;
         while(depth < max_depth) {
             const vec3 p = origin + (depth*direction);
 
-            const float scene_dist = sdScene(p);
+            const ObjectDistance closest = _marchDistance(p);
+            thread_march_counters.steps++;
+
+            //the unbounding spheres of the last two points have to overlap. Otherwise there might be a surface between them.
+            //This can never fail for a classic step
+            if((std::abs(closest.distance) + previous_distance) < step_length) {
+                //take the classic step from the last point instead. Its distance is already known, so no extra evaluation is needed
+                depth += previous_distance - step_length;
+                step_length = previous_distance;
+                thread_march_counters.backtracks++;
+                i++;
+                continue;
+            }
 
-            if(scene_dist < raymarch_data_.distance_bias) {
+            if(closest.distance < raymarch_data_.distance_bias) {
                 if(out_depth)
                     *out_depth = depth;
                 if(out_num_ray_steps)
                     *out_num_ray_steps = i;
+                if(out_hit)
+                    *out_hit = closest;
                 return true;
             }
 
-            depth += scene_dist;
+            previous_distance = closest.distance;
+            step_length = closest.distance * omega;
+            depth += step_length;
             i++;
         }
         return false;
     }
 
+    void RaymarchRenderer::sdScenePacket(const vec3Packet& points, const PacketLanes<bool>& active, PacketLanes<float>& out_distances, PacketLanes<const IRaymarchable*>& out_objects) const
+    {
+        out_objects.fill(nullptr);
+
+        if(sdf_cache_.isBaked()) {
+            bool all_cached = true;
+            for(size_t i = 0; i < ray_packet_width; i++) {
+                out_distances[i] = sdf_cache_.distance(points.lane(i));
+                all_cached &= !active[i] || (out_distances[i] >= sdf_cache_.exactThreshold());
+            }
+
+            if(all_cached) {
+                thread_march_counters.cached_steps += static_cast<size_t>(std::count(active.cbegin(), active.cend(), true));
+                return;
+            }
+        }
+
+        out_distances.fill(10.0F);
+        bvh_.distancePacket(points, active, out_distances, out_objects);
+    }
+
+    void RaymarchRenderer::raymarchPacket(const vec3& origin, const vec3Packet& directions, const PacketLanes<float>& start_depths, float max_depth, PacketLanes<bool>& inout_mask, PacketLanes<float>& out_depths, PacketLanes<size_t>& out_num_ray_steps, PacketLanes<ObjectDistance>& out_hits) const noexcept
+    {
+        //lanes that are still marching. Finished lanes keep being evaluated, but their results are ignored
+        PacketLanes<bool> active = inout_mask;
+        inout_mask.fill(false);
+        out_depths = start_depths;
+        out_num_ray_steps.fill(0U);
+
+        const auto any_active = [&active]{
+            return std::any_of(active.cbegin(), active.cend(), [](bool b){ return b; });
+        };
+
+        //per lane state for over-relaxed marching. See raymarch()
+        const float omega = raymarch_data_.over_relaxation;
+        PacketLanes<float> step_lengths, previous_distances;
+        step_lengths.fill(0.0F);
+        previous_distances.fill(0.0F);
+
+        thread_march_counters.rays += static_cast<size_t>(std::count(active.cbegin(), active.cend(), true));
+
+        //like in raymarch(), rays that start past max_depth are not evaluated at all
+        for(size_t i = 0; i < ray_packet_width; i++) {
+            active[i] = active[i] && (out_depths[i] < max_depth);
+        }
+
+        vec3Packet points;
+        PacketLanes<float> scene_distances;
+        PacketLanes<const IRaymarchable*> closest_objects;
+        while(any_active()) {
+            for(size_t i = 0; i < ray_packet_width; i++) {
+                points.x[i] = origin.x + (out_depths[i] * directions.x[i]);
+                points.y[i] = origin.y + (out_depths[i] * directions.y[i]);
+                points.z[i] = origin.z + (out_depths[i] * directions.z[i]);
+            }
+
+            sdScenePacket(points, active, scene_distances, closest_objects);
+
+            for(size_t i = 0; i < ray_packet_width; i++) {
+                if(!active[i]) {
+                    continue;
+                }
+
+                thread_march_counters.steps++;
+
+                if((std::abs(scene_distances[i]) + previous_distances[i]) < step_lengths[i]) {
+                    out_depths[i] += previous_distances[i] - step_lengths[i];
+                    step_lengths[i] = previous_distances[i];
+                    thread_march_counters.backtracks++;
+                } else {
+                    if(scene_distances[i] < raymarch_data_.distance_bias) {
+                        inout_mask[i] = true;
+                        out_hits[i] = {scene_distances[i], closest_objects[i]};
+                        active[i] = false;
+                        continue;
+                    }
+                    previous_distances[i] = scene_distances[i];
+                    step_lengths[i] = scene_distances[i] * omega;
+                    out_depths[i] += step_lengths[i];
+                }
+
+                out_num_ray_steps[i]++;
+                active[i] = out_depths[i] < max_depth;
+            }
+        }
+    }
+
 }
\ No newline at end of file
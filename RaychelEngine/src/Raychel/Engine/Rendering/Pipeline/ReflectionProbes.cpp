@@ -0,0 +1,308 @@
+#include <atomic>
+#include <cmath>
+
+#include "Raychel/Engine/Rendering/Pipeline/ReflectionProbes.h"
+
+namespace Raychel {
+
+    namespace {
+
+        std::array<float, 3> components(const vec3& v) noexcept
+        {
+            return {v.x, v.y, v.z};
+        }
+
+        //direction through the point (u, v) of a cube face, both in [-1; 1]. Faces are +x, -x, +y, -y, +z, -z. Not normalized
+        vec3 faceDirection(size_t face, float u, float v) noexcept
+        {
+            const size_t axis = face / 2;
+            std::array<float, 3> d{};
+            d[axis] = (face % 2 == 0) ? 1.0F : -1.0F;
+            d[(axis + 1) % 3] = u;
+            d[(axis + 2) % 3] = v;
+            return vec3{d[0], d[1], d[2]};
+        }
+
+        //inverse of faceDirection()
+        void faceCoordinates(const vec3& direction, size_t& face, float& u, float& v) noexcept
+        {
+            const std::array<float, 3> d = components(direction);
+            size_t axis = 0;
+            if(std::abs(d[1]) > std::abs(d[axis])) {
+                axis = 1;
+            }
+            if(std::abs(d[2]) > std::abs(d[axis])) {
+                axis = 2;
+            }
+
+            const float major = std::abs(d[axis]);
+            face = (axis * 2) + (d[axis] < 0.0F ? 1 : 0);
+            u = d[(axis + 1) % 3] / major;
+            v = d[(axis + 2) % 3] / major;
+        }
+
+        //center of texel i of a face with resolution texels per edge, in [-1; 1]
+        float texelCenter(size_t i, size_t resolution) noexcept
+        {
+            return (((static_cast<float>(i) + 0.5F) / static_cast<float>(resolution)) * 2.0F) - 1.0F;
+        }
+
+        //Phong exponent of the specular lobe for a roughness, using alpha = roughness^2
+        float lobeExponent(float roughness) noexcept
+        {
+            const float alpha = std::max(roughness * roughness, 1e-3F);
+            return std::max((2.0F / (alpha * alpha)) - 2.0F, 0.0F);
+        }
+
+    }
+
+    std::ostream& operator<<(std::ostream& os, const ReflectionProbeStats& stats)
+    {
+        return os << "{ probes: " << stats.probe_count << ", resolution: " << stats.resolution << ", mips: " << stats.mip_count
+                  << ", updated: " << stats.updated_probe_count << ", rays: " << stats.ray_count << ", memory: " << (stats.memory_usage / 1024)
+                  << "KiB }";
+    }
+
+    void ReflectionProbes::setProbes(const std::vector<ReflectionProbePlacement>& placements, size_t resolution, size_t mip_count)
+    {
+        RAYCHEL_ASSERT(resolution != 0 && mip_count != 0);
+
+        clear();
+
+        placements_ = placements;
+        resolution_ = resolution;
+        mip_count_ = 1;
+        while((mip_count_ < mip_count) && ((resolution_ >> mip_count_) != 0)) {
+            mip_count_++;
+        }
+
+        for(size_t level = 0; level < mip_count_; level++) {
+            level_offsets_.push_back(probe_stride_);
+            probe_stride_ += 6 * _levelResolution(level) * _levelResolution(level);
+        }
+
+        texels_.assign(placements_.size() * probe_stride_, color{0});
+        baked_.assign(placements_.size(), 0U);
+        dirty_.assign(placements_.size(), 1U);
+
+        stats_.probe_count = placements_.size();
+        stats_.resolution = resolution_;
+        stats_.mip_count = mip_count_;
+        stats_.memory_usage = texels_.size() * sizeof(color);
+    }
+
+    void ReflectionProbes::markDirty(const BoundingBox& region, float radius) noexcept
+    {
+        const vec3 padding{radius, radius, radius};
+        const BoundingBox grown{region.min - padding, region.max + padding};
+        for(size_t i = 0; i < placements_.size(); i++) {
+            const BoundingBox& bounds = placements_[i].bounds;
+            const bool overlaps = (grown.min.x <= bounds.max.x) && (grown.max.x >= bounds.min.x) && (grown.min.y <= bounds.max.y) &&
+                                  (grown.max.y >= bounds.min.y) && (grown.min.z <= bounds.max.z) && (grown.max.z >= bounds.min.z);
+            if(overlaps) {
+                dirty_[i] = 1U;
+            }
+        }
+    }
+
+    void ReflectionProbes::update(const RadianceFunction& radiance, WorkStealingPool& workers, const CancelFunction& cancelled)
+    {
+        std::vector<size_t> dirty_probes;
+        for(size_t i = 0; i < dirty_.size(); i++) {
+            if(dirty_[i] != 0) {
+                dirty_probes.push_back(i);
+            }
+        }
+
+        //the probes are only written after all of them are baked, so lookups during the update see consistent cubemaps
+        std::vector<color> baked(dirty_probes.size() * probe_stride_);
+
+        //rows of every probe that were finished. A probe is only complete once all rows of all levels are
+        std::vector<std::atomic_size_t> finished_rows(dirty_probes.size());
+        size_t rows_per_probe = 0;
+        for(size_t level = 0; level < mip_count_; level++) {
+            rows_per_probe += 6 * _levelResolution(level);
+        }
+
+        //level 0 is the scene as seen from the probe, one job per row of a face
+        workers.parallelFor(dirty_probes.size() * 6 * resolution_, [&](size_t job, size_t /*worker_index*/) {
+            if(cancelled && cancelled()) {
+                return;
+            }
+
+            const size_t k = job / (6 * resolution_);
+            const size_t face = (job / resolution_) % 6;
+            const size_t y = job % resolution_;
+            const vec3& position = placements_[dirty_probes[k]].position;
+
+            color* row = &baked[(k * probe_stride_) + (((face * resolution_) + y) * resolution_)];
+            for(size_t x = 0; x < resolution_; x++) {
+                row[x] = radiance(position, normalize(faceDirection(face, texelCenter(x, resolution_), texelCenter(y, resolution_))));
+            }
+            finished_rows[k]++;
+        });
+
+        //directions and solid angles of the level 0 texels, which every other level is filtered from
+        const size_t source_count = 6 * resolution_ * resolution_;
+        std::vector<vec3> source_directions(source_count);
+        std::vector<float> source_weights(source_count);
+        for(size_t i = 0; i < source_count; i++) {
+            const float u = texelCenter(i % resolution_, resolution_);
+            const float v = texelCenter((i / resolution_) % resolution_, resolution_);
+            const float d = 1.0F + (u * u) + (v * v);
+            source_directions[i] = normalize(faceDirection(i / (resolution_ * resolution_), u, v));
+            source_weights[i] = 1.0F / (d * std::sqrt(d));
+        }
+
+        for(size_t level = 1; level < mip_count_; level++) {
+            const size_t level_resolution = _levelResolution(level);
+            const float exponent = lobeExponent(static_cast<float>(level) / static_cast<float>(mip_count_ - 1));
+            //texels where the lobe has fallen below 1e-4 are skipped
+            const float min_cosine = exponent > 0.0F ? std::pow(1e-4F, 1.0F / exponent) : 0.0F;
+
+            workers.parallelFor(dirty_probes.size() * 6 * level_resolution, [&](size_t job, size_t /*worker_index*/) {
+                const size_t k = job / (6 * level_resolution);
+                //probes with missing level 0 rows are not completed in this update anyway
+                if(finished_rows[k] < 6 * resolution_ || (cancelled && cancelled())) {
+                    return;
+                }
+
+                const size_t face = (job / level_resolution) % 6;
+                const size_t y = job % level_resolution;
+                const color* source = &baked[k * probe_stride_];
+
+                color* row = &baked[(k * probe_stride_) + level_offsets_[level] + (((face * level_resolution) + y) * level_resolution)];
+                for(size_t x = 0; x < level_resolution; x++) {
+                    const vec3 center = normalize(faceDirection(face, texelCenter(x, level_resolution), texelCenter(y, level_resolution)));
+
+                    color sum{0};
+                    float weight_sum = 0.0F;
+                    for(size_t i = 0; i < source_count; i++) {
+                        const float cosine = dot(center, source_directions[i]);
+                        if(cosine <= min_cosine) {
+                            continue;
+                        }
+                        const float weight = std::pow(cosine, exponent) * source_weights[i];
+                        sum += source[i] * weight;
+                        weight_sum += weight;
+                    }
+                    row[x] = weight_sum > 0.0F ? sum / weight_sum : color{0};
+                }
+                finished_rows[k]++;
+            });
+        }
+
+        size_t updated_probe_count = 0;
+        for(size_t k = 0; k < dirty_probes.size(); k++) {
+            if(finished_rows[k] != rows_per_probe) {
+                continue;
+            }
+            updated_probe_count++;
+            std::copy_n(baked.cbegin() + static_cast<std::ptrdiff_t>(k * probe_stride_), probe_stride_,
+                        texels_.begin() + static_cast<std::ptrdiff_t>(dirty_probes[k] * probe_stride_));
+            baked_[dirty_probes[k]] = 1U;
+            dirty_[dirty_probes[k]] = 0U;
+        }
+
+        stats_.updated_probe_count = updated_probe_count;
+        stats_.ray_count = updated_probe_count * source_count;
+
+        RAYCHEL_LOG("Updated reflection probes: ", stats_);
+    }
+
+    void ReflectionProbes::clear() noexcept
+    {
+        placements_.clear();
+        baked_.clear();
+        dirty_.clear();
+        resolution_ = 0;
+        mip_count_ = 0;
+        level_offsets_.clear();
+        probe_stride_ = 0;
+        texels_.clear();
+        stats_ = {};
+    }
+
+    bool ReflectionProbes::lookup(const vec3& p, const normalized3& direction, float roughness, color& out_color) const noexcept
+    {
+        RAYCHEL_ASSERT_NORMALIZED(direction);
+
+        const size_t probe = _findProbe(p);
+        if(probe == placements_.size()) {
+            return false;
+        }
+
+        //intersect the reflected ray with the probe bounds from the inside and look up the hit point as seen from the probe
+        const ReflectionProbePlacement& placement = placements_[probe];
+        const std::array<float, 3> origin = components(p);
+        const std::array<float, 3> d = components(direction);
+        const std::array<float, 3> box_min = components(placement.bounds.min);
+        const std::array<float, 3> box_max = components(placement.bounds.max);
+        float t = std::numeric_limits<float>::max();
+        for(size_t axis = 0; axis < 3; axis++) {
+            if(d[axis] > 0.0F) {
+                t = std::min(t, (box_max[axis] - origin[axis]) / d[axis]);
+            } else if(d[axis] < 0.0F) {
+                t = std::min(t, (box_min[axis] - origin[axis]) / d[axis]);
+            }
+        }
+        const vec3 corrected = (p + (direction * t)) - placement.position;
+        const vec3 lookup_direction = dot(corrected, corrected) > 1e-8F ? corrected : vec3{direction};
+
+        const float level = std::clamp(roughness, 0.0F, 1.0F) * static_cast<float>(mip_count_ - 1);
+        const auto lower = static_cast<size_t>(level);
+        const size_t upper = std::min(lower + 1, mip_count_ - 1);
+        const float f = level - static_cast<float>(lower);
+
+        out_color = _sampleLevel(probe, lower, lookup_direction) * (1.0F - f);
+        if(f > 0.0F) {
+            out_color += _sampleLevel(probe, upper, lookup_direction) * f;
+        }
+        return true;
+    }
+
+    size_t ReflectionProbes::_findProbe(const vec3& p) const noexcept
+    {
+        //the smallest probe is the one closest to the geometry around p
+        size_t probe = placements_.size();
+        float probe_volume = std::numeric_limits<float>::max();
+        for(size_t i = 0; i < placements_.size(); i++) {
+            if(baked_[i] == 0 || !contains(placements_[i].bounds, p)) {
+                continue;
+            }
+            const vec3 size = extent(placements_[i].bounds);
+            const float volume = size.x * size.y * size.z;
+            if(volume < probe_volume) {
+                probe = i;
+                probe_volume = volume;
+            }
+        }
+        return probe;
+    }
+
+    color ReflectionProbes::_sampleLevel(size_t probe, size_t level, const vec3& direction) const noexcept
+    {
+        size_t face = 0;
+        float u = 0.0F;
+        float v = 0.0F;
+        faceCoordinates(direction, face, u, v);
+
+        //bilinear inside of the face, texels at the edges are clamped
+        const size_t r = _levelResolution(level);
+        const float max_coordinate = static_cast<float>(r - 1);
+        const float x = std::clamp((((u * 0.5F) + 0.5F) * static_cast<float>(r)) - 0.5F, 0.0F, max_coordinate);
+        const float y = std::clamp((((v * 0.5F) + 0.5F) * static_cast<float>(r)) - 0.5F, 0.0F, max_coordinate);
+        const auto x0 = static_cast<size_t>(x);
+        const auto y0 = static_cast<size_t>(y);
+        const size_t x1 = std::min(x0 + 1, r - 1);
+        const size_t y1 = std::min(y0 + 1, r - 1);
+        const float fx = x - static_cast<float>(x0);
+        const float fy = y - static_cast<float>(y0);
+
+        const color* texels = &texels_[(probe * probe_stride_) + level_offsets_[level] + (face * r * r)];
+        const color top = (texels[(y0 * r) + x0] * (1.0F - fx)) + (texels[(y0 * r) + x1] * fx);
+        const color bottom = (texels[(y1 * r) + x0] * (1.0F - fx)) + (texels[(y1 * r) + x1] * fx);
+        return (top * (1.0F - fy)) + (bottom * fy);
+    }
+
+}
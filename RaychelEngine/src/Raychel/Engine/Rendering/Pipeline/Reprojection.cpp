@@ -0,0 +1,357 @@
+/**
+*\file Reprojection.cpp
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Definitions for the temporal reprojection functions found in Shading.h
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,#
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#include "Raychel/Engine/Rendering/Pipeline/Shading.h"
+
+namespace Raychel {
+
+    namespace {
+
+        constexpr std::uint64_t no_sample = std::numeric_limits<std::uint64_t>::max();
+
+        //positive floats keep their order when compared as integers
+        std::uint64_t packSample(float depth, std::uint32_t index) noexcept
+        {
+            std::uint32_t depth_bits = 0;
+            std::memcpy(&depth_bits, &depth, sizeof(depth_bits));
+            return (static_cast<std::uint64_t>(depth_bits) << 32U) | index;
+        }
+
+        float unpackDepth(std::uint64_t packed) noexcept
+        {
+            const auto depth_bits = static_cast<std::uint32_t>(packed >> 32U);
+            float depth = 0;
+            std::memcpy(&depth, &depth_bits, sizeof(depth));
+            return depth;
+        }
+
+        std::uint32_t unpackIndex(std::uint64_t packed) noexcept
+        {
+            return static_cast<std::uint32_t>(packed);
+        }
+
+        void atomicMin(std::atomic<std::uint64_t>& target, std::uint64_t value) noexcept
+        {
+            std::uint64_t current = target.load(std::memory_order_relaxed);
+            while(value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            }
+        }
+
+    }
+
+    void RaymarchRenderer::_reproject(const FramebufferSpan& output_texture)
+    {
+        std::fill(history_source_.begin(), history_source_.end(), no_history);
+        std::fill(depth_hints_.begin(), depth_hints_.end(), 0.0F);
+
+        if(!history_valid_) {
+            return;
+        }
+
+        //every cell has to be cleared before any tile scatters into it
+        workers_.parallelFor(tiles_.size(), [&](size_t tile_index, size_t /*worker_index*/) {
+            const Tile& tile = tiles_[tile_index];
+            for(size_t y = tile.origin.y; y < tile.origin.y + tile.size.y; y++) {
+                for(size_t x = tile.origin.x; x < tile.origin.x + tile.size.x; x++) {
+                    reprojected_samples_[(y * output_size_.x) + x].store(no_sample, std::memory_order_relaxed);
+                }
+            }
+        });
+
+        //scatter the samples of the last frame into the current one. Background samples are infinitely far away.
+        //Samples of different tiles can land on the same pixel, which keeps the closest one no matter which tile comes first
+        workers_.parallelFor(tiles_.size(), [&](size_t tile_index, size_t /*worker_index*/) {
+            const Tile& tile = tiles_[tile_index];
+            for(size_t sample_y = tile.origin.y; sample_y < tile.origin.y + tile.size.y; sample_y++) {
+                for(size_t sample_x = tile.origin.x; sample_x < tile.origin.x + tile.size.x; sample_x++) {
+                    const size_t i = (sample_y * output_size_.x) + sample_x;
+                    const HistorySample& sample = history_[i];
+                    if(sample.age >= temporal_max_age_) {
+                        continue;
+                    }
+
+                    const vec3 direction = sample.object ? (sample.position - cam_data_.position) : sample.position;
+                    vec2 pixel;
+                    if(!_projectToPixel(direction, pixel)) {
+                        continue;
+                    }
+
+                    //pixels sample the ray through their top left corner, so the closest pixel is found by rounding
+                    const float x = std::floor(pixel.x + 0.5F);
+                    const float y = std::floor(pixel.y + 0.5F);
+                    if(x < 0.0F || y < 0.0F || x >= static_cast<float>(output_size_.x) || y >= static_cast<float>(output_size_.y)) {
+                        continue;
+                    }
+
+                    const float depth = sample.object ? mag(direction) : std::numeric_limits<float>::infinity();
+                    atomicMin(reprojected_samples_[(static_cast<size_t>(y) * output_size_.x) + static_cast<size_t>(x)], packSample(depth, static_cast<std::uint32_t>(i)));
+                }
+            }
+        });
+
+        if(temporal_) {
+            workers_.parallelFor(tiles_.size(), [&](size_t tile_index, size_t /*worker_index*/) {
+                _validateReprojection(tiles_[tile_index], output_texture);
+                //the background of reprojected pixels is shaded again
+                _flushShadingErrors(tile_index);
+            });
+        }
+
+        std::atomic_size_t seeded_pixel_count{0};
+        if(depth_seeding_) {
+            workers_.parallelFor(tiles_.size(), [&](size_t tile_index, size_t /*worker_index*/) {
+                seeded_pixel_count += _seedDepths(tiles_[tile_index]);
+            });
+        }
+
+        temporal_stats_.pixel_count = output_size_.x * output_size_.y;
+        temporal_stats_.reprojected_pixel_count = static_cast<size_t>(std::count_if(history_source_.begin(), history_source_.end(), [](std::uint32_t source) {
+            return source != no_history;
+        }));
+        temporal_stats_.seeded_pixel_count = seeded_pixel_count;
+
+        RAYCHEL_LOG("Reprojected ", temporal_stats_);
+    }
+
+    void RaymarchRenderer::_validateReprojection(const Tile& tile, const FramebufferSpan& output_texture) noexcept
+    {
+        const size_t x_end = tile.origin.x + tile.size.x;
+        const size_t y_end = tile.origin.y + tile.size.y;
+
+        for(size_t y = tile.origin.y; y < y_end; y++) {
+            for(size_t x = tile.origin.x; x < x_end; x++) {
+                const size_t index = (y * output_size_.x) + x;
+                const std::uint64_t packed = reprojected_samples_[index].load(std::memory_order_relaxed);
+                if(packed == no_sample) {
+                    continue;
+                }
+
+                const std::uint32_t source = unpackIndex(packed);
+                const HistorySample& sample = history_[source];
+
+                //reflections move across the surface when the camera moves, so these pixels are always raymarched again
+                if(sample.view_dependent) {
+                    continue;
+                }
+
+                //samples on depth or object discontinuities are raymarched again. They might belong to a surface that is
+                //occluded in the current frame, but whose occluder left a hole here, or to a silhouette that moved
+                const float depth = unpackDepth(packed);
+                const float tolerance = temporal_depth_tolerance_ * depth;
+
+                bool on_edge = false;
+                for(size_t ny = (y == 0 ? 0 : y - 1); ny <= std::min(y + 1, output_size_.y - 1) && !on_edge; ny++) {
+                    for(size_t nx = (x == 0 ? 0 : x - 1); nx <= std::min(x + 1, output_size_.x - 1); nx++) {
+                        const std::uint64_t neighbour = reprojected_samples_[(ny * output_size_.x) + nx].load(std::memory_order_relaxed);
+                        if(neighbour == no_sample) {
+                            continue;
+                        }
+                        if(history_[unpackIndex(neighbour)].object != sample.object || std::abs(unpackDepth(neighbour) - depth) > tolerance) {
+                            on_edge = true;
+                            break;
+                        }
+                    }
+                }
+                if(on_edge) {
+                    continue;
+                }
+
+                if(sample.object) {
+                    output_texture.store(index, sample.output);
+                    primary_samples_[index] = {sample.object, depth};
+                } else {
+                    //the background is cheap, so it is looked up again in the exact direction
+                    const vec3 direction = _getRayDirectionFromUV(_getRootRequest(static_cast<float>(x), static_cast<float>(y)).uv);
+                    output_texture.store(index, _backgroundFunction(direction).output);
+                    primary_samples_[index] = {nullptr, raymarch_data_.max_ray_depth};
+                }
+
+                history_source_[index] = source;
+            }
+        }
+    }
+
+    size_t RaymarchRenderer::_seedDepths(const Tile& tile) noexcept
+    {
+        for(size_t y = tile.origin.y; y < tile.origin.y + tile.size.y; y++) {
+            for(size_t x = tile.origin.x; x < tile.origin.x + tile.size.x; x++) {
+                const size_t index = (y * output_size_.x) + x;
+                if(_isReprojected(index)) {
+                    continue;
+                }
+
+                //the closest surface that was visible around the pixel. Holes might be disocclusions, so they get no hint
+                float min_depth = std::numeric_limits<float>::infinity();
+                bool complete = true;
+                for(size_t ny = (y == 0 ? 0 : y - 1); ny <= std::min(y + 1, output_size_.y - 1) && complete; ny++) {
+                    for(size_t nx = (x == 0 ? 0 : x - 1); nx <= std::min(x + 1, output_size_.x - 1); nx++) {
+                        const std::uint64_t neighbour = reprojected_samples_[(ny * output_size_.x) + nx].load(std::memory_order_relaxed);
+                        if(neighbour == no_sample) {
+                            complete = false;
+                            break;
+                        }
+                        min_depth = std::min(min_depth, unpackDepth(neighbour));
+                    }
+                }
+                if(!complete || std::isinf(min_depth)) {
+                    continue;
+                }
+
+                depth_hints_[index] = min_depth * (1.0F - temporal_seed_margin_);
+            }
+        }
+
+        //the last frame can't see geometry that is new in front of it, so the hints are only targets until a cone proves them
+        _clampDepthHints(tile, 0.0F);
+
+        size_t seeded_count = 0;
+        for(size_t y = tile.origin.y; y < tile.origin.y + tile.size.y; y++) {
+            for(size_t x = tile.origin.x; x < tile.origin.x + tile.size.x; x++) {
+                if(depth_hints_[(y * output_size_.x) + x] > 0.0F) {
+                    seeded_count++;
+                }
+            }
+        }
+
+        return seeded_count;
+    }
+
+    void RaymarchRenderer::_clampDepthHints(const Tile& rect, float start_depth) noexcept
+    {
+        float max_hint = 0.0F;
+        for(size_t y = rect.origin.y; y < rect.origin.y + rect.size.y; y++) {
+            for(size_t x = rect.origin.x; x < rect.origin.x + rect.size.x; x++) {
+                max_hint = std::max(max_hint, depth_hints_[(y * output_size_.x) + x]);
+            }
+        }
+
+        //every ray of rect is known to be empty up to start_depth
+        if(max_hint <= start_depth) {
+            return;
+        }
+
+        const float depth = _coneMarch(rect, start_depth, max_hint);
+        if(depth >= max_hint) {
+            return;
+        }
+
+        if(rect.size.x <= min_cone_size && rect.size.y <= min_cone_size) {
+            for(size_t y = rect.origin.y; y < rect.origin.y + rect.size.y; y++) {
+                for(size_t x = rect.origin.x; x < rect.origin.x + rect.size.x; x++) {
+                    float& hint = depth_hints_[(y * output_size_.x) + x];
+                    hint = std::min(hint, depth);
+                }
+            }
+            return;
+        }
+
+        //narrower cones get further, and the quadrants can start where the cone of rect stopped
+        for(const auto& quadrant : splitIntoQuadrants(rect)) {
+            if(quadrant.size.x != 0 && quadrant.size.y != 0) {
+                _clampDepthHints(quadrant, depth);
+            }
+        }
+    }
+
+    void RaymarchRenderer::_updateHistory(const FramebufferView& output_texture)
+    {
+        //fresh samples start at different ages, so they do not all expire in the same frame
+        const std::uint32_t age_spread = std::max(temporal_max_age_ / 2U, 1U);
+
+        workers_.parallelFor(tiles_.size(), [&](size_t tile_index, size_t /*worker_index*/) {
+            const Tile& tile = tiles_[tile_index];
+
+            for(size_t y = tile.origin.y; y < tile.origin.y + tile.size.y; y++) {
+                for(size_t x = tile.origin.x; x < tile.origin.x + tile.size.x; x++) {
+                    const size_t index = (y * output_size_.x) + x;
+                    HistorySample& next = next_history_[index];
+
+                    if(history_source_[index] != no_history) {
+                        //keep the original world space position, so repeated reprojection does not drift
+                        next = history_[history_source_[index]];
+                        next.age++;
+                    } else {
+                        const PrimarySample& sample = primary_samples_[index];
+                        const vec3 direction = _getRayDirectionFromUV(_getRootRequest(static_cast<float>(x), static_cast<float>(y)).uv);
+
+                        next.position = sample.object ? (cam_data_.position + (direction * sample.depth)) : direction;
+                        next.object = sample.object;
+                        next.view_dependent = sample.view_dependent;
+                        next.age = static_cast<std::uint32_t>((x * 5U) + (y * 3U)) % age_spread;
+                    }
+                    next.output = output_texture.load(index);
+                }
+            }
+        });
+
+        std::swap(history_, next_history_);
+        history_valid_ = !frame_failed_;
+    }
+
+    bool RaymarchRenderer::_projectToPixel(const vec3& direction, vec2& out_pixel) const noexcept
+    {
+        const float z = dot(direction, cam_data_.forward);
+        if(z <= 0.0F) {
+            return false;
+        }
+
+        //inverse of _getRayDirectionFromUV() and _getRootRequest()
+        vec2 uv{(dot(direction, cam_data_.right) * cam_data_.zoom) / z, (dot(direction, cam_data_.up) * cam_data_.zoom) / z};
+
+        if(aspect_ratio > 1.0) {
+            uv.x /= aspect_ratio;
+        } else {
+            uv.y *= aspect_ratio;
+        }
+
+        out_pixel = vec2{(uv.x + 0.5F) * static_cast<float>(output_size_.x), (uv.y + 0.5F) * static_cast<float>(output_size_.y)};
+        return true;
+    }
+
+    bool RaymarchRenderer::_isReprojected(const Tile& rect) const noexcept
+    {
+        if(!temporal_) {
+            return false;
+        }
+
+        for(size_t y = rect.origin.y; y < rect.origin.y + rect.size.y; y++) {
+            for(size_t x = rect.origin.x; x < rect.origin.x + rect.size.x; x++) {
+                if(history_source_[(y * output_size_.x) + x] == no_history) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Raychel/Engine/Rendering/Pipeline/SdfCache.h"
+#include "Raychel/Core/Half.h"
+#include "Raychel/Engine/Objects/Interface.h"
+
+namespace Raychel {
+
+    namespace {
+
+        //most coarse cells along the longest axis of the scene
+        constexpr size_t max_coarse_cells = 64;
+
+        //fraction of the memory budget the coarse grid may use. The rest goes to the bricks
+        constexpr size_t coarse_budget_divisor = 4;
+
+        constexpr float sqrt3 = 1.7320508F;
+
+        constexpr size_t samples_per_brick = SdfCache::brick_samples * SdfCache::brick_samples * SdfCache::brick_samples;
+
+        float lerp(float a, float b, float t) noexcept
+        {
+            return a + ((b - a) * t);
+        }
+
+        //c is indexed x + 2y + 4z
+        float trilerp(const std::array<float, 8>& c, const vec3& t) noexcept
+        {
+            const float x00 = lerp(c[0], c[1], t.x);
+            const float x10 = lerp(c[2], c[3], t.x);
+            const float x01 = lerp(c[4], c[5], t.x);
+            const float x11 = lerp(c[6], c[7], t.x);
+            return lerp(lerp(x00, x10, t.y), lerp(x01, x11, t.y), t.z);
+        }
+
+        //split x into a cell index in [0; count) and the position inside of that cell
+        std::pair<size_t, float> splitCoordinate(float x, size_t count) noexcept
+        {
+            const auto index = std::min(static_cast<size_t>(std::max(x, 0.0F)), count - 1);
+            return {index, x - static_cast<float>(index)};
+        }
+
+    }
+
+    std::ostream& operator<<(std::ostream& os, const SdfCacheStats& stats)
+    {
+        return os << "{ format: " << (stats.format == SdfCacheFormat::fp16 ? "fp16" : "unorm8") << ", grid: " << stats.grid_size[0] << "x"
+                  << stats.grid_size[1] << "x" << stats.grid_size[2] << ", cell size: " << stats.cell_size << ", bricks: " << stats.brick_count << "/"
+                  << stats.candidate_bricks << ", memory: " << (stats.memory_usage / 1024) << "KiB }";
+    }
+
+    bool SdfCache::bake(const ObjectBvh& bvh, float max_distance, SdfCacheFormat format, size_t memory_budget, WorkStealingPool& workers, const CancelFunction& cancelled)
+    {
+        clear();
+
+        //unbounded objects could be anywhere, so no part of the scene could be cached
+        if(bvh.stats().num_unbounded != 0 || isEmpty(bvh.bounds())) {
+            RAYCHEL_LOG("Not baking SDF cache because the scene contains unbounded objects or no objects at all");
+            return false;
+        }
+
+        format_ = format;
+        max_distance_ = max_distance;
+        object_bounds_ = bvh.bounds();
+
+        //choose the finest coarse grid that fits into its part of the budget. One cell of padding on each side keeps surfaces off the border
+        const vec3 size = extent(object_bounds_);
+        cell_size_ = std::max({size.x, size.y, size.z, 1e-3F}) / static_cast<float>(max_coarse_cells);
+        size_t coarse_bytes = 0;
+        while(true) {
+            for(size_t axis = 0; axis < 3; axis++) {
+                const float axis_size = axis == 0 ? size.x : (axis == 1 ? size.y : size.z);
+                grid_size_[axis] = static_cast<size_t>(std::ceil(axis_size / cell_size_)) + 2;
+            }
+            const size_t cell_count = grid_size_[0] * grid_size_[1] * grid_size_[2];
+            const size_t vertex_count = (grid_size_[0] + 1) * (grid_size_[1] + 1) * (grid_size_[2] + 1);
+            coarse_bytes = (vertex_count * sizeof(float)) + (cell_count * sizeof(std::uint32_t));
+
+            if(coarse_bytes <= memory_budget / coarse_budget_divisor) {
+                break;
+            }
+
+            //the padding alone needs 3 cells per axis
+            if(cell_count <= 27) {
+                Logger::warn("Memory budget of ", memory_budget, " bytes is too small for an SDF cache!\n");
+                clear();
+                return false;
+            }
+            cell_size_ *= 1.25F;
+        }
+
+        bounds_.min = object_bounds_.min - vec3{cell_size_, cell_size_, cell_size_};
+        bounds_.max = bounds_.min + (vec3{static_cast<float>(grid_size_[0]), static_cast<float>(grid_size_[1]), static_cast<float>(grid_size_[2])} * cell_size_);
+
+        //exact distances at the coarse vertices, one z slice per job
+        coarse_.resize((grid_size_[0] + 1) * (grid_size_[1] + 1) * (grid_size_[2] + 1));
+        const auto is_cancelled = [&cancelled] {
+            return cancelled && cancelled();
+        };
+        workers.parallelFor(grid_size_[2] + 1, [&](size_t z, size_t /*worker_index*/) {
+            if(is_cancelled()) {
+                return;
+            }
+            for(size_t y = 0; y <= grid_size_[1]; y++) {
+                for(size_t x = 0; x <= grid_size_[0]; x++) {
+                    const vec3 p = bounds_.min + (vec3{static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)} * cell_size_);
+                    coarse_[_vertexIndex(x, y, z)] = bvh.distance(p, max_distance_);
+                }
+            }
+        });
+
+        if(is_cancelled()) {
+            clear();
+            return false;
+        }
+
+        //every point of a cell is at most half a cell diagonal away from one of its corners. Cells with all corners further away than
+        //that from a surface can't contain one. Cells up to one diagonal away still get a brick so rays can approach surfaces quickly
+        struct Candidate
+        {
+            size_t cell;
+            float closest_corner;
+        };
+        std::vector<Candidate> candidates;
+        for(size_t z = 0; z < grid_size_[2]; z++) {
+            for(size_t y = 0; y < grid_size_[1]; y++) {
+                for(size_t x = 0; x < grid_size_[0]; x++) {
+                    float min_corner = std::numeric_limits<float>::max();
+                    float max_corner = std::numeric_limits<float>::lowest();
+                    for(size_t corner = 0; corner < 8; corner++) {
+                        const float d = coarse_[_vertexIndex(x + (corner & 1U), y + ((corner >> 1U) & 1U), z + ((corner >> 2U) & 1U))];
+                        min_corner = std::min(min_corner, d);
+                        max_corner = std::max(max_corner, d);
+                    }
+
+                    //cells that are completely inside of an object are never marched through
+                    const bool inside = max_corner < -(cell_size_ * sqrt3 * 0.5F);
+                    if(!inside && (min_corner < cell_size_ * sqrt3)) {
+                        candidates.push_back({_cellIndex(x, y, z), std::max(min_corner, 0.0F)});
+                    }
+                }
+            }
+        }
+
+        //keep the bricks closest to a surface if the budget does not allow all of them
+        const size_t brick_bytes = samples_per_brick * (format_ == SdfCacheFormat::fp16 ? sizeof(std::uint16_t) : sizeof(std::uint8_t));
+        const size_t brick_count = std::min(candidates.size(), (memory_budget - coarse_bytes) / brick_bytes);
+        stats_.candidate_bricks = candidates.size();
+        std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            return a.closest_corner < b.closest_corner;
+        });
+        candidates.resize(brick_count);
+
+        brick_index_.assign(grid_size_[0] * grid_size_[1] * grid_size_[2], no_brick);
+        for(size_t i = 0; i < candidates.size(); i++) {
+            brick_index_[candidates[i].cell] = static_cast<std::uint32_t>(i);
+        }
+
+        brick_spacing_ = cell_size_ / static_cast<float>(brick_samples - 1);
+        brick_range_ = cell_size_ * 2.0F;
+        if(format_ == SdfCacheFormat::fp16) {
+            fp16_bricks_.resize(brick_count * samples_per_brick);
+        } else {
+            unorm8_bricks_.resize(brick_count * samples_per_brick);
+        }
+
+        //Samples are clamped to brick_range_, so only objects that can get closer than that to the cell have to be evaluated
+        const float reach = brick_range_ + (cell_size_ * sqrt3 * 0.5F);
+        std::vector<std::vector<const IRaymarchable*>> nearby_objects(workers.size(), std::vector<const IRaymarchable*>(64));
+
+        workers.parallelFor(candidates.size(), [&](size_t brick, size_t worker_index) {
+            if(is_cancelled()) {
+                return;
+            }
+            const size_t cell = candidates[brick].cell;
+            const size_t cx = cell % grid_size_[0];
+            const size_t cy = (cell / grid_size_[0]) % grid_size_[1];
+            const size_t cz = cell / (grid_size_[0] * grid_size_[1]);
+            const vec3 cell_min = bounds_.min + (vec3{static_cast<float>(cx), static_cast<float>(cy), static_cast<float>(cz)} * cell_size_);
+            const vec3 cell_center = cell_min + (vec3{cell_size_, cell_size_, cell_size_} * 0.5F);
+
+            auto& nearby = nearby_objects[worker_index];
+            size_t nearby_count = bvh.objectsWithin(cell_center, reach, nearby.data(), nearby.size());
+            if(nearby_count > nearby.size()) {
+                nearby.resize(nearby_count);
+                nearby_count = bvh.objectsWithin(cell_center, reach, nearby.data(), nearby.size());
+            }
+
+            for(size_t z = 0; z < brick_samples; z++) {
+                for(size_t y = 0; y < brick_samples; y++) {
+                    for(size_t x = 0; x < brick_samples; x++) {
+                        const vec3 p = cell_min + (vec3{static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)} * brick_spacing_);
+
+                        float d = brick_range_;
+                        for(size_t i = 0; i < nearby_count; i++) {
+                            d = std::min(d, nearby[i]->eval(p));
+                        }
+                        _storeBrickSample(brick, x, y, z, d);
+                    }
+                }
+            }
+        });
+
+        if(is_cancelled()) {
+            clear();
+            return false;
+        }
+
+        //Trilinear interpolation of a 1-Lipschitz function is off by at most the weighted distance to the corners, which is at most
+        //half a cell diagonal. Quantization adds at most half a quantization step
+        coarse_margin_ = cell_size_ * sqrt3 * 0.5F;
+        const float quantization_error = format_ == SdfCacheFormat::fp16 ? (brick_range_ / 2048.0F) : (brick_range_ / 255.0F);
+        brick_margin_ = (brick_spacing_ * sqrt3 * 0.5F) + quantization_error;
+
+        stats_.format = format_;
+        stats_.grid_size = grid_size_;
+        stats_.cell_size = cell_size_;
+        stats_.brick_count = brick_count;
+        stats_.memory_usage = coarse_bytes + (brick_count * brick_bytes);
+
+        baked_ = true;
+
+        RAYCHEL_LOG("Baked SDF cache: ", stats_);
+        return true;
+    }
+
+    void SdfCache::clear() noexcept
+    {
+        baked_ = false;
+        coarse_ = {};
+        brick_index_ = {};
+        fp16_bricks_ = {};
+        unorm8_bricks_ = {};
+        stats_ = {};
+    }
+
+    float SdfCache::distance(const vec3& p) const noexcept
+    {
+        RAYCHEL_ASSERT(baked_);
+
+        //the grid is padded by one cell, so outside of it the distance to the objects is not too pessimistic
+        if(!contains(bounds_, p)) {
+            return std::min(Raychel::distance(object_bounds_, p), max_distance_);
+        }
+
+        const vec3 local = (p - bounds_.min) / cell_size_;
+        const auto [cx, tx] = splitCoordinate(local.x, grid_size_[0]);
+        const auto [cy, ty] = splitCoordinate(local.y, grid_size_[1]);
+        const auto [cz, tz] = splitCoordinate(local.z, grid_size_[2]);
+
+        std::array<float, 8> corners;
+
+        const std::uint32_t brick = brick_index_[_cellIndex(cx, cy, cz)];
+        if(brick != no_brick) {
+            constexpr size_t intervals = brick_samples - 1;
+            const auto [bx, btx] = splitCoordinate(tx * intervals, intervals);
+            const auto [by, bty] = splitCoordinate(ty * intervals, intervals);
+            const auto [bz, btz] = splitCoordinate(tz * intervals, intervals);
+
+            for(size_t corner = 0; corner < 8; corner++) {
+                corners[corner] = _brickSample(brick, bx + (corner & 1U), by + ((corner >> 1U) & 1U), bz + ((corner >> 2U) & 1U));
+            }
+            return trilerp(corners, vec3{btx, bty, btz}) - brick_margin_;
+        }
+
+        for(size_t corner = 0; corner < 8; corner++) {
+            corners[corner] = coarse_[_vertexIndex(cx + (corner & 1U), cy + ((corner >> 1U) & 1U), cz + ((corner >> 2U) & 1U))];
+        }
+        return trilerp(corners, vec3{tx, ty, tz}) - coarse_margin_;
+    }
+
+    float SdfCache::_brickSample(size_t brick, size_t x, size_t y, size_t z) const noexcept
+    {
+        const size_t index = (brick * samples_per_brick) + x + (brick_samples * (y + (brick_samples * z)));
+        if(format_ == SdfCacheFormat::fp16) {
+            return halfToFloat(fp16_bricks_[index]);
+        }
+        return (static_cast<float>(unorm8_bricks_[index]) * (2.0F * brick_range_ / 255.0F)) - brick_range_;
+    }
+
+    void SdfCache::_storeBrickSample(size_t brick, size_t x, size_t y, size_t z, float value) noexcept
+    {
+        const size_t index = (brick * samples_per_brick) + x + (brick_samples * (y + (brick_samples * z)));
+        const float clamped = std::clamp(value, -brick_range_, brick_range_);
+        if(format_ == SdfCacheFormat::fp16) {
+            fp16_bricks_[index] = floatToHalf(clamped);
+        } else {
+            unorm8_bricks_[index] = static_cast<std::uint8_t>(std::lround((clamped + brick_range_) * (255.0F / (2.0F * brick_range_))));
+        }
+    }
+
+}
@@ -1,7 +1,3 @@
-#include <algorithm>
-#include <execution>
-#include <functional>
-
 #include "Raychel/Engine/Objects/Interface.h"
 #include "Raychel/Engine/Rendering/Pipeline/Shading.h"
 #include "Raychel/Engine/Interface/Camera.h"
@@ -15,50 +11,269 @@ namespace Raychel {
     {
         RAYCHEL_LOG("Setting render output size to ", new_size, " (aspect ratio of ", (static_cast<float>(new_size.x)/new_size.y), ")");
         output_size_ = new_size;
-        _refillRequestBuffer();
+        aspect_ratio = static_cast<float>(output_size_.x) / output_size_.y;
+        _refillTileBuffer();
+        _refillSampleBuffers();
+    }
+
+    void RaymarchRenderer::setRenderOptions(const RenderOptions& options)
+    {
+        RAYCHEL_ASSERT(options.tile_size != 0);
+
+        if(options.tile_size != tile_size_) {
+            tile_size_ = options.tile_size;
+            _refillTileBuffer();
+        }
+
+        packet_marching_ = options.use_ray_packets;
+        if(options.use_wavefront != wavefront_) {
+            wavefront_ = options.use_wavefront;
+            _refillWavefrontBuffers();
+        }
+        cone_prepass_ = options.use_cone_prepass;
+        progressive_ = options.progressive;
+        framebuffer_format_ = options.framebuffer_format;
+
+        RAYCHEL_ASSERT(options.aa_grid_size != 0 && options.aa_grid_size <= max_aa_grid_size);
+        aa_depth_threshold_ = options.aa_depth_threshold;
+        aa_luminance_threshold_ = options.aa_luminance_threshold;
+        aa_grid_size_ = options.aa_grid_size;
+
+        RAYCHEL_ASSERT(options.temporal_max_age != 0 && options.temporal_max_age < no_history);
+        temporal_depth_tolerance_ = options.temporal_depth_tolerance;
+        temporal_max_age_ = static_cast<std::uint32_t>(options.temporal_max_age);
+
+        RAYCHEL_ASSERT(options.temporal_seed_margin >= 0.0F && options.temporal_seed_margin < 1.0F);
+        temporal_seed_margin_ = options.temporal_seed_margin;
+
+        if(options.doAA != do_aa_ || options.temporal_reprojection != temporal_ || options.temporal_depth_seeding != depth_seeding_) {
+            do_aa_ = options.doAA;
+            temporal_ = options.temporal_reprojection;
+            depth_seeding_ = options.temporal_depth_seeding;
+            _refillSampleBuffers();
+        }
+
+        if(options.use_sdf_cache != use_sdf_cache_ || options.sdf_cache_format != sdf_cache_format_ || options.sdf_cache_memory_budget != sdf_cache_budget_) {
+            use_sdf_cache_ = options.use_sdf_cache;
+            sdf_cache_format_ = options.sdf_cache_format;
+            sdf_cache_budget_ = options.sdf_cache_memory_budget;
+            sdf_cache_.clear();
+            sdf_cache_dirty_ = true;
+        }
+
+        RAYCHEL_ASSERT(options.light_cutoff > 0.0F);
+        if(options.light_cutoff != light_cutoff_ || options.light_samples != light_samples_) {
+            light_cutoff_ = options.light_cutoff;
+            light_samples_ = options.light_samples;
+            if(lamps_) {
+                _compileLights();
+                history_valid_ = false;
+            }
+        }
+
+        RAYCHEL_ASSERT(options.irradiance_probe_spacing > 0.0F && options.irradiance_max_probes >= 8 && options.irradiance_probe_rays != 0);
+        if(options.use_irradiance_volume != use_irradiance_volume_ || options.irradiance_probe_spacing != irradiance_probe_spacing_ ||
+           options.irradiance_max_probes != irradiance_max_probes_ || options.irradiance_probe_rays != irradiance_probe_rays_) {
+            use_irradiance_volume_ = options.use_irradiance_volume;
+            irradiance_probe_spacing_ = options.irradiance_probe_spacing;
+            irradiance_max_probes_ = options.irradiance_max_probes;
+            irradiance_probe_rays_ = options.irradiance_probe_rays;
+            irradiance_volume_.clear();
+            irradiance_layout_dirty_ = true;
+            history_valid_ = false;
+        }
+        irradiance_update_radius_ = options.irradiance_update_radius;
+
+        RAYCHEL_ASSERT(options.reflection_probe_resolution != 0 && options.reflection_probe_mip_count != 0);
+        if(options.use_reflection_probes != use_reflection_probes_ || options.reflection_probe_resolution != reflection_probe_resolution_ ||
+           options.reflection_probe_mip_count != reflection_probe_mip_count_) {
+            use_reflection_probes_ = options.use_reflection_probes;
+            reflection_probe_resolution_ = options.reflection_probe_resolution;
+            reflection_probe_mip_count_ = options.reflection_probe_mip_count;
+            reflection_probes_.clear();
+            reflection_layout_dirty_ = true;
+            history_valid_ = false;
+        }
+        if(options.reflection_probe_min_roughness != reflection_probe_min_roughness_) {
+            reflection_probe_min_roughness_ = options.reflection_probe_min_roughness;
+            history_valid_ = false;
+        }
+        reflection_probe_update_radius_ = options.reflection_probe_update_radius;
+
+        RAYCHEL_ASSERT(options.ao_distance > 0.0F && options.ao_field_resolution >= 2);
+        if(options.ambient_occlusion != ambient_occlusion_ || options.ao_distance != ao_distance_ || options.ao_field_resolution != ao_field_resolution_) {
+            ambient_occlusion_ = options.ambient_occlusion;
+            ao_distance_ = options.ao_distance;
+            ao_field_resolution_ = options.ao_field_resolution;
+            ao_field_.clear();
+            ao_field_layout_dirty_ = true;
+            //the probes are lit with the occlusion
+            irradiance_layout_dirty_ = true;
+            reflection_layout_dirty_ = true;
+            history_valid_ = false;
+        }
+
+        RAYCHEL_ASSERT(options.over_relaxation >= 1.0F && options.over_relaxation < 2.0F);
+        marching_strategy_ = options.marching_strategy;
+        raymarch_data_.over_relaxation = (marching_strategy_ == MarchingStrategy::over_relaxed) ? options.over_relaxation : 1.0F;
     }
 
     void RaymarchRenderer::setSceneData(const not_null<std::vector<IRaymarchable_p>*> objects,
+                                        const not_null<std::vector<SdLamp_p>*> lamps,
                                         const not_null<CubeTexture<color>*> background_texture)
     {
         objects_ = objects;
+        lamps_ = lamps;
         background_texture_ = background_texture;
 
+        _compileScene();
+
         set_scene_callback_renderer();
     }
 
+    void RaymarchRenderer::setReflectionProbes(const not_null<const std::vector<ReflectionProbePlacement>*> placements)
+    {
+        reflection_probe_placements_ = placements;
+        reflection_layout_dirty_ = true;
+        history_valid_ = false;
+    }
+
+    void RaymarchRenderer::_compileScene()
+    {
+        primitives_.clear();
+        compiled_objects_.clear();
+
+        for(const auto obj : *objects_) {
+            if(!obj->compileInto(primitives_)) {
+                compiled_objects_.push_back(obj);
+            }
+        }
+        primitives_.finalize(compiled_objects_);
+
+        bvh_.build(compiled_objects_, workers_);
+
+        _compileLights();
+
+        sdf_cache_.clear();
+        sdf_cache_dirty_ = true;
+        irradiance_layout_dirty_ = true;
+        reflection_layout_dirty_ = true;
+        ao_field_layout_dirty_ = true;
+        history_valid_ = false;
+    }
+
+    void RaymarchRenderer::invalidateScene()
+    {
+        RAYCHEL_ASSERT(objects_);
+        _compileScene();
+    }
+
+    void RaymarchRenderer::invalidateScene(const BoundingBox& changed_bounds)
+    {
+        RAYCHEL_ASSERT(objects_);
+        _compileScene();
+
+        //the probes can stay where they are as long as the scene did not grow out of them
+        if(irradiance_volume_.isBaked() && !isEmpty(bvh_.bounds()) && contains(irradiance_volume_.bounds(), bvh_.bounds().min) && contains(irradiance_volume_.bounds(), bvh_.bounds().max)) {
+            irradiance_layout_dirty_ = false;
+            irradiance_volume_.markDirty(changed_bounds, irradiance_update_radius_);
+        }
+
+        if(ao_field_.isBaked() && !isEmpty(bvh_.bounds()) && contains(ao_field_.bounds(), bvh_.bounds().min) && contains(ao_field_.bounds(), bvh_.bounds().max)) {
+            ao_field_layout_dirty_ = false;
+            //objects occlude samples up to ao_distance_ away from them
+            const vec3 padding{ao_distance_, ao_distance_, ao_distance_};
+            ao_field_.markDirty(BoundingBox{changed_bounds.min - padding, changed_bounds.max + padding});
+        }
+
+        //the probe positions do not depend on the objects
+        if(reflection_probe_placements_ && reflection_probes_.probeCount() == reflection_probe_placements_->size()) {
+            reflection_layout_dirty_ = false;
+            reflection_probes_.markDirty(changed_bounds, reflection_probe_update_radius_);
+        }
+    }
+
+    void RaymarchRenderer::_bakeSdfCache()
+    {
+        sdf_cache_dirty_ = false;
+        if(use_sdf_cache_ && !sdf_cache_.bake(bvh_, 10.0F, sdf_cache_format_, sdf_cache_budget_, workers_, _cancelFunction())) {
+            //a cancelled bake is tried again with the next frame
+            sdf_cache_dirty_ = _isCancelled();
+        }
+    }
+
     void RaymarchRenderer::set_scene_callback_renderer() {
         for(const auto& obj : *objects_) {
             obj->onRendererAttached(this);
         }
     }
 
-    void RaymarchRenderer::_refillRequestBuffer()
+    void RaymarchRenderer::_refillTileBuffer()
     {
-        RAYCHEL_LOG("Refilling request buffer to ", output_size_.x * output_size_.y, " pixels");
-
-        requests_.clear();
-        size_t request_count = output_size_.x * output_size_.y;
-        requests_.reserve(request_count);
+        tiles_ = makeTiles(output_size_, tile_size_);
+        tile_completed_.assign(tiles_.size(), 0U);
+        tile_errors_.assign(tiles_.size(), ShadingErrorLog{});
+        _refillWavefrontBuffers();
 
-        aspect_ratio = static_cast<float>(output_size_.x) / output_size_.y;
+        RAYCHEL_LOG("Split output into ", tiles_.size(), " tiles of ", tile_size_, "x", tile_size_, " pixels for ", workers_.size(), " workers");
+    }
 
-        for(auto i = 0U; i < output_size_.y; i++) {
-            for(auto j = 0U; j < output_size_.x; j++) {
-                requests_.push_back(_getRootRequest(j, i));
-            }
+    void RaymarchRenderer::_refillSampleBuffers()
+    {
+        const size_t pixel_count = output_size_.x * output_size_.y;
+
+        primary_samples_.clear();
+        edge_mask_.clear();
+        history_.clear();
+        next_history_.clear();
+        history_source_.clear();
+        //atomics cannot be moved, so this buffer is replaced instead of resized
+        reprojected_samples_ = std::vector<std::atomic<std::uint64_t>>{};
+        depth_hints_.clear();
+        history_valid_ = false;
+
+        if(_recordsPrimarySamples()) {
+            primary_samples_.resize(pixel_count);
+        }
+        if(do_aa_) {
+            edge_mask_.resize(pixel_count);
+        }
+        if(_keepsHistory()) {
+            history_.resize(pixel_count);
+            next_history_.resize(pixel_count);
+            history_source_.resize(pixel_count, no_history);
+            reprojected_samples_ = std::vector<std::atomic<std::uint64_t>>(pixel_count);
         }
+        if(depth_seeding_) {
+            depth_hints_.resize(pixel_count);
+        }
+
+        primary_samples_.shrink_to_fit();
+        edge_mask_.shrink_to_fit();
+        history_.shrink_to_fit();
+        next_history_.shrink_to_fit();
+        history_source_.shrink_to_fit();
+        depth_hints_.shrink_to_fit();
+    }
 
-        //in case window got smaller
-        requests_.shrink_to_fit();
+    RaymarchRenderer::PixelRow RaymarchRenderer::_getPixelRow(size_t y) const noexcept
+    {
+        //uv.x grows linearly along the row, see _getRootRequest()
+        const RaymarchData first = _getRootRequest(0.0F, static_cast<float>(y));
+        const float uv_step = ((aspect_ratio > 1.0) ? aspect_ratio : 1.0F) / static_cast<float>(output_size_.x);
+
+        return {
+            (cam_data_.forward * cam_data_.zoom) + (cam_data_.right * first.uv.x) + (cam_data_.up * first.uv.y),
+            cam_data_.right * uv_step
+        };
     }
 
-    RaymarchData RaymarchRenderer::_getRootRequest(size_t x, size_t y) const
+    RaymarchData RaymarchRenderer::_getRootRequest(float x, float y) const
     {
         //generate UVs in range [-0.5; 0.5]
 
-        float dx = ( static_cast<float>(x) / (output_size_.x) ) - 0.5F;
-        float dy = ( static_cast<float>(y) / (output_size_.y) ) - 0.5F;
+        float dx = ( x / (output_size_.x) ) - 0.5F;
+        float dy = ( y / (output_size_.y) ) - 0.5F;
 
         //handle non-square aspect ratios
         if(aspect_ratio > 1.0)
@@ -73,36 +288,357 @@ namespace Raychel {
 
 #pragma region Render functions
 
-    std::optional<Texture<RenderResult>> RaymarchRenderer::renderImage(const Camera& cam)
+    std::ostream& operator<<(std::ostream& os, const MarchStats& stats)
     {
-        _setupCamData(cam);
+        return os << "{ strategy: " << (stats.strategy == MarchingStrategy::classic ? "classic" : "over-relaxed") << ", rays: " << stats.ray_count
+                  << ", steps: " << stats.step_count << ", backtracks: " << stats.backtrack_count << ", cached steps: " << stats.cached_step_count << ", average steps: " << stats.averageSteps() << " }";
+    }
+
+    std::ostream& operator<<(std::ostream& os, const AntiAliasingStats& stats)
+    {
+        return os << "{ pixels: " << stats.pixel_count << ", refined: " << stats.refined_pixel_count << " (" << (stats.refinedFraction() * 100.0) << "%)"
+                  << ", subsamples: " << stats.subsample_count << " }";
+    }
 
-        Texture<RenderResult> output{output_size_};
+    std::ostream& operator<<(std::ostream& os, const TemporalStats& stats)
+    {
+        return os << "{ pixels: " << stats.pixel_count << ", reprojected: " << stats.reprojected_pixel_count << " (" << (stats.reprojectedFraction() * 100.0) << "%)"
+                  << ", seeded: " << stats.seeded_pixel_count << " }";
+    }
 
-        if(!_renderToTexture(output)){
-            Logger::error("Image rendering failed with error: ", current_exception_.what() , "at (", current_exception_.origin(), ")!\n");
-            //TODO: customizable error handling
+    std::ostream& operator<<(std::ostream& os, const LightingStats& stats)
+    {
+        return os << "{ points: " << stats.point_count << ", culled lights: " << stats.culled_light_count << ", shadow rays: " << stats.shadow_ray_count
+                  << " (" << stats.shadowRaysPerPoint() << " per point), shadow steps: " << stats.shadow_step_count << ", occluded: " << stats.occluded_ray_count << " }";
+    }
+
+    std::optional<Framebuffer> RaymarchRenderer::renderImage(const Camera& cam)
+    {
+        Framebuffer output{output_size_, framebuffer_format_};
+
+        if(!renderImage(cam, output)) {
             return std::nullopt;
         }
 
         return output;
     }
 
-    bool RaymarchRenderer::_renderToTexture(Texture<RenderResult>& output_texture) const
+    bool RaymarchRenderer::renderImage(const Camera& cam, const FramebufferSpan& output)
+    {
+        return renderImage(cam, output, FrameBudget{}).status == FrameStatus::complete;
+    }
+
+    FrameResult RaymarchRenderer::renderImage(const Camera& cam, const FramebufferSpan& output, const FrameBudget& budget)
+    {
+        RAYCHEL_ASSERT(output.size() == output_size_);
+
+        frame_budget_ = budget;
+        cancelled_ = false;
+        completed_tile_count_ = 0;
+        std::fill(tile_completed_.begin(), tile_completed_.end(), 0U);
+        frame_failed_ = false;
+        bake_errors_.clear();
+        //frames that skip a bake report 0 baked probes and blocks
+        ao_field_.clearUpdateStats();
+        irradiance_volume_.clearUpdateStats();
+        reflection_probes_.clearUpdateStats();
+
+        _setupCamData(cam);
+
+        if(sdf_cache_dirty_ && !_isCancelled()) {
+            _bakeSdfCache();
+        }
+
+        //the probes are lit with the occlusion, so it is baked first
+        if(ambient_occlusion_ == AmbientOcclusionMode::baked && !_isCancelled()) {
+            _updateAmbientOcclusionField();
+        }
+
+        if(use_irradiance_volume_ && !_isCancelled()) {
+            _updateIrradianceVolume();
+        }
+
+        if(use_reflection_probes_ && !_isCancelled()) {
+            _updateReflectionProbes();
+        }
+
+        if(!bake_errors_.empty()) {
+            Logger::warn("Shading reported errors while baking: ", bake_errors_, '\n');
+        }
+
+        //whatever was not baked yet stays dirty for the next frame
+        if(_isCancelled()) {
+            RAYCHEL_LOG("Frame was cancelled while baking");
+            return {FrameStatus::cancelled, 0};
+        }
+
+        if(!_renderToFramebuffer(output)){
+            Logger::error("Image rendering failed with errors: ", frame_errors_, '\n');
+            //TODO: customizable error handling
+            return {FrameStatus::failed, completed_tile_count_};
+        }
+
+        if(!frame_errors_.empty()) {
+            Logger::warn("Shading reported errors: ", frame_errors_, '\n');
+        }
+
+        if(cancelled_) {
+            RAYCHEL_LOG("Frame was cancelled after ", completed_tile_count_, " of ", tiles_.size(), " tiles");
+            return {FrameStatus::cancelled, completed_tile_count_};
+        }
+
+        return {FrameStatus::complete, completed_tile_count_};
+    }
+
+    void RaymarchRenderer::_flushShadingErrors(size_t tile_index) const noexcept
+    {
+        ShadingErrorLog& log = tile_errors_[tile_index];
+        takeThreadShadingErrors(log);
+
+        if(log.hasFatal()) {
+            frame_failed_ = true;
+        }
+    }
+
+    void RaymarchRenderer::_mergeShadingErrors() noexcept
+    {
+        frame_errors_.clear();
+
+        size_t failed_tile_count = 0;
+        for(auto& log : tile_errors_) {
+            if(!log.empty()) {
+                frame_errors_.merge(log);
+                failed_tile_count++;
+                log.clear();
+            }
+        }
+
+        if(failed_tile_count != 0) {
+            RAYCHEL_LOG(failed_tile_count, " tiles reported shading errors");
+        }
+    }
+
+    bool RaymarchRenderer::_isCancelled() const noexcept
     {
+        if(cancelled_.load(std::memory_order_relaxed)) {
+            return true;
+        }
 
-        using namespace std::placeholders;
+        const bool out_of_budget = (frame_budget_.cancellation && frame_budget_.cancellation->isCancelled()) ||
+                                   (frame_budget_.deadline && std::chrono::steady_clock::now() >= *frame_budget_.deadline);
+        if(out_of_budget) {
+            cancelled_ = true;
+        }
+        return out_of_budget;
+    }
 
-        static const auto f = [this](const RaymarchData& req){
-            return _raymarchFunction(req);
+    CancelFunction RaymarchRenderer::_cancelFunction() const
+    {
+        return [this] {
+            return _isCancelled();
         };
+    }
+
+    void RaymarchRenderer::setPreviewCallback(PreviewCallback callback)
+    {
+        preview_callback_ = std::move(callback);
+    }
+
+    void RaymarchRenderer::setTileCallback(TileCallback callback)
+    {
+        tile_callback_ = std::move(callback);
+    }
 
+    bool RaymarchRenderer::_renderToFramebuffer(const FramebufferSpan& output_texture)
+    {
         RAYCHEL_LOG("Starting render...");
 
-        std::transform(std::execution::par, requests_.cbegin(), requests_.cend(), output_texture.begin(), f);
+        //drop what the calling thread counted outside of a frame, for example in getDirectLighting() queries
+        _flushMarchCounters();
+        frame_ray_count_ = 0;
+        frame_step_count_ = 0;
+        frame_backtrack_count_ = 0;
+        frame_cached_step_count_ = 0;
+        frame_lit_point_count_ = 0;
+        frame_culled_light_count_ = 0;
+        frame_shadow_ray_count_ = 0;
+        frame_shadow_step_count_ = 0;
+        frame_occluded_ray_count_ = 0;
+
+        temporal_stats_ = {};
+        if(_keepsHistory()) {
+            _reproject(output_texture);
+        }
+
+        if(progressive_) {
+            for(size_t step = progressive_start_step; step > 1 && !frame_failed_ && !cancelled_; step /= 2) {
+                _renderPass(PixelLattice{step, step != progressive_start_step}, output_texture);
+
+                workers_.parallelFor(tiles_.size(), [&](size_t tile_index, size_t /*worker_index*/) {
+                    _fillPreview(tiles_[tile_index], step, output_texture);
+                });
 
-        RAYCHEL_LOG("Finished render!");
-        return !failed_;
+                if(preview_callback_ && !frame_failed_ && !cancelled_) {
+                    preview_callback_(output_texture, step);
+                }
+            }
+            _renderPass(PixelLattice{1, true}, output_texture);
+        } else {
+            _renderPass(PixelLattice{}, output_texture);
+        }
+
+        aa_stats_ = {};
+        if(do_aa_ && !frame_failed_ && !cancelled_) {
+            _antiAlias(output_texture);
+        }
+
+        //the last complete frame stays the history, so the next frame can still reuse it
+        if(_keepsHistory() && !cancelled_) {
+            _updateHistory(output_texture);
+        }
+
+        march_stats_ = {marching_strategy_, frame_ray_count_, frame_step_count_, frame_backtrack_count_, frame_cached_step_count_};
+        lighting_stats_ = {frame_lit_point_count_, frame_culled_light_count_, frame_shadow_ray_count_, frame_shadow_step_count_, frame_occluded_ray_count_};
+
+        _mergeShadingErrors();
+
+        RAYCHEL_LOG("Finished render! ", march_stats_);
+        return !frame_failed_;
+    }
+
+    void RaymarchRenderer::_renderPass(const PixelLattice& lattice, const FramebufferSpan& output_texture)
+    {
+        //anti-aliasing still changes the tiles after the last pass
+        const bool is_final_pass = (lattice.step == 1) && !do_aa_;
+
+        workers_.parallelFor(tiles_.size(), [&](size_t tile_index, size_t worker_index) {
+            if(frame_failed_ || _isCancelled()) {
+                return;
+            }
+
+            _renderTile(tile_index, lattice, worker_index, output_texture);
+            if(is_final_pass) {
+                _finishTile(tile_index, output_texture);
+            }
+        });
+    }
+
+    void RaymarchRenderer::_renderTile(size_t tile_index, const PixelLattice& lattice, size_t worker_index, const FramebufferSpan& output_texture) const noexcept
+    {
+        const Tile& tile = tiles_[tile_index];
+
+        if(cone_prepass_) {
+            _renderConeRefined(tile, lattice, 0.0F, worker_index, output_texture);
+        } else {
+            _renderRect(tile, lattice, 0.0F, worker_index, output_texture);
+        }
+
+        _flushMarchCounters();
+        _flushShadingErrors(tile_index);
+    }
+
+    void RaymarchRenderer::_renderConeRefined(const Tile& rect, const PixelLattice& lattice, float start_depth, size_t worker_index, const FramebufferSpan& output_texture) const noexcept
+    {
+        if(_isReprojected(rect)) {
+            return;
+        }
+
+        const float depth = _coneMarch(rect, start_depth, raymarch_data_.max_ray_depth);
+
+        //coarse passes only hit a few pixels of each rect, so refining further would cost more than it saves
+        const size_t min_size = min_cone_size * lattice.step;
+        if(rect.size.x <= min_size && rect.size.y <= min_size) {
+            _renderRect(rect, lattice, depth, worker_index, output_texture);
+            return;
+        }
+
+        //the quadrants are inside of the cone of rect, so they can start where it stopped
+        for(const auto& quadrant : splitIntoQuadrants(rect)) {
+            if(quadrant.size.x != 0 && quadrant.size.y != 0) {
+                _renderConeRefined(quadrant, lattice, depth, worker_index, output_texture);
+            }
+        }
+    }
+
+    void RaymarchRenderer::_renderRect(const Tile& rect, const PixelLattice& lattice, float start_depth, size_t worker_index, const FramebufferSpan& output_texture) const noexcept
+    {
+        if(wavefront_) {
+            _renderRectWavefront(rect, lattice, start_depth, wavefront_buffers_[worker_index], output_texture);
+            return;
+        }
+
+        const size_t x_end = rect.origin.x + rect.size.x;
+        const size_t y_end = rect.origin.y + rect.size.y;
+        const bool record_samples = _recordsPrimarySamples();
+
+        //packets are gathered from the pixels of a row that still need marching
+        PacketLanes<float> packet_x;
+        vec3Packet packet_directions;
+        std::array<RenderResult, ray_packet_width> results;
+        std::array<PrimarySample, ray_packet_width> samples;
+        PacketLanes<float> packet_start_depths;
+        size_t packet_size = 0;
+
+        const auto flush_packet = [&](const PixelRow& pixel_row, size_t y) {
+            _getRowDirections(pixel_row, packet_x, packet_directions);
+            _raymarchPacketFunction(packet_directions, packet_size, packet_start_depths, results.data(), record_samples ? samples.data() : nullptr);
+
+            for(size_t i = 0; i < packet_size; i++) {
+                const auto x = static_cast<size_t>(packet_x[i]);
+                output_texture.store((y * output_size_.x) + x, results[i].output);
+                if(record_samples) {
+                    primary_samples_[(y * output_size_.x) + x] = samples[i];
+                }
+            }
+            packet_size = 0;
+        };
+
+        for(size_t y = lattice.first(rect.origin.y); y < y_end; y += lattice.step) {
+            const size_t row = y * output_size_.x;
+            const PixelRow pixel_row = _getPixelRow(y);
+
+            size_t x_begin = 0;
+            size_t x_step = 0;
+            lattice.rowColumns(y, rect.origin.x, x_begin, x_step);
+
+            for(size_t x = x_begin; x < x_end; x += x_step) {
+                if(_isReprojected(row + x)) {
+                    continue;
+                }
+
+                const float pixel_start_depth = std::max(start_depth, _depthHint(row + x));
+
+                if(packet_marching_) {
+                    packet_x[packet_size] = static_cast<float>(x);
+                    packet_start_depths[packet_size] = pixel_start_depth;
+                    if(++packet_size == ray_packet_width) {
+                        flush_packet(pixel_row, y);
+                    }
+                } else {
+                    const auto fx = static_cast<float>(x);
+                    output_texture.store(row + x, _raymarchFunction(pixel_row.direction(fx), pixel_start_depth, record_samples ? &primary_samples_[row + x] : nullptr).output);
+                }
+            }
+
+            if(packet_size != 0) {
+                flush_packet(pixel_row, y);
+            }
+        }
+    }
+
+    void RaymarchRenderer::_fillPreview(const Tile& tile, size_t step, const FramebufferSpan& output_texture) const noexcept
+    {
+        for(size_t y = tile.origin.y; y < tile.origin.y + tile.size.y; y++) {
+            const size_t anchor_y = y - (y % step);
+            for(size_t x = tile.origin.x; x < tile.origin.x + tile.size.x; x++) {
+                const size_t anchor_x = x - (x % step);
+                if((anchor_x == x && anchor_y == y) || _isReprojected((y * output_size_.x) + x)) {
+                    continue;
+                }
+
+                output_texture.store(vec2i{x, y}, output_texture.at(vec2i{anchor_x, anchor_y}));
+            }
+        }
     }
 
     void RaymarchRenderer::_setupCamData(const Camera& cam) noexcept
@@ -119,21 +655,4 @@ namespace Raychel {
 
 #pragma endregion
 
-    vec2 RaymarchRenderer::_getScreenspaceUV(const vec2& uv) const noexcept
-    {
-        vec2 actual_uv = uv;
-        
-        if(aspect_ratio > 1.0) {
-            actual_uv.x /= aspect_ratio;
-        } else {
-            actual_uv.y *= aspect_ratio;
-        }
-
-        actual_uv += vec2{0.5f, 0.5f};
-
-        actual_uv.y = 1.0f - actual_uv.y;
-
-        return actual_uv;
-    }
-
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include <algorithm>
+
+#include "Raychel/Engine/Rendering/Pipeline/Tiles.h"
+
+namespace Raychel {
+
+    std::vector<Tile> makeTiles(const vec2i& image_size, size_t tile_size)
+    {
+        RAYCHEL_ASSERT(tile_size != 0);
+
+        const vec2i tile_count = {
+            (image_size.x + tile_size - 1) / tile_size,
+            (image_size.y + tile_size - 1) / tile_size
+        };
+
+        std::vector<Tile> tiles;
+        tiles.reserve(tile_count.x * tile_count.y);
+
+        for(size_t y = 0; y < tile_count.y; y++) {
+            for(size_t x = 0; x < tile_count.x; x++) {
+                const vec2i origin{x * tile_size, y * tile_size};
+                const vec2i size{
+                    std::min(tile_size, image_size.x - origin.x),
+                    std::min(tile_size, image_size.y - origin.y)
+                };
+                tiles.push_back({origin, size});
+            }
+        }
+
+        std::sort(tiles.begin(), tiles.end(), [tile_size](const Tile& a, const Tile& b) {
+            return mortonEncode(a.origin.x / tile_size, a.origin.y / tile_size) < mortonEncode(b.origin.x / tile_size, b.origin.y / tile_size);
+        });
+
+        return tiles;
+    }
+
+    std::array<Tile, 4> splitIntoQuadrants(const Tile& rect) noexcept
+    {
+        const vec2i half = {rect.size.x - (rect.size.x / 2), rect.size.y - (rect.size.y / 2)};
+        const vec2i rest = rect.size - half;
+        return {{
+            {rect.origin, half},
+            {rect.origin + vec2i{half.x, 0}, vec2i{rest.x, half.y}},
+            {rect.origin + vec2i{0, half.y}, vec2i{half.x, rest.y}},
+            {rect.origin + half, rest},
+        }};
+    }
+
+}
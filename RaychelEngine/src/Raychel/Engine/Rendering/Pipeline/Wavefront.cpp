@@ -0,0 +1,255 @@
+/**
+*\file Wavefront.cpp
+*\author weckyy702 (weckyy702@gmail.com)
+*\brief Definitions for the wavefront rendering functions found in Shading.h
+*\date 2026-10-17
+*
+*MIT License
+*Copyright (c) [2021] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+*Permission is hereby granted, free of charge, to any person obtaining a copy
+*of this software and associated documentation files (the "Software"), to deal
+*in the Software without restriction, including without limitation the rights
+*to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*copies of the Software, and to permit persons to whom the Software is
+*furnished to do so, subject to the following conditions:
+*
+*The above copyright notice and this permission notice shall be included in all
+*copies or substantial portions of the Software.
+*
+*THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,#
+*OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*SOFTWARE.
+*
+*/
+
+#include <algorithm>
+#include <functional>
+
+#include "Raychel/Engine/Rendering/Pipeline/Shading.h"
+#include "Raychel/Engine/Objects/Interface.h"
+#include "Raychel/Misc/Texture/CubeTexture.h"
+
+namespace Raychel {
+
+    void RaymarchRenderer::_refillWavefrontBuffers()
+    {
+        wavefront_buffers_.clear();
+        if(!wavefront_) {
+            wavefront_buffers_.shrink_to_fit();
+            return;
+        }
+
+        //every pixel of a tile starts one ray, and every ray emits at most one secondary ray
+        const size_t capacity = tile_size_ * tile_size_;
+
+        wavefront_buffers_.resize(workers_.size());
+        for(auto& buffers : wavefront_buffers_) {
+            buffers.rays.setCapacity(capacity);
+            buffers.next_rays.setCapacity(capacity);
+            buffers.depths.resize(capacity);
+            buffers.step_counts.resize(capacity);
+            buffers.hits.resize(capacity);
+            buffers.hit_mask.resize(capacity);
+            buffers.hit_infos.resize(capacity);
+            buffers.hit_rays.resize(capacity);
+            buffers.batch_data.resize(capacity);
+            buffers.batch_colors.resize(capacity);
+            buffers.pixel_indices.resize(capacity);
+            buffers.pixel_colors.resize(capacity);
+        }
+
+        RAYCHEL_LOG("Allocated wavefront queues for ", capacity, " rays per worker");
+    }
+
+    void RaymarchRenderer::_renderRectWavefront(const Tile& rect, const PixelLattice& lattice, float start_depth, WavefrontBuffers& buffers, const FramebufferSpan& output_texture) const noexcept
+    {
+        RAYCHEL_ASSERT(rect.size.x * rect.size.y <= buffers.rays.capacity());
+
+        const size_t x_end = rect.origin.x + rect.size.x;
+        const size_t y_end = rect.origin.y + rect.size.y;
+        const bool record_samples = _recordsPrimarySamples();
+
+        //stage 0: one primary ray per pixel that still needs marching
+        RayQueue& rays = buffers.rays;
+        rays.clear();
+        size_t pixel_count = 0;
+
+        //with packet marching, directions are computed like the classic packet path does, so both paths trace the same rays
+        PacketLanes<float> packet_x;
+        vec3Packet packet_directions;
+        size_t packet_size = 0;
+        const auto flush_packet = [&](const PixelRow& pixel_row) {
+            _getRowDirections(pixel_row, packet_x, packet_directions);
+            for(size_t lane = 0; lane < packet_size; lane++) {
+                rays.setDirection(pixel_count - packet_size + lane, packet_directions.lane(lane));
+            }
+            packet_size = 0;
+        };
+
+        for(size_t y = lattice.first(rect.origin.y); y < y_end; y += lattice.step) {
+            const size_t row = y * output_size_.x;
+            const PixelRow pixel_row = _getPixelRow(y);
+
+            size_t x_begin = 0;
+            size_t x_step = 0;
+            lattice.rowColumns(y, rect.origin.x, x_begin, x_step);
+
+            for(size_t x = x_begin; x < x_end; x += x_step) {
+                if(_isReprojected(row + x)) {
+                    continue;
+                }
+
+                const auto slot = static_cast<std::uint32_t>(pixel_count++);
+                buffers.pixel_indices[slot] = static_cast<std::uint32_t>(row + x);
+                buffers.pixel_colors[slot] = color{0};
+                rays.push(cam_data_.position, pixel_row.direction(static_cast<float>(x)), std::max(start_depth, _depthHint(row + x)), color{1}, slot);
+
+                if(packet_marching_) {
+                    packet_x[packet_size] = static_cast<float>(x);
+                    if(++packet_size == ray_packet_width) {
+                        flush_packet(pixel_row);
+                    }
+                }
+            }
+
+            if(packet_size != 0) {
+                flush_packet(pixel_row);
+            }
+        }
+
+        for(size_t recursion_depth = 0; rays.size != 0; recursion_depth++) {
+            _marchWavefront(buffers, recursion_depth == 0);
+
+            //compaction: misses are finished right away, hits are shaded together
+            size_t hit_count = 0;
+            for(size_t i = 0; i < rays.size; i++) {
+                if(buffers.hit_mask[i] != 0) {
+                    buffers.hit_rays[hit_count++] = static_cast<std::uint32_t>(i);
+                    continue;
+                }
+
+                buffers.pixel_colors[rays.pixel_slot[i]] += rays.weight(i) * (*background_texture_)(rays.direction(i));
+                if(record_samples && recursion_depth == 0) {
+                    primary_samples_[buffers.pixel_indices[rays.pixel_slot[i]]] = {nullptr, raymarch_data_.max_ray_depth};
+                }
+            }
+
+            buffers.next_rays.clear();
+            _shadeWavefront(buffers, hit_count, recursion_depth, record_samples);
+            std::swap(buffers.rays, buffers.next_rays);
+        }
+
+        for(size_t slot = 0; slot < pixel_count; slot++) {
+            output_texture.store(buffers.pixel_indices[slot], buffers.pixel_colors[slot]);
+        }
+    }
+
+    void RaymarchRenderer::_marchWavefront(WavefrontBuffers& buffers, bool primary) const noexcept
+    {
+        const RayQueue& rays = buffers.rays;
+
+        if(!primary || !packet_marching_) {
+            //secondary rays start at different points, so they are marched one by one
+            for(size_t i = 0; i < rays.size; i++) {
+                buffers.hit_mask[i] = raymarch(rays.origin(i), rays.direction(i), rays.start_depth[i], raymarch_data_.max_ray_depth, &buffers.depths[i], &buffers.step_counts[i], &buffers.hits[i]) ? 1U : 0U;
+            }
+            return;
+        }
+
+        const vec3 origin = cam_data_.position;
+        for(size_t begin = 0; begin < rays.size; begin += ray_packet_width) {
+            const size_t count = std::min(ray_packet_width, rays.size - begin);
+
+            //lanes past count repeat the last ray and are masked off
+            vec3Packet directions;
+            PacketLanes<float> start_depths;
+            PacketLanes<bool> mask;
+            for(size_t lane = 0; lane < ray_packet_width; lane++) {
+                const size_t i = begin + std::min(lane, count - 1);
+                directions.x[lane] = rays.direction_x[i];
+                directions.y[lane] = rays.direction_y[i];
+                directions.z[lane] = rays.direction_z[i];
+                start_depths[lane] = rays.start_depth[i];
+                mask[lane] = lane < count;
+            }
+
+            PacketLanes<float> depths;
+            PacketLanes<size_t> step_counts;
+            PacketLanes<ObjectDistance> hits;
+            raymarchPacket(origin, directions, start_depths, raymarch_data_.max_ray_depth, mask, depths, step_counts, hits);
+
+            for(size_t lane = 0; lane < count; lane++) {
+                buffers.hit_mask[begin + lane] = mask[lane] ? 1U : 0U;
+                buffers.depths[begin + lane] = depths[lane];
+                buffers.step_counts[begin + lane] = step_counts[lane];
+                buffers.hits[begin + lane] = hits[lane];
+            }
+        }
+    }
+
+    void RaymarchRenderer::_shadeWavefront(WavefrontBuffers& buffers, size_t hit_count, size_t recursion_depth, bool record_samples) const noexcept
+    {
+        const RayQueue& rays = buffers.rays;
+
+        for(size_t k = 0; k < hit_count; k++) {
+            const size_t i = buffers.hit_rays[k];
+            buffers.hit_infos[i] = getHitInfo(rays.origin(i), rays.direction(i), buffers.depths[i], buffers.hits[i], buffers.step_counts[i], recursion_depth);
+        }
+
+        //hits on the same object are shaded together, so its material runs on a warm cache
+        std::sort(buffers.hit_rays.begin(), buffers.hit_rays.begin() + static_cast<std::ptrdiff_t>(hit_count), [&](std::uint32_t a, std::uint32_t b) {
+            return std::less<const IRaymarchable*>{}(buffers.hit_infos[a].hit_object, buffers.hit_infos[b].hit_object);
+        });
+
+        for(size_t k = 0; k < hit_count; k++) {
+            buffers.batch_data[k] = buffers.hit_infos[buffers.hit_rays[k]].shading_data;
+        }
+
+        for(size_t batch_begin = 0; batch_begin < hit_count;) {
+            const IRaymarchable* object = buffers.hit_infos[buffers.hit_rays[batch_begin]].hit_object;
+            size_t batch_end = batch_begin + 1;
+            while(batch_end < hit_count && buffers.hit_infos[buffers.hit_rays[batch_end]].hit_object == object) {
+                batch_end++;
+            }
+
+            //probe reads are only known per batch, so one read marks every hit of the batch as view dependent
+            _takeReflectionProbeRead();
+            object->getSurfaceColors(&buffers.batch_data[batch_begin], batch_end - batch_begin, &buffers.batch_colors[batch_begin]);
+            const bool read_reflection_probe = _takeReflectionProbeRead();
+
+            for(size_t k = batch_begin; k < batch_end; k++) {
+                const size_t i = buffers.hit_rays[k];
+                const std::uint32_t slot = rays.pixel_slot[i];
+                const ShadingData& data = buffers.batch_data[k];
+                const color weight = rays.weight(i);
+
+                buffers.pixel_colors[slot] += weight * buffers.batch_colors[k];
+                vec3 secondary_direction;
+                color secondary_weight;
+                const bool has_secondary_ray = object->getSecondaryRay(data, secondary_direction, secondary_weight);
+
+                if(record_samples && recursion_depth == 0) {
+                    primary_samples_[buffers.pixel_indices[slot]] = {object, buffers.depths[i], read_reflection_probe || has_secondary_ray};
+                }
+
+                if(!has_secondary_ray) {
+                    continue;
+                }
+
+                //rays past the recursion limit only see the background, like in getShadedColor()
+                if(data.recursion_depth > raymarch_data_.max_recursion_depth) {
+                    buffers.pixel_colors[slot] += (weight * secondary_weight) * (*background_texture_)(secondary_direction);
+                } else {
+                    buffers.next_rays.push(data.surface_point, secondary_direction, 0.0F, weight * secondary_weight, slot);
+                }
+            }
+
+            batch_begin = batch_end;
+        }
+    }
+
+}
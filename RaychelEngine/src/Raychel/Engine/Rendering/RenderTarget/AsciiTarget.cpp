@@ -25,33 +25,16 @@ namespace Raychel {
         _init_ncurses();
     } 
 
-    void AsciiTarget::writeFramebuffer(const Texture<RenderResult>& framebuffer)
+    void AsciiTarget::writeFramebuffer(const FramebufferView& framebuffer)
     {
-        for (size_t j = 0U; j < size().y; j++) {
-            for(size_t i = 0U; i < size().x; i++) {
-                auto col = framebuffer.at(vec2i{size().x - 1 - i, j}).output;
-                
-                auto col_brightness = brightness(col);
-                size_t character_index = static_cast<size_t>(col_brightness * (character_set_.size()-1));
-
         #ifndef RAYCHEL_USE_NCURSES_FALLBACK
-                char c = character_set_.at(character_index);
-                
-                if(use_color_ && has_colors()) {
-                    auto color_index = getColorPaletteIndex(col);
-                    attron(COLOR_PAIR(color_index));
-                    mvaddch(size().y-j, i, c);
-                    attroff(COLOR_PAIR(color_index));
-                } else {
-                    mvaddch(size().y-j, size().x-i, c);
-                }
-
-                
-            }
-        }
+        _drawTile(Tile{vec2i{0, 0}, size()}, framebuffer);
         refresh();
         #else
-            std::cout.write(character_set_.data()+character_index, 1);
+        for (size_t j = 0U; j < size().y; j++) {
+            for(size_t i = 0U; i < size().x; i++) {
+                const size_t character_index = _characterIndex(framebuffer.at(vec2i{size().x - 1 - i, j}));
+                std::cout.write(character_set_.data()+character_index, 1);
             }
             std::cout << std::endl;
         }
@@ -59,6 +42,33 @@ namespace Raychel {
         #endif 
     }
 
+    bool AsciiTarget::streamsTiles() const noexcept
+    {
+        //the fallback can only print whole lines
+        #ifndef RAYCHEL_USE_NCURSES_FALLBACK
+        return true;
+        #else
+        return false;
+        #endif
+    }
+
+    void AsciiTarget::writeTile(const Tile& tile, const FramebufferView& framebuffer)
+    {
+        #ifndef RAYCHEL_USE_NCURSES_FALLBACK
+        _drawTile(tile, framebuffer);
+        //show the partial frame right away
+        refresh();
+        #else
+        (void)tile;
+        (void)framebuffer;
+        #endif
+    }
+
+    void AsciiTarget::endFrame()
+    {
+        finishFramebufferWrite();
+    }
+
     void AsciiTarget::finishFramebufferWrite()
     {
         using namespace std::chrono_literals;
@@ -73,6 +83,38 @@ namespace Raychel {
         #endif
     }
 
+    size_t AsciiTarget::_characterIndex(const color& col) const noexcept
+    {
+        return static_cast<size_t>(brightness(col) * (character_set_.size()-1));
+    }
+
+    void AsciiTarget::_drawTile(const Tile& tile, const FramebufferView& framebuffer) const
+    {
+        #ifndef RAYCHEL_USE_NCURSES_FALLBACK
+        for (size_t j = tile.origin.y; j < tile.origin.y + tile.size.y; j++) {
+            for(size_t x = tile.origin.x; x < tile.origin.x + tile.size.x; x++) {
+                //the image is mirrored horizontally on screen
+                const size_t i = size().x - 1 - x;
+                auto col = framebuffer.at(vec2i{x, j});
+
+                char c = character_set_.at(_characterIndex(col));
+                
+                if(use_color_ && has_colors()) {
+                    auto color_index = getColorPaletteIndex(col);
+                    attron(COLOR_PAIR(color_index));
+                    mvaddch(size().y-j, i, c);
+                    attroff(COLOR_PAIR(color_index));
+                } else {
+                    mvaddch(size().y-j, size().x-i, c);
+                }
+            }
+        }
+        #else
+        (void)tile;
+        (void)framebuffer;
+        #endif
+    }
+
     void AsciiTarget::_init_ncurses() const
     {
         #ifndef RAYCHEL_USE_NCURSES_FALLBACK
@@ -11,31 +11,27 @@ namespace Raychel
         using pixel_t = png::basic_rgb_pixel<rgb_t>;
         using image_t = png::image<pixel_t, png::solid_pixel_buffer<pixel_t>>;
 
-    void ImageTargetPng::writeFramebuffer(const Texture<RenderResult>& framebuffer)
+    void ImageTargetPng::writeFramebuffer(const FramebufferView& framebuffer)
     {
 
         RAYCHEL_LOG("Writing framebuffer to image...")
 
-        //RAYCHEL_ASSERT(framebuffer.size() == getSize());
+        RAYCHEL_ASSERT(framebuffer.size() == size());
 
         const auto image_size = size().to<png::uint_32>();
-        const auto _size = image_size.to<float>() - vec2{1, 1};
 
         image_t image{image_size.x, image_size.y};
 
+        //the framebuffer starts with the bottom row, png images with the top row
+        std::vector<color> row(image_size.x);
+        for(png::uint_32 y = 0; y < image_size.y; y++) {
+            framebuffer.loadRow(y, row.data());
 
-        const auto write_pixel = [_size, &image](const RenderResult& res) {
-
-            const auto screen_uv = res.uv * _size;
-            const auto pixel_uv = screen_uv.to<png::uint_32>();
-
-            const auto col = res.output.to<rgb_t>();
-
-            image.set_pixel(pixel_uv.x, pixel_uv.y, pixel_t{col.r, col.g, col.b});
-        };
-
-
-        std::for_each(framebuffer.begin(), framebuffer.end(), write_pixel);
+            for(png::uint_32 x = 0; x < image_size.x; x++) {
+                const auto col = row[x].to<rgb_t>();
+                image.set_pixel(x, image_size.y - 1 - y, pixel_t{col.r, col.g, col.b});
+            }
+        }
 
         RAYCHEL_LOG("Finished writing pixels");
 
@@ -1,5 +1,10 @@
 #include "Raychel/Engine/Rendering/Renderer.h"
 #include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Rendering/RenderTarget/RenderTarget.h"
+#include "Raychel/Misc/Concurrency/BoundedQueue.h"
+
+#include <mutex>
+#include <thread>
 
 namespace Raychel {
 
@@ -7,24 +12,216 @@ namespace Raychel {
     {
         output_size_ = new_size;
 
-        renderer_.setRenderSize(new_size /* * RenderOptions.AA_factor*/);
+        renderer_.setRenderSize(new_size);
 
         return output_size_;
     }
 
 
 
+    void RenderController::setRenderOptions(const RenderOptions& options)
+    {
+        renderer_.setRenderOptions(options);
+        framebuffer_pool_.setUseHugePages(options.framebuffer_huge_pages);
+    }
+
     void RenderController::setCurrentScene(const not_null<Scene*> new_scene) 
     {
         current_scene_ = new_scene;
-        renderer_.setSceneData(&current_scene_->objects_, &current_scene_->background_texture_);
+        scene_revision_ = current_scene_->revision_;
+        renderer_.setSceneData(&current_scene_->objects_, &current_scene_->lamps_, &current_scene_->background_texture_);
+        renderer_.setReflectionProbes(&current_scene_->reflection_probes_);
+    }
+
+    void RenderController::_syncScene()
+    {
+        RAYCHEL_ASSERT(current_scene_);
+        if(current_scene_->revision_ != scene_revision_) {
+            setCurrentScene(current_scene_);
+        }
     }
 
+    void RenderController::invalidateScene()
+    {
+        renderer_.invalidateScene();
+    }
 
-    std::optional<Texture<RenderResult>> RenderController::getImageRendered()
+    void RenderController::invalidateScene(const BoundingBox& changed_bounds)
+    {
+        renderer_.invalidateScene(changed_bounds);
+    }
+
+    void RenderController::setPreviewCallback(PreviewCallback callback)
+    {
+        renderer_.setPreviewCallback(std::move(callback));
+    }
+
+    void RenderController::setTileCallback(TileCallback callback)
+    {
+        tile_callback_ = callback;
+        renderer_.setTileCallback(std::move(callback));
+    }
+
+
+    std::optional<Framebuffer> RenderController::getImageRendered()
+    {
+        Framebuffer output = framebuffer_pool_.acquire(output_size_, renderer_.framebufferFormat());
+
+        if(!renderInto(output)) {
+            framebuffer_pool_.release(std::move(output));
+            return std::nullopt;
+        }
+
+        return output;
+    }
+
+    bool RenderController::renderInto(const FramebufferSpan& output)
     {
         //TODO implement postprocessing
-        return renderer_.renderImage(current_scene_->cam_);
+        _syncScene();
+        return renderer_.renderImage(current_scene_->cam_, output);
+    }
+
+    FrameResult RenderController::renderInto(const FramebufferSpan& output, const FrameBudget& budget)
+    {
+        _syncScene();
+        return renderer_.renderImage(current_scene_->cam_, output, budget);
+    }
+
+    void RenderController::recycleFramebuffer(Framebuffer&& framebuffer) noexcept
+    {
+        framebuffer_pool_.release(std::move(framebuffer));
+    }
+
+    size_t RenderController::renderToTarget(RenderTarget& target, const FrameCallback& prepare_frame, size_t queue_depth)
+    {
+        RAYCHEL_ASSERT(queue_depth != 0);
+
+        if(target.streamsTiles()) {
+            return _streamToTarget(target, prepare_frame);
+        }
+
+        BoundedQueue<Framebuffer> finished_frames{queue_depth};
+        std::atomic_bool write_failed{false};
+        size_t written_frames = 0;
+
+        std::thread writer{[&] {
+            //stop the render loop. The frames that are still queued are dropped
+            const auto stop_writing = [&] {
+                write_failed = true;
+                finished_frames.close();
+            };
+
+            Framebuffer framebuffer;
+            while(finished_frames.pop(framebuffer)) {
+                if(!write_failed) {
+                    try {
+                        target.prepareFramebufferWrite();
+                        target.writeFramebuffer(framebuffer);
+                        target.finishFramebufferWrite();
+                        written_frames++;
+                    } catch(const std::exception& e) {
+                        Logger::error("Writing frame ", written_frames, " failed with error: ", e.what(), '\n');
+                        stop_writing();
+                    } catch(...) {
+                        //anything escaping this thread would terminate the program
+                        Logger::error("Writing frame ", written_frames, " failed with an unknown error\n");
+                        stop_writing();
+                    }
+                }
+                recycleFramebuffer(std::move(framebuffer));
+            }
+        }};
+
+        const auto stop_writer = [&] {
+            finished_frames.close();
+            writer.join();
+        };
+
+        try {
+            for(size_t frame_index = 0; !write_failed && prepare_frame(frame_index); frame_index++) {
+                auto framebuffer = getImageRendered();
+                if(!framebuffer) {
+                    break;
+                }
+
+                if(!finished_frames.push(std::move(*framebuffer))) {
+                    recycleFramebuffer(std::move(*framebuffer));
+                    break;
+                }
+            }
+        } catch(...) {
+            //prepare_frame threw. The writer must not outlive this call
+            stop_writer();
+            throw;
+        }
+
+        stop_writer();
+
+        return written_frames;
+    }
+
+    size_t RenderController::_streamToTarget(RenderTarget& target, const FrameCallback& prepare_frame)
+    {
+        //the worker threads finish tiles concurrently, but the target sees one call at a time
+        std::mutex target_mtx;
+        bool write_failed = false;
+        size_t written_frames = 0;
+
+        //returns false if the target threw
+        const auto write_guarded = [&](auto&& write) {
+            std::lock_guard lock{target_mtx};
+            if(write_failed) {
+                return false;
+            }
+
+            try {
+                write();
+            } catch(const std::exception& e) {
+                Logger::error("Writing frame ", written_frames, " failed with error: ", e.what(), '\n');
+                write_failed = true;
+            } catch(...) {
+                //the tiles are written from the worker threads, which must not see exceptions
+                Logger::error("Writing frame ", written_frames, " failed with an unknown error\n");
+                write_failed = true;
+            }
+            return !write_failed;
+        };
+
+        renderer_.setTileCallback([&](const Tile& tile, const FramebufferView& framebuffer) {
+            write_guarded([&] {
+                target.writeTile(tile, framebuffer);
+            });
+        });
+
+        try {
+            for(size_t frame_index = 0; !write_failed && prepare_frame(frame_index); frame_index++) {
+                if(!write_guarded([&] { target.beginFrame(); })) {
+                    break;
+                }
+
+                Framebuffer framebuffer = framebuffer_pool_.acquire(output_size_, renderer_.framebufferFormat());
+                const bool rendered = renderInto(framebuffer);
+                framebuffer_pool_.release(std::move(framebuffer));
+
+                //endFrame() is owed even if the frame failed, but a target that threw is not touched again
+                if(write_guarded([&] { target.endFrame(); }) && rendered) {
+                    written_frames++;
+                }
+
+                if(!rendered) {
+                    break;
+                }
+            }
+        } catch(...) {
+            //prepare_frame threw. The callback references this stack frame
+            renderer_.setTileCallback(tile_callback_);
+            throw;
+        }
+
+        renderer_.setTileCallback(tile_callback_);
+
+        return written_frames;
     }
 
 }
\ No newline at end of file
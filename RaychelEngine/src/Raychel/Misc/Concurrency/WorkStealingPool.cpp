@@ -0,0 +1,155 @@
+#include "Raychel/Misc/Concurrency/WorkStealingPool.h"
+
+namespace Raychel {
+
+    namespace {
+
+        constexpr std::uint64_t packRange(std::uint64_t begin, std::uint64_t end) noexcept
+        {
+            return (end << 32U) | begin;
+        }
+
+        constexpr size_t rangeBegin(std::uint64_t range) noexcept
+        {
+            return static_cast<size_t>(range & 0xFFFFFFFFU);
+        }
+
+        constexpr size_t rangeEnd(std::uint64_t range) noexcept
+        {
+            return static_cast<size_t>(range >> 32U);
+        }
+
+    }
+
+    WorkStealingPool::WorkStealingPool(size_t num_workers)
+        :num_workers_{std::max<size_t>(num_workers, 1U)}, ranges_{std::make_unique<WorkRange[]>(num_workers_)}
+    {
+        threads_.reserve(num_workers_-1);
+        for(size_t i = 1U; i < num_workers_; i++) {
+            threads_.emplace_back([this, i]{ _workerMain(i); });
+        }
+    }
+
+    void WorkStealingPool::_run(size_t count, job_func job, const void* ctx, bool allow_stealing)
+    {
+        if(count == 0) {
+            return;
+        }
+        RAYCHEL_ASSERT(count < (std::uint64_t{1} << 32U));
+
+        //hand out contiguous ranges so neighbouring work items stay on the same worker
+        const size_t chunk = count / num_workers_;
+        const size_t remainder = count % num_workers_;
+        size_t begin = 0;
+        for(size_t i = 0; i < num_workers_; i++) {
+            const size_t end = begin + chunk + (i < remainder ? 1 : 0);
+            ranges_[i].bounds.store(packRange(begin, end), std::memory_order_relaxed);
+            begin = end;
+        }
+
+        {
+            std::scoped_lock lock{mtx_};
+            RAYCHEL_ASSERT(job_ == nullptr);
+            job_ = job;
+            job_ctx_ = ctx;
+            allow_stealing_ = allow_stealing;
+            busy_workers_ = num_workers_-1;
+            generation_++;
+        }
+        job_cv_.notify_all();
+
+        _processJob(0);
+
+        std::unique_lock lock{mtx_};
+        done_cv_.wait(lock, [this]{ return busy_workers_ == 0; });
+        job_ = nullptr;
+        job_ctx_ = nullptr;
+    }
+
+    void WorkStealingPool::_workerMain(size_t worker_index)
+    {
+        size_t last_generation = 0;
+        while(true) {
+            {
+                std::unique_lock lock{mtx_};
+                job_cv_.wait(lock, [&]{ return shutdown_ || generation_ != last_generation; });
+                if(shutdown_) {
+                    return;
+                }
+                last_generation = generation_;
+            }
+
+            _processJob(worker_index);
+
+            {
+                std::scoped_lock lock{mtx_};
+                busy_workers_--;
+            }
+            done_cv_.notify_one();
+        }
+    }
+
+    void WorkStealingPool::_processJob(size_t worker_index) noexcept
+    {
+        size_t index = 0;
+        while(_popFront(worker_index, index) || (allow_stealing_ && _stealHalf(worker_index, index))) {
+            job_(job_ctx_, index, worker_index);
+        }
+    }
+
+    bool WorkStealingPool::_popFront(size_t worker_index, size_t& out_index) noexcept
+    {
+        auto& bounds = ranges_[worker_index].bounds;
+        std::uint64_t range = bounds.load(std::memory_order_acquire);
+        while(true) {
+            const size_t begin = rangeBegin(range);
+            const size_t end = rangeEnd(range);
+            if(begin >= end) {
+                return false;
+            }
+            if(bounds.compare_exchange_weak(range, packRange(begin+1, end), std::memory_order_acq_rel)) {
+                out_index = begin;
+                return true;
+            }
+        }
+    }
+
+    bool WorkStealingPool::_stealHalf(size_t thief_index, size_t& out_index) noexcept
+    {
+        for(size_t i = 1; i < num_workers_; i++) {
+            auto& victim_bounds = ranges_[(thief_index + i) % num_workers_].bounds;
+
+            std::uint64_t range = victim_bounds.load(std::memory_order_acquire);
+            while(true) {
+                const size_t begin = rangeBegin(range);
+                const size_t end = rangeEnd(range);
+                if(begin >= end) {
+                    break;
+                }
+
+                const size_t split = end - ((end - begin + 1) / 2);
+                if(victim_bounds.compare_exchange_weak(range, packRange(begin, split), std::memory_order_acq_rel)) {
+                    //our own range is empty and nobody else ever grows it, so a plain store is enough
+                    ranges_[thief_index].bounds.store(packRange(split+1, end), std::memory_order_release);
+                    out_index = split;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        {
+            std::scoped_lock lock{mtx_};
+            shutdown_ = true;
+        }
+        job_cv_.notify_all();
+
+        for(auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+}
@@ -0,0 +1,72 @@
+#include <ostream>
+
+#include "Raychel/Misc/Exceptions/ShadingError.h"
+
+namespace Raychel {
+
+    namespace {
+
+        //errors of the calling thread since the renderer last collected them
+        thread_local ShadingErrorLog thread_shading_errors;
+
+    }
+
+    void ShadingErrorLog::add(const ShadingError& error) noexcept
+    {
+        total_count_ += error.count;
+        has_fatal_ = has_fatal_ || error.fatal;
+
+        for(size_t i = 0; i < size_; i++) {
+            ShadingError& existing = errors_[i];
+            if(existing.what == error.what && existing.origin == error.origin) {
+                existing.count += error.count;
+                existing.fatal = existing.fatal || error.fatal;
+                return;
+            }
+        }
+
+        if(size_ < errors_.size()) {
+            errors_[size_++] = error;
+        }
+    }
+
+    void ShadingErrorLog::merge(const ShadingErrorLog& other) noexcept
+    {
+        for(const auto& error : other) {
+            add(error);
+        }
+
+        //reports that did not fit into other
+        size_t listed_count = 0;
+        for(const auto& error : other) {
+            listed_count += error.count;
+        }
+        total_count_ += other.total_count_ - listed_count;
+        has_fatal_ = has_fatal_ || other.has_fatal_;
+    }
+
+    std::ostream& operator<<(std::ostream& os, const ShadingErrorLog& log)
+    {
+        os << "{ reports: " << log.totalCount();
+        for(const auto& error : log) {
+            os << ", " << (error.fatal ? "fatal " : "") << '"' << error.what << "\" at (" << error.origin << ") x" << error.count;
+        }
+        return os << " }";
+    }
+
+    void reportShadingError(std::string_view what, std::string_view origin, bool fatal) noexcept
+    {
+        thread_shading_errors.add(ShadingError{what, origin, fatal, 1});
+    }
+
+    void takeThreadShadingErrors(ShadingErrorLog& out_log) noexcept
+    {
+        if(thread_shading_errors.empty()) {
+            return;
+        }
+
+        out_log.merge(thread_shading_errors);
+        thread_shading_errors.clear();
+    }
+
+}
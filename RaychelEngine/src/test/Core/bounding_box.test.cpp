@@ -0,0 +1,48 @@
+#include <catch2/catch.hpp>
+
+#include "Raychel/Core/BoundingBox.h"
+
+TEST_CASE("Default bounding boxes are empty", "[Core][BoundingBox]")
+{
+    using namespace Raychel;
+
+    const BoundingBox b{};
+
+    REQUIRE(isEmpty(b));
+    REQUIRE_FALSE(contains(b, vec3{}));
+
+    const BoundingBox merged = merge(b, vec3{1, 2, 3});
+
+    REQUIRE_FALSE(isEmpty(merged));
+    REQUIRE(merged.min == vec3{1, 2, 3});
+    REQUIRE(merged.max == vec3{1, 2, 3});
+}
+
+TEST_CASE("Merging bounding boxes", "[Core][BoundingBox]")
+{
+    using namespace Raychel;
+
+    const BoundingBox a{vec3{-1, -1, -1}, vec3{1, 1, 1}};
+    const BoundingBox b{vec3{0, 2, -3}, vec3{4, 3, 0}};
+
+    const BoundingBox res = merge(a, b);
+
+    REQUIRE(res.min == vec3{-1, -1, -3});
+    REQUIRE(res.max == vec3{4, 3, 1});
+    REQUIRE(center(res) == vec3{1.5F, 1, -1});
+    REQUIRE(extent(res) == vec3{5, 4, 4});
+}
+
+TEST_CASE("Distance to bounding boxes", "[Core][BoundingBox]")
+{
+    using namespace Raychel;
+
+    const BoundingBox b{vec3{-1, -1, -1}, vec3{1, 1, 1}};
+
+    REQUIRE(contains(b, vec3{0.5F, -0.5F, 1}));
+    REQUIRE(distance(b, vec3{0.5F, -0.5F, 1}) == 0);
+
+    REQUIRE(distance(b, vec3{3, 0, 0}) == Approx(2));
+    REQUIRE(distance(b, vec3{0, -4, 0}) == Approx(3));
+    REQUIRE(distance(b, vec3{4, 5, 1}) == Approx(5));
+}
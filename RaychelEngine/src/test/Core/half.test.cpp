@@ -0,0 +1,45 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <limits>
+
+#include "Raychel/Core/Half.h"
+
+TEST_CASE("Half precision conversion", "[Core][Half]")
+{
+    using namespace Raychel;
+
+    SECTION("Exactly representable values")
+    {
+        REQUIRE(floatToHalf(0.0F) == 0x0000U);
+        REQUIRE(floatToHalf(-0.0F) == 0x8000U);
+        REQUIRE(floatToHalf(1.0F) == 0x3C00U);
+        REQUIRE(floatToHalf(-2.0F) == 0xC000U);
+        REQUIRE(floatToHalf(65504.0F) == 0x7BFFU);
+        REQUIRE(floatToHalf(5.9604645e-8F) == 0x0001U);
+
+        for(const float value : {0.5F, 1.5F, -3.25F, 1024.0F, 6.1035156e-5F, 0.099975586F}) {
+            REQUIRE(halfToFloat(floatToHalf(value)) == value);
+        }
+    }
+
+    SECTION("Rounding")
+    {
+        //halfway between 1 and the next half, rounds to even
+        REQUIRE(floatToHalf(1.0F + (1.0F / 2048.0F)) == 0x3C00U);
+        REQUIRE(floatToHalf(1.0F + (3.0F / 2048.0F)) == 0x3C02U);
+
+        //relative error is at most 2^-11
+        for(float value = -100.0F; value < 100.0F; value += 0.37F) {
+            REQUIRE(std::abs(halfToFloat(floatToHalf(value)) - value) <= std::abs(value) * (1.0F / 2048.0F));
+        }
+    }
+
+    SECTION("Out of range values")
+    {
+        REQUIRE(floatToHalf(1e6F) == 0x7C00U);
+        REQUIRE(floatToHalf(-1e6F) == 0xFC00U);
+        REQUIRE(floatToHalf(1e-9F) == 0x0000U);
+        REQUIRE(halfToFloat(0x7C00U) == std::numeric_limits<float>::infinity());
+    }
+}
@@ -0,0 +1,64 @@
+#include <catch2/catch.hpp>
+
+#include <thread>
+
+#include "Raychel/Misc/Concurrency/BoundedQueue.h"
+
+TEST_CASE("Bounded queue", "[Misc][Concurrency]")
+{
+    using namespace Raychel;
+
+    SECTION("Items come out in order")
+    {
+        BoundedQueue<int> queue{3};
+        for(int i = 0; i < 3; i++) {
+            int item = i;
+            REQUIRE(queue.push(std::move(item)));
+        }
+
+        int item = -1;
+        for(int i = 0; i < 3; i++) {
+            REQUIRE(queue.pop(item));
+            REQUIRE(item == i);
+        }
+    }
+
+    SECTION("Closing drains the queue and rejects pushes")
+    {
+        BoundedQueue<int> queue{2};
+        int item = 7;
+        REQUIRE(queue.push(std::move(item)));
+        queue.close();
+
+        item = 8;
+        REQUIRE_FALSE(queue.push(std::move(item)));
+
+        REQUIRE(queue.pop(item));
+        REQUIRE(item == 7);
+        REQUIRE_FALSE(queue.pop(item));
+    }
+
+    SECTION("The producer is throttled to the capacity")
+    {
+        constexpr int item_count = 1000;
+        BoundedQueue<int> queue{2};
+
+        std::thread producer{[&] {
+            for(int i = 0; i < item_count; i++) {
+                int item = i;
+                queue.push(std::move(item));
+            }
+            queue.close();
+        }};
+
+        int expected = 0;
+        int item = -1;
+        while(queue.pop(item)) {
+            REQUIRE(item == expected);
+            expected++;
+        }
+        producer.join();
+
+        REQUIRE(expected == item_count);
+    }
+}
@@ -0,0 +1,70 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Raychel/Misc/Concurrency/WorkStealingPool.h"
+
+TEST_CASE("Work stealing pool", "[Misc][Concurrency]")
+{
+    using namespace Raychel;
+
+    WorkStealingPool pool{GENERATE(size_t{1}, size_t{4})};
+
+    const auto run = [&pool](size_t count) {
+        std::vector<std::atomic_size_t> calls(count);
+        std::atomic_bool valid_worker{true};
+        pool.parallelFor(count, [&](size_t index, size_t worker_index) {
+            if(worker_index >= pool.size()) {
+                valid_worker = false;
+            }
+            //the first range is slow, so the other workers run dry early and have to steal from it
+            if(index < count / pool.size()) {
+                std::this_thread::sleep_for(std::chrono::microseconds{200});
+            }
+            calls[index]++;
+        });
+
+        REQUIRE(valid_worker);
+        for(const auto& call_count : calls) {
+            REQUIRE(call_count == 1);
+        }
+    };
+
+    SECTION("Every index runs once")
+    {
+        run(GENERATE(size_t{0}, size_t{1}, size_t{3}, size_t{257}));
+    }
+
+    SECTION("Repeated jobs")
+    {
+        for(size_t i = 0; i < 50; i++) {
+            run(i);
+        }
+    }
+}
+
+TEST_CASE("Work stealing pool reaches every worker", "[Misc][Concurrency]")
+{
+    using namespace Raychel;
+
+    WorkStealingPool pool{GENERATE(size_t{1}, size_t{4})};
+
+    for(size_t i = 0; i < 20; i++) {
+        std::vector<std::atomic_size_t> calls(pool.size());
+        std::vector<std::thread::id> threads(pool.size());
+        pool.forEachWorker([&](size_t worker_index) {
+            calls[worker_index]++;
+            threads[worker_index] = std::this_thread::get_id();
+        });
+
+        for(const auto& call_count : calls) {
+            REQUIRE(call_count == 1);
+        }
+        //every call ran on its own thread, so thread_local state of all workers was reached
+        std::sort(threads.begin(), threads.end());
+        REQUIRE(std::unique(threads.begin(), threads.end()) == threads.end());
+    }
+}
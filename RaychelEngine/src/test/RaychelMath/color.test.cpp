@@ -251,6 +251,15 @@ RAYCHEL_BEGIN_TEST("Color brightness", "[RaychelMath][ColorRGB]")
 
 RAYCHEL_END_TEST
 
+TEST_CASE("Color luminance", "[RaychelMath][ColorRGB]")
+{
+    using namespace Raychel;
+
+    REQUIRE(luminance(colorImp<double>{0.5, 0.5, 0.5}) == Approx(0.5));
+    REQUIRE(luminance(colorImp<double>{0, 1, 0}) == Approx(0.7152));
+    REQUIRE(luminance(colorImp<double>{0, 0, 1}) < luminance(colorImp<double>{1, 0, 0}));
+}
+
 // NOLINTNEXTLINE: i am using a *macro*! :O (despicable)
 TEST_CASE("Color conversion", "[RaychelMath][ColorRGB]")
 {
@@ -0,0 +1,204 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+namespace {
+
+    std::atomic_size_t allocation_count{0};
+
+}
+
+//count every heap allocation of the test binary, including the ones of the render threads. The array forms call these.
+//Over-aligned types like vec3Packet go through the std::align_val_t overloads, so they are replaced as well
+void* operator new(std::size_t size)
+{
+    allocation_count++;
+    if(void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, const std::nothrow_t& /*unused*/) noexcept
+{
+    allocation_count++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocation_count++;
+    //aligned_alloc needs the size to be a multiple of the alignment
+    const auto align = static_cast<std::size_t>(alignment);
+    if(void* p = std::aligned_alloc(align, ((size + align - 1) / align) * align)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t& /*unused*/) noexcept
+{
+    allocation_count++;
+    const auto align = static_cast<std::size_t>(alignment);
+    return std::aligned_alloc(align, ((size + align - 1) / align) * align);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*unused*/) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t& /*unused*/) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t /*unused*/) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*unused*/, std::align_val_t /*unused*/) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t /*unused*/, const std::nothrow_t& /*unused*/) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+    void fillScene(Raychel::Scene& scene)
+    {
+        using namespace Raychel;
+
+        scene.setBackgroundTexture({[](const vec3& dir) {
+            return color{dir};
+        }});
+
+        scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, DiffuseMaterial(color(1, 0, 0))), 1.0F);
+        scene.addObject<SdSphere>(make_object_data({vec3{2.5, 0, 0}, Quaternion{}}, DiffuseMaterial(color(0, 1, 0))), 1.0F);
+        scene.addObject<SdSphere>(make_object_data({vec3{0, 0, -2.5}, Quaternion{}}, DiffuseMaterial(color(0, 0, 1))), 1.0F);
+    }
+
+}
+
+TEST_CASE("Steady state rendering does not allocate", "[Rendering][Allocation]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    fillScene(scene);
+    auto& cam = scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    const vec2i size{48, 32};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    RenderOptions options;
+    const bool all_features = GENERATE(false, true);
+    if(all_features) {
+        options.use_ray_packets = true;
+        options.use_cone_prepass = true;
+        options.progressive = true;
+        options.doAA = true;
+        options.temporal_reprojection = true;
+        options.temporal_depth_seeding = true;
+        options.framebuffer_format = FramebufferFormat::rgba16f;
+        renderer.setPreviewCallback([](const FramebufferView& /*unused*/, size_t /*unused*/) {});
+    }
+    renderer.setRenderOptions(options);
+
+    SECTION("Caller provided framebuffer")
+    {
+        Framebuffer output{size, options.framebuffer_format};
+
+        //the first frame builds the scene data
+        REQUIRE(renderer.renderInto(output));
+
+        //REQUIRE might allocate itself, so the results are only checked afterwards
+        bool success = true;
+        const size_t allocations_before = allocation_count;
+        for(int frame = 0; frame < 4; frame++) {
+            cam.updateYaw(3_deg);
+            success = renderer.renderInto(output) && success;
+        }
+        const size_t allocations = allocation_count - allocations_before;
+
+        REQUIRE(success);
+        REQUIRE(allocations == 0);
+    }
+
+    SECTION("Pooled framebuffers")
+    {
+        //two frames in flight, like a render loop that writes the last frame while rendering the next one
+        auto previous = renderer.getImageRendered();
+        REQUIRE(previous.has_value());
+
+        for(int frame = 0; frame < 2; frame++) {
+            auto current = renderer.getImageRendered();
+            REQUIRE(current.has_value());
+            renderer.recycleFramebuffer(std::move(*previous));
+            previous = std::move(current);
+        }
+        const size_t pool_allocations = renderer.getFramebufferAllocationCount();
+
+        bool success = true;
+        const size_t allocations_before = allocation_count;
+        for(int frame = 0; frame < 4 && success; frame++) {
+            cam.updateYaw(3_deg);
+            auto current = renderer.getImageRendered();
+            success = current.has_value();
+            if(success) {
+                renderer.recycleFramebuffer(std::move(*previous));
+                previous = std::move(current);
+            }
+        }
+        const size_t allocations = allocation_count - allocations_before;
+
+        REQUIRE(success);
+        REQUIRE(allocations == 0);
+        REQUIRE(renderer.getFramebufferAllocationCount() == pool_allocations);
+    }
+}
+
+TEST_CASE("Allocation counting", "[Rendering][Allocation]")
+{
+    using namespace Raychel;
+
+    //the test above is only meaningful if every kind of allocation is seen
+    const size_t allocations_before = allocation_count;
+
+    //the pointers escape through volatile variables, so the allocations can't be optimized away
+    int* volatile plain = new int{};
+    int* volatile plain_nothrow = new(std::nothrow) int{};
+    vec3Packet* volatile aligned = new vec3Packet{};
+    vec3Packet* volatile aligned_nothrow = new(std::nothrow) vec3Packet{};
+    float* volatile array = new float[4];
+
+    const size_t allocations = allocation_count - allocations_before;
+
+    delete plain;
+    delete plain_nothrow;
+    delete aligned;
+    delete aligned_nothrow;
+    delete[] array;
+
+    REQUIRE(allocations == 5);
+}
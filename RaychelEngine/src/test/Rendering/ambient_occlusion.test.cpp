@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+TEST_CASE("Ambient occlusion field", "[Rendering][AmbientOcclusion]")
+{
+    using namespace Raychel;
+
+    WorkStealingPool workers{2};
+    AmbientOcclusionField field;
+    field.setBounds(BoundingBox{vec3{0, 0, 0}, vec3{4, 4, 4}}, 17);
+    REQUIRE(field.stats().grid_size == std::array<size_t, 3>{17, 17, 17});
+    REQUIRE(field.stats().block_count == 27);
+    REQUIRE(field.stats().memory_usage == (17 * 17 * 17) + 27);
+    REQUIRE(field.hasDirtyBlocks());
+
+    float occlusion = -1.0F;
+    REQUIRE_FALSE(field.occlusion(vec3{1, 1, 1}, occlusion));
+
+    const auto gradient = [](const vec3& p) {
+        return p.x / 4.0F;
+    };
+    field.update(gradient, workers);
+    REQUIRE(field.isBaked());
+    REQUIRE_FALSE(field.hasDirtyBlocks());
+    REQUIRE(field.stats().updated_sample_count == 17 * 17 * 17);
+
+    SECTION("Trilinear lookups")
+    {
+        for(const float x : {0.0F, 0.3F, 1.11F, 2.5F, 3.99F}) {
+            REQUIRE(field.occlusion(vec3{x, 1.7F, 3.2F}, occlusion));
+            REQUIRE(std::abs(occlusion - (x / 4.0F)) <= 0.5F / 255.0F);
+        }
+        REQUIRE_FALSE(field.occlusion(vec3{4.5F, 1, 1}, occlusion));
+    }
+
+    SECTION("Only dirty blocks are baked again")
+    {
+        field.markDirty(BoundingBox{vec3{0.2F, 0.2F, 0.2F}, vec3{0.4F, 0.4F, 0.4F}});
+        REQUIRE(field.hasDirtyBlocks());
+        field.update(
+            [](const vec3& /*unused*/) {
+                return 1.0F;
+            },
+            workers);
+        REQUIRE(field.stats().updated_block_count == 1);
+
+        REQUIRE(field.occlusion(vec3{0.25F, 0.25F, 0.25F}, occlusion));
+        REQUIRE(occlusion == 1.0F);
+        REQUIRE(field.occlusion(vec3{3.0F, 3.0F, 3.0F}, occlusion));
+        REQUIRE(std::abs(occlusion - 0.75F) <= 0.5F / 255.0F);
+    }
+}
+
+TEST_CASE("Ambient occlusion rendering", "[Rendering][AmbientOcclusion]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({color{1}});
+    //a floor at y = -1 with a ball lying on it
+    scene.addObject<SdSphere>(make_object_data({vec3{0, -6, 3}, Quaternion{}}, DiffuseMaterial(color{1})), 5.0F);
+    scene.addObject<SdSphere>(make_object_data({vec3{0, -0.5F, 3}, Quaternion{}}, DiffuseMaterial(color{1})), 0.5F);
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    const vec2i size{32, 32};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    const auto render = [&](AmbientOcclusionMode mode) {
+        RenderOptions options;
+        options.ambient_occlusion = mode;
+        options.ao_field_resolution = 64;
+        renderer.setRenderOptions(options);
+
+        auto image = renderer.getImageRendered();
+        REQUIRE(image.has_value());
+        std::vector<float> pixels;
+        for(size_t i = 0; i < image->pixelCount(); i++) {
+            pixels.push_back(image->load(i).r);
+        }
+        return pixels;
+    };
+
+    const std::vector<float> unoccluded = render(AmbientOcclusionMode::none);
+    const std::vector<float> exact = render(AmbientOcclusionMode::sdf);
+    const std::vector<float> baked = render(AmbientOcclusionMode::baked);
+    REQUIRE(renderer.getAmbientOcclusionFieldStats().updated_block_count == renderer.getAmbientOcclusionFieldStats().block_count);
+
+    //the contact between ball and floor is darkened, and the baked field agrees with the exact occlusion
+    float darkest = 1.0F;
+    float error = 0.0F;
+    for(size_t i = 0; i < unoccluded.size(); i++) {
+        REQUIRE(exact[i] <= unoccluded[i] + 1e-4F);
+        darkest = std::min(darkest, exact[i]);
+        error += std::abs(exact[i] - baked[i]);
+    }
+    REQUIRE(darkest < 0.5F);
+    REQUIRE(error / static_cast<float>(unoccluded.size()) < 0.01F);
+
+    //nothing changed, nothing is baked
+    render(AmbientOcclusionMode::baked);
+    REQUIRE(renderer.getAmbientOcclusionFieldStats().updated_block_count == 0);
+
+    renderer.invalidateScene(BoundingBox{vec3{-0.5F, -1, 2.5F}, vec3{0.5F, 0, 3.5F}});
+    render(AmbientOcclusionMode::baked);
+    REQUIRE(renderer.getAmbientOcclusionFieldStats().updated_block_count > 0);
+    REQUIRE(renderer.getAmbientOcclusionFieldStats().updated_block_count < renderer.getAmbientOcclusionFieldStats().block_count);
+}
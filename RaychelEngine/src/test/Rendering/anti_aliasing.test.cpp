@@ -0,0 +1,259 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+namespace {
+
+    //flat colors, darker where the surface is closer than split_depth or left of split_x
+    class SplitMaterial final : public Raychel::Material {
+
+    public:
+
+        SplitMaterial(float split_x, float split_depth)
+            :split_x_{split_x}, split_depth_{split_depth}
+        {}
+
+        SplitMaterial(SplitMaterial&& rhs) noexcept
+            :split_x_{rhs.split_x_}, split_depth_{rhs.split_depth_}
+        {}
+
+        void initializeTextureProviders(const Raychel::vec3& /*unused*/, const Raychel::vec3& /*unused*/) override
+        {}
+
+        Raychel::color getSurfaceColor(const Raychel::ShadingData& data) const override
+        {
+            const bool dark = data.surface_point.x < split_x_ || data.surface_point.z < split_depth_;
+            return Raychel::color{dark ? 0.2F : 0.8F};
+        }
+
+    private:
+
+        float split_x_, split_depth_;
+    };
+
+    //a wall facing the camera with a box in front of it. Both are one object, so only the depth changes at the edges of the box
+    class BoxOnWall final : public Raychel::SdObject {
+
+    public:
+
+        BoxOnWall(Raychel::ObjectData&& data, float wall_depth, const Raychel::vec3& half_size)
+            :SdObject{std::move(data)}, wall_depth_{wall_depth}, box_half_size_{half_size}
+        {}
+
+        float eval(const Raychel::vec3& p) const override
+        {
+            using namespace Raychel;
+            const vec3 d = p - transform().position;
+            const vec3 q{std::abs(d.x) - box_half_size_.x, std::abs(d.y) - box_half_size_.y, std::abs(d.z) - box_half_size_.z};
+            const float box = mag(vec3{std::max(q.x, 0.0F), std::max(q.y, 0.0F), std::max(q.z, 0.0F)}) + std::min(std::max(q.x, std::max(q.y, q.z)), 0.0F);
+            return std::min(box, wall_depth_ - p.z);
+        }
+
+    private:
+
+        float wall_depth_;
+        Raychel::vec3 box_half_size_;
+    };
+
+    const Raychel::vec2i size{48, 32};
+
+    void setUpScene(Raychel::Scene& scene, float background)
+    {
+        using namespace Raychel;
+        scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 1.0F});
+        scene.setBackgroundTexture({[background](const vec3& /*unused*/) {
+            return color{background};
+        }});
+    }
+
+    //walls without a box hide it behind them
+    const Raychel::vec3 no_box_position{0, 0, 20};
+    const float no_wall = std::numeric_limits<float>::infinity();
+
+    //the front of the box faces the camera, so its depth changes slowly
+    const Raychel::vec3 box_position{0.3F, -0.2F, 4};
+    const Raychel::vec3 box_half_size{1.0F, 0.7F, 0.5F};
+
+    struct AntiAliasedFrame
+    {
+        Raychel::Framebuffer image;
+        Raychel::AntiAliasingStats stats;
+    };
+
+    AntiAliasedFrame renderFrame(Raychel::Scene& scene, bool anti_alias, size_t grid_size)
+    {
+        using namespace Raychel;
+
+        RenderOptions options;
+        options.doAA = anti_alias;
+        options.aa_grid_size = grid_size;
+
+        RenderController renderer;
+        renderer.setCurrentScene(&scene);
+        renderer.setOutputSize(size);
+        renderer.setRenderOptions(options);
+
+        Framebuffer output{size, FramebufferFormat::rgb32f};
+        REQUIRE(renderer.renderInto(output));
+        return {std::move(output), renderer.getAntiAliasingStats()};
+    }
+
+    //pixels with a neighbour that differs in luminance by more than the default threshold, like the renderer finds them
+    std::vector<bool> findEdges(const Raychel::Framebuffer& image)
+    {
+        using namespace Raychel;
+
+        const auto differs = [&](size_t x, size_t y, size_t other_x, size_t other_y) {
+            return std::abs(luminance(image.load((y * size.x) + x)) - luminance(image.load((other_y * size.x) + other_x))) > 0.1F;
+        };
+
+        std::vector<bool> edges(image.pixelCount());
+        for(size_t y = 0; y < size.y; y++) {
+            for(size_t x = 0; x < size.x; x++) {
+                edges[(y * size.x) + x] = (x != 0 && differs(x, y, x - 1, y)) ||
+                                          (y != 0 && differs(x, y, x, y - 1)) ||
+                                          (x + 1 < size.x && differs(x, y, x + 1, y)) ||
+                                          (y + 1 < size.y && differs(x, y, x, y + 1));
+            }
+        }
+        return edges;
+    }
+
+    //refines exactly the edges of reference and keeps every other pixel of unrefined
+    void requireRefinedEdges(const AntiAliasedFrame& frame, const Raychel::Framebuffer& reference, const Raychel::Framebuffer& unrefined, size_t grid_size)
+    {
+        const std::vector<bool> edges = findEdges(reference);
+        const auto edge_count = static_cast<size_t>(std::count(edges.begin(), edges.end(), true));
+        REQUIRE(edge_count != 0);
+
+        REQUIRE(frame.stats.pixel_count == frame.image.pixelCount());
+        REQUIRE(frame.stats.refined_pixel_count == edge_count);
+        REQUIRE(frame.stats.subsample_count == edge_count * ((grid_size * grid_size) - 1));
+        REQUIRE(frame.stats.refinedFraction() == Approx(static_cast<double>(edge_count) / static_cast<double>(frame.image.pixelCount())));
+
+        for(size_t i = 0; i < edges.size(); i++) {
+            if(!edges[i]) {
+                INFO("pixel " << i);
+                REQUIRE(frame.image.load(i).r == unrefined.load(i).r);
+            }
+        }
+    }
+
+}
+
+TEST_CASE("Adaptive anti-aliasing", "[Rendering][AntiAliasing]")
+{
+    using namespace Raychel;
+
+    const size_t grid_size = GENERATE(2, 3, 4);
+
+    Scene scene;
+
+    SECTION("Flat regions are not refined")
+    {
+        setUpScene(scene, 1.0F);
+        scene.addObject<BoxOnWall>(make_object_data({no_box_position, Quaternion{}}, DiffuseMaterial(color{0.5F})), 6.0F, vec3{0, 0, 0});
+
+        const AntiAliasedFrame frame = renderFrame(scene, true, grid_size);
+        REQUIRE(frame.stats.pixel_count == frame.image.pixelCount());
+        REQUIRE(frame.stats.refined_pixel_count == 0);
+        REQUIRE(frame.stats.subsample_count == 0);
+        REQUIRE(frame.stats.refinedFraction() == 0.0);
+
+        const AntiAliasedFrame unrefined = renderFrame(scene, false, grid_size);
+        for(size_t i = 0; i < frame.image.pixelCount(); i++) {
+            REQUIRE(frame.image.load(i).r == unrefined.image.load(i).r);
+        }
+    }
+
+    SECTION("Object edges")
+    {
+        //the box and the background look the same, so only the object differs at its outline
+        setUpScene(scene, 1.0F);
+        scene.addObject<BoxOnWall>(make_object_data({box_position, Quaternion{}}, DiffuseMaterial(color{1})), no_wall, box_half_size);
+        const AntiAliasedFrame frame = renderFrame(scene, true, grid_size);
+        const AntiAliasedFrame unrefined = renderFrame(scene, false, grid_size);
+
+        Scene reference_scene;
+        setUpScene(reference_scene, 0.0F);
+        reference_scene.addObject<BoxOnWall>(make_object_data({box_position, Quaternion{}}, DiffuseMaterial(color{1})), no_wall, box_half_size);
+        const AntiAliasedFrame reference = renderFrame(reference_scene, false, grid_size);
+
+        requireRefinedEdges(frame, reference.image, unrefined.image, grid_size);
+    }
+
+    SECTION("Depth edges")
+    {
+        setUpScene(scene, 0.0F);
+        scene.addObject<BoxOnWall>(make_object_data({box_position, Quaternion{}}, DiffuseMaterial(color{1})), 8.0F, box_half_size);
+        const AntiAliasedFrame frame = renderFrame(scene, true, grid_size);
+        const AntiAliasedFrame unrefined = renderFrame(scene, false, grid_size);
+
+        //the same object, colored by depth
+        Scene reference_scene;
+        setUpScene(reference_scene, 0.0F);
+        reference_scene.addObject<BoxOnWall>(make_object_data({box_position, Quaternion{}}, SplitMaterial{-100.0F, 6.0F}), 8.0F, box_half_size);
+        const AntiAliasedFrame reference = renderFrame(reference_scene, false, grid_size);
+
+        requireRefinedEdges(frame, reference.image, unrefined.image, grid_size);
+    }
+
+    SECTION("Luminance edges")
+    {
+        setUpScene(scene, 0.0F);
+        scene.addObject<BoxOnWall>(make_object_data({no_box_position, Quaternion{}}, SplitMaterial{0.4F, 0.0F}), 6.0F, vec3{0, 0, 0});
+        const AntiAliasedFrame frame = renderFrame(scene, true, grid_size);
+        const AntiAliasedFrame unrefined = renderFrame(scene, false, grid_size);
+
+        requireRefinedEdges(frame, unrefined.image, unrefined.image, grid_size);
+    }
+}
+
+TEST_CASE("Anti-aliasing stats", "[Rendering][AntiAliasing]")
+{
+    using namespace Raychel;
+
+    //the scene of the demo program. Its edges are the outlines of the spheres and the gradient of the background
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return color{dir};
+    }});
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, DiffuseMaterial(color(1, 0, 0))), 1.0F);
+    scene.addObject<SdSphere>(make_object_data({vec3{2.5, 0, 0}, Quaternion{}}, DiffuseMaterial(color(0, 1, 0))), 1.0F);
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, -2.5}, Quaternion{}}, DiffuseMaterial(color(0, 0, 1))), 1.0F);
+    scene.addObject<SdSphere>(make_object_data({vec3{-2.5, 0, 0}, Quaternion{}}, DiffuseMaterial(color(1))), 1.0F);
+
+    const vec2i frame_size{96, 64};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(frame_size);
+
+    RenderOptions options;
+    options.doAA = true;
+    renderer.setRenderOptions(options);
+
+    Framebuffer output{frame_size, FramebufferFormat::rgb32f};
+    REQUIRE(renderer.renderInto(output));
+
+    const AntiAliasingStats& stats = renderer.getAntiAliasingStats();
+    REQUIRE(stats.pixel_count == 6144);
+    REQUIRE(stats.refined_pixel_count == 208);
+    REQUIRE(stats.subsample_count == 208 * 8);
+    REQUIRE(stats.refinedFraction() == Approx(208.0 / 6144.0));
+
+    //disabling anti-aliasing clears the counters
+    options.doAA = false;
+    renderer.setRenderOptions(options);
+    REQUIRE(renderer.renderInto(output));
+    REQUIRE(renderer.getAntiAliasingStats().refined_pixel_count == 0);
+    REQUIRE(renderer.getAntiAliasingStats().refinedFraction() == 0.0);
+}
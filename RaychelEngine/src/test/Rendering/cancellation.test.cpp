@@ -0,0 +1,199 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+TEST_CASE("Render cancellation", "[Rendering][Cancellation]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return color{dir};
+    }});
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, DiffuseMaterial(color(1, 0, 0))), 1.0F);
+    scene.addObject<SdSphere>(make_object_data({vec3{2.5, 0, 0}, Quaternion{}}, DiffuseMaterial(color(0, 1, 0))), 1.0F);
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    const vec2i size{256, 128};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    RenderOptions options;
+    const bool all_features = GENERATE(false, true);
+    if(all_features) {
+        options.progressive = true;
+        options.doAA = true;
+        options.temporal_reprojection = true;
+    }
+    renderer.setRenderOptions(options);
+
+    Framebuffer expected{size, options.framebuffer_format};
+    REQUIRE(renderer.renderInto(expected));
+    const size_t tile_count = renderer.getTiles().size();
+
+    Framebuffer output{size, options.framebuffer_format};
+
+    SECTION("A missed deadline stops the frame before any tile")
+    {
+        const FrameResult result = renderer.renderInto(output, FrameBudget{nullptr, std::chrono::steady_clock::now()});
+        REQUIRE(result.status == FrameStatus::cancelled);
+        REQUIRE(result.completed_tile_count == 0);
+        for(size_t i = 0; i < tile_count; i++) {
+            REQUIRE_FALSE(renderer.isTileCompleted(i));
+        }
+    }
+
+    SECTION("Cancelling mid-frame keeps the completed tiles")
+    {
+        CancellationToken token;
+        std::atomic_size_t streamed_tiles{0};
+        renderer.setTileCallback([&](const Tile& /*unused*/, const FramebufferView& /*unused*/) {
+            if(++streamed_tiles == 4) {
+                token.cancel();
+            }
+        });
+
+        const FrameResult result = renderer.renderInto(output, FrameBudget{&token, std::nullopt});
+        REQUIRE(result.status == FrameStatus::cancelled);
+        REQUIRE(result.completed_tile_count >= 4);
+        REQUIRE(result.completed_tile_count < tile_count);
+        REQUIRE(result.completed_tile_count == streamed_tiles);
+
+        size_t completed = 0;
+        for(size_t i = 0; i < tile_count; i++) {
+            if(!renderer.isTileCompleted(i)) {
+                continue;
+            }
+            completed++;
+
+            const Tile& tile = renderer.getTiles()[i];
+            for(size_t y = tile.origin.y; y < tile.origin.y + tile.size.y; y++) {
+                for(size_t x = tile.origin.x; x < tile.origin.x + tile.size.x; x++) {
+                    REQUIRE(output.at(vec2i{x, y}) == expected.at(vec2i{x, y}));
+                }
+            }
+        }
+        REQUIRE(completed == result.completed_tile_count);
+
+        //the next frame is not affected by the cancelled one
+        renderer.setTileCallback(nullptr);
+        const FrameResult next = renderer.renderInto(output, FrameBudget{});
+        REQUIRE(next.status == FrameStatus::complete);
+        REQUIRE(next.completed_tile_count == tile_count);
+        for(size_t i = 0; i < output.pixelCount(); i++) {
+            REQUIRE(output.load(i) == expected.load(i));
+        }
+    }
+}
+
+namespace {
+
+    Raychel::CancellationToken* shading_cancels{nullptr};
+
+    //cancels shading_cancels whenever it is shaded, so a bake that sees it stops part way
+    class CancellingMaterial final : public Raychel::Material {
+
+    public:
+
+        CancellingMaterial()=default;
+
+        CancellingMaterial(CancellingMaterial&& /*unused*/) noexcept
+        {}
+
+        void initializeTextureProviders(const Raychel::vec3& /*unused*/, const Raychel::vec3& /*unused*/) override
+        {}
+
+        Raychel::color getSurfaceColor(const Raychel::ShadingData& /*unused*/) const override
+        {
+            if(shading_cancels) {
+                shading_cancels->cancel();
+            }
+            return Raychel::color{1};
+        }
+    };
+
+}
+
+TEST_CASE("Bake cancellation", "[Rendering][Cancellation]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return color{dir};
+    }});
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, ReflectiveMaterial(color{1}, 0.8F, 0.5F)), 1.0F);
+    scene.addObject<SdSphere>(make_object_data({vec3{1.5, 0, 1.5}, Quaternion{}}, CancellingMaterial{}), 0.5F);
+    scene.addReflectionProbe(vec3{0, 0, 0.5F}, BoundingBox{vec3{-4, -4, -2}, vec3{4, 4, 6}});
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    const vec2i size{32, 32};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    RenderOptions options;
+    options.use_sdf_cache = true;
+    options.sdf_cache_memory_budget = 1U << 20U;
+    options.use_irradiance_volume = true;
+    options.irradiance_probe_spacing = 0.5F;
+    options.irradiance_probe_rays = 16;
+    options.use_reflection_probes = true;
+    options.reflection_probe_resolution = 8;
+    options.ambient_occlusion = AmbientOcclusionMode::baked;
+    options.ao_field_resolution = 16;
+    renderer.setRenderOptions(options);
+
+    Framebuffer output{size, options.framebuffer_format};
+
+    SECTION("A missed deadline skips every bake")
+    {
+        REQUIRE(renderer.renderInto(output, FrameBudget{nullptr, std::chrono::steady_clock::now()}).status == FrameStatus::cancelled);
+        REQUIRE(renderer.getSdfCacheStats().brick_count == 0);
+        REQUIRE(renderer.getAmbientOcclusionFieldStats().updated_block_count == 0);
+        REQUIRE(renderer.getIrradianceVolumeStats().updated_probe_count == 0);
+        REQUIRE(renderer.getReflectionProbeStats().updated_probe_count == 0);
+
+        //the next frame bakes everything
+        REQUIRE(renderer.renderInto(output, FrameBudget{}).status == FrameStatus::complete);
+        REQUIRE(renderer.getSdfCacheStats().brick_count != 0);
+        REQUIRE(renderer.getAmbientOcclusionFieldStats().updated_block_count == renderer.getAmbientOcclusionFieldStats().block_count);
+        REQUIRE(renderer.getIrradianceVolumeStats().updated_probe_count == renderer.getIrradianceVolumeStats().probe_count);
+        REQUIRE(renderer.getReflectionProbeStats().updated_probe_count == 1);
+
+        //an update after a change is skipped as well and stays dirty
+        renderer.invalidateScene(BoundingBox{vec3{1, -0.5F, 1}, vec3{2, 0.5F, 2}});
+        REQUIRE(renderer.renderInto(output, FrameBudget{nullptr, std::chrono::steady_clock::now()}).status == FrameStatus::cancelled);
+        REQUIRE(renderer.getReflectionProbeStats().updated_probe_count == 0);
+        REQUIRE(renderer.renderInto(output, FrameBudget{}).status == FrameStatus::complete);
+        REQUIRE(renderer.getReflectionProbeStats().updated_probe_count == 1);
+        REQUIRE(renderer.getIrradianceVolumeStats().updated_probe_count != 0);
+    }
+
+    SECTION("Cancelling mid-bake keeps the baked probes")
+    {
+        //the first irradiance probe ray that hits the small sphere cancels the frame
+        CancellationToken token;
+        shading_cancels = &token;
+        const FrameResult result = renderer.renderInto(output, FrameBudget{&token, std::nullopt});
+        shading_cancels = nullptr;
+        REQUIRE(result.status == FrameStatus::cancelled);
+        REQUIRE(result.completed_tile_count == 0);
+
+        const IrradianceVolumeStats partial = renderer.getIrradianceVolumeStats();
+        REQUIRE(partial.updated_probe_count < partial.probe_count);
+        REQUIRE(renderer.getReflectionProbeStats().updated_probe_count == 0);
+
+        //the next frame only bakes what is left
+        REQUIRE(renderer.renderInto(output, FrameBudget{}).status == FrameStatus::complete);
+        REQUIRE(renderer.getIrradianceVolumeStats().updated_probe_count == partial.probe_count - partial.updated_probe_count);
+        REQUIRE(renderer.getReflectionProbeStats().updated_probe_count == 1);
+    }
+}
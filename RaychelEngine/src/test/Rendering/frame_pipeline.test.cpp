@@ -0,0 +1,217 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+#include "Raychel/Engine/Rendering/RenderTarget/RenderTarget.h"
+
+namespace {
+
+    //not derived from std::exception
+    struct DiskFullError
+    {};
+
+    //records the summed up color of every frame
+    class RecordingTarget : public Raychel::RenderTarget {
+
+    public:
+
+        RecordingTarget(const Raychel::vec2i& size, size_t fail_at, bool throw_unknown=false)
+            :RenderTarget{size}, fail_at_{fail_at}, throw_unknown_{throw_unknown}
+        {}
+
+        void writeFramebuffer(const Raychel::FramebufferView& framebuffer) override
+        {
+            if(frames.size() == fail_at_) {
+                if(throw_unknown_) {
+                    throw DiskFullError{};
+                }
+                throw std::runtime_error{"disk full"};
+            }
+
+            //slower than rendering, so the queue fills up
+            std::this_thread::sleep_for(std::chrono::milliseconds{2});
+
+            Raychel::color sum;
+            for(size_t i = 0; i < framebuffer.pixelCount(); i++) {
+                sum += framebuffer.load(i);
+            }
+            frames.push_back(sum);
+        }
+
+        std::vector<Raychel::color> frames;
+
+    private:
+
+        size_t fail_at_;
+        bool throw_unknown_;
+    };
+
+    //copies the tiles of every frame into an image of its own
+    class StreamingTarget : public Raychel::RenderTarget {
+
+    public:
+
+        explicit StreamingTarget(const Raychel::vec2i& size)
+            :RenderTarget{size}, image(size.x * size.y), tile_count(size.x * size.y)
+        {}
+
+        bool streamsTiles() const noexcept override
+        {
+            return true;
+        }
+
+        void beginFrame() override
+        {
+            REQUIRE_FALSE(in_frame);
+            in_frame = true;
+            std::fill(tile_count.begin(), tile_count.end(), 0U);
+        }
+
+        void writeTile(const Raychel::Tile& tile, const Raychel::FramebufferView& framebuffer) override
+        {
+            //Catch2 assertions are not thread-safe, so errors are only recorded here
+            tile_outside_frame = tile_outside_frame || !in_frame;
+            for(size_t y = tile.origin.y; y < tile.origin.y + tile.size.y; y++) {
+                for(size_t x = tile.origin.x; x < tile.origin.x + tile.size.x; x++) {
+                    image[(y * size().x) + x] = framebuffer.at(Raychel::vec2i{x, y});
+                    tile_count[(y * size().x) + x]++;
+                }
+            }
+        }
+
+        void endFrame() override
+        {
+            REQUIRE(in_frame);
+            in_frame = false;
+            frame_count++;
+        }
+
+        void writeFramebuffer(const Raychel::FramebufferView& /*unused*/) override
+        {
+            FAIL("Streaming targets only get tiles");
+        }
+
+        std::vector<Raychel::color> image;
+        std::vector<std::uint32_t> tile_count;
+        size_t frame_count{0};
+        bool in_frame{false};
+        bool tile_outside_frame{false};
+    };
+
+}
+
+TEST_CASE("Pipelined frame loop", "[Rendering][Pipeline]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return color{dir};
+    }});
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, DiffuseMaterial(color(1, 0, 0))), 1.0F);
+    auto& cam = scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    const vec2i size{16, 16};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    constexpr size_t frame_count = 12;
+    const auto turn_camera = [&](size_t frame_index) {
+        if(frame_index != 0) {
+            cam.updateYaw(10_deg);
+        }
+        return frame_index < frame_count;
+    };
+
+    SECTION("Every frame is written in order")
+    {
+        //reference frames, rendered one after the other
+        const Camera start_cam = cam;
+        std::vector<color> expected;
+        for(size_t i = 0; turn_camera(i); i++) {
+            auto framebuffer = renderer.getImageRendered();
+            REQUIRE(framebuffer.has_value());
+
+            color sum;
+            for(size_t p = 0; p < framebuffer->pixelCount(); p++) {
+                sum += framebuffer->load(p);
+            }
+            expected.push_back(sum);
+            renderer.recycleFramebuffer(std::move(*framebuffer));
+        }
+        cam = start_cam;
+
+        constexpr size_t queue_depth = 2;
+        const size_t allocations_before = renderer.getFramebufferAllocationCount();
+
+        RecordingTarget target{size, frame_count};
+        REQUIRE(renderer.renderToTarget(target, turn_camera, queue_depth) == frame_count);
+        REQUIRE(target.frames.size() == frame_count);
+        for(size_t i = 0; i < frame_count; i++) {
+            REQUIRE(target.frames[i].r == Approx(expected[i].r));
+            REQUIRE(target.frames[i].g == Approx(expected[i].g));
+            REQUIRE(target.frames[i].b == Approx(expected[i].b));
+        }
+
+        //the writer hands all framebuffers back, so the pool only ever needs queue_depth + 2 of them
+        REQUIRE(renderer.getFramebufferAllocationCount() - allocations_before <= queue_depth + 2);
+    }
+
+    SECTION("A failing write stops the loop")
+    {
+        const bool throw_unknown = GENERATE(false, true);
+        RecordingTarget target{size, 3, throw_unknown};
+        REQUIRE(renderer.renderToTarget(target, turn_camera, 2) == 3);
+        REQUIRE(target.frames.size() == 3);
+    }
+}
+
+TEST_CASE("Tile streaming", "[Rendering][Pipeline]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return color{dir};
+    }});
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, DiffuseMaterial(color(1, 0, 0))), 1.0F);
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    const vec2i size{37, 21};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    RenderOptions options;
+    options.tile_size = 8;
+    const bool all_features = GENERATE(false, true);
+    if(all_features) {
+        options.progressive = true;
+        options.doAA = true;
+        options.use_cone_prepass = true;
+    }
+    renderer.setRenderOptions(options);
+
+    const auto expected = renderer.getImageRendered();
+    REQUIRE(expected.has_value());
+
+    StreamingTarget target{size};
+    REQUIRE(renderer.renderToTarget(target, [](size_t frame_index) { return frame_index < 2; }) == 2);
+
+    REQUIRE(target.frame_count == 2);
+    REQUIRE_FALSE(target.in_frame);
+    REQUIRE_FALSE(target.tile_outside_frame);
+    for(size_t i = 0; i < target.image.size(); i++) {
+        //every pixel arrives exactly once, with its final value
+        REQUIRE(target.tile_count[i] == 1);
+        REQUIRE(target.image[i] == expected->load(i));
+    }
+}
@@ -0,0 +1,150 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+#include "Raychel/Engine/Rendering/FramebufferPool.h"
+
+namespace {
+
+    constexpr std::array<Raychel::FramebufferFormat, 4> all_formats{
+        Raychel::FramebufferFormat::rgb32f,
+        Raychel::FramebufferFormat::rgba16f,
+        Raychel::FramebufferFormat::rgb10a2,
+        Raychel::FramebufferFormat::srgba8,
+    };
+
+    Raychel::color roundTrip(Raychel::FramebufferFormat format, const Raychel::color& c)
+    {
+        Raychel::Framebuffer framebuffer{Raychel::vec2i{1, 1}, format};
+        framebuffer.store(0, c);
+        return framebuffer.load(0);
+    }
+
+}
+
+TEST_CASE("Framebuffer pixel sizes", "[Rendering][Framebuffer]")
+{
+    using namespace Raychel;
+
+    REQUIRE(framebufferPixelSize(FramebufferFormat::rgb32f) == 12);
+    REQUIRE(framebufferPixelSize(FramebufferFormat::rgba16f) == 8);
+    REQUIRE(framebufferPixelSize(FramebufferFormat::rgb10a2) == 4);
+    REQUIRE(framebufferPixelSize(FramebufferFormat::srgba8) == 4);
+
+    for(const auto format : all_formats) {
+        const Framebuffer framebuffer{vec2i{7, 5}, format};
+        REQUIRE(framebuffer.memoryUsage() == 7 * 5 * framebufferPixelSize(format));
+    }
+}
+
+TEST_CASE("Framebuffer pixel formats", "[Rendering][Framebuffer]")
+{
+    using namespace Raychel;
+
+    SECTION("rgb32f is exact")
+    {
+        const color c{0.123F, 4.5F, 1e-7F};
+        REQUIRE(roundTrip(FramebufferFormat::rgb32f, c) == c);
+    }
+
+    SECTION("rgba16f keeps values above 1")
+    {
+        const color c{0.3F, 7.25F, 100.0F};
+        const color result = roundTrip(FramebufferFormat::rgba16f, c);
+        REQUIRE(std::abs(result.r - c.r) <= c.r / 2048.0F);
+        REQUIRE(result.g == c.g);
+        REQUIRE(result.b == c.b);
+    }
+
+    SECTION("rgb10a2 clamps and quantizes")
+    {
+        const color result = roundTrip(FramebufferFormat::rgb10a2, color{-1.0F, 0.4F, 3.0F});
+        REQUIRE(result.r == 0.0F);
+        REQUIRE(std::abs(result.g - 0.4F) <= 0.5F / 1023.0F);
+        REQUIRE(result.b == 1.0F);
+    }
+
+    SECTION("srgba8 is more precise in dark values")
+    {
+        const color dark = roundTrip(FramebufferFormat::srgba8, color{0.01F});
+        const color bright = roundTrip(FramebufferFormat::srgba8, color{0.8F});
+        REQUIRE(std::abs(dark.r - 0.01F) < 0.0005F);
+        REQUIRE(std::abs(bright.r - 0.8F) < 0.005F);
+        REQUIRE(roundTrip(FramebufferFormat::srgba8, color{0.0F}).r == 0.0F);
+        REQUIRE(roundTrip(FramebufferFormat::srgba8, color{2.0F}).r == 1.0F);
+    }
+
+    SECTION("Storing a loaded value does not change it")
+    {
+        for(const auto format : all_formats) {
+            for(float value = 0.0F; value < 1.0F; value += 0.0137F) {
+                const color once = roundTrip(format, color{value, 1.0F - value, value * value});
+                REQUIRE(roundTrip(format, once) == once);
+            }
+        }
+    }
+}
+
+TEST_CASE("Framebuffer addressing", "[Rendering][Framebuffer]")
+{
+    using namespace Raychel;
+
+    const vec2i size{5, 3};
+    for(const auto format : all_formats) {
+        Framebuffer framebuffer{size, format};
+        for(size_t y = 0; y < size.y; y++) {
+            for(size_t x = 0; x < size.x; x++) {
+                framebuffer.store(vec2i{x, y}, color{static_cast<float>(x) / 8.0F, static_cast<float>(y) / 4.0F, 0.5F});
+            }
+        }
+
+        const FramebufferView view = framebuffer;
+        REQUIRE(view.size() == size);
+        REQUIRE(view.format() == format);
+        REQUIRE(view.load(7) == framebuffer.at(vec2i{2, 1}));
+
+        std::array<color, 5> row;
+        view.loadRow(2, row.data());
+        for(size_t x = 0; x < size.x; x++) {
+            REQUIRE(row[x] == view.at(vec2i{x, 2}));
+        }
+    }
+}
+
+TEST_CASE("Framebuffer pool", "[Rendering][Framebuffer]")
+{
+    using namespace Raychel;
+
+    FramebufferPool pool;
+
+    SECTION("Released memory is reused")
+    {
+        Framebuffer first = pool.acquire(vec2i{64, 64}, FramebufferFormat::rgb32f);
+        const std::uint32_t* memory = first.view().data();
+        pool.release(std::move(first));
+        REQUIRE(first.pixelCount() == 0);
+
+        //smaller requests fit into the same memory
+        Framebuffer second = pool.acquire(vec2i{32, 64}, FramebufferFormat::rgba16f);
+        REQUIRE(second.view().data() == memory);
+        REQUIRE(pool.allocationCount() == 1);
+
+        Framebuffer third = pool.acquire(vec2i{64, 64}, FramebufferFormat::rgb32f);
+        REQUIRE(third.view().data() != memory);
+        REQUIRE(pool.allocationCount() == 2);
+    }
+
+    SECTION("Huge page memory")
+    {
+        pool.setUseHugePages(true);
+
+        const vec2i size{1024, 1024};
+        Framebuffer framebuffer = pool.acquire(size, FramebufferFormat::rgba16f);
+        framebuffer.store(vec2i{1023, 1023}, color{0.5F});
+        REQUIRE(framebuffer.at(vec2i{1023, 1023}) == color{0.5F});
+
+        pool.release(std::move(framebuffer));
+        REQUIRE(pool.acquire(size, FramebufferFormat::rgba16f).size() == size);
+        REQUIRE(pool.allocationCount() == 1);
+    }
+}
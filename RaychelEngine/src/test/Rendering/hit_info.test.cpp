@@ -0,0 +1,200 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <random>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+namespace {
+
+    struct RecordedHit
+    {
+        size_t object;
+        Raychel::vec3 surface_point, normal;
+    };
+
+    struct HitLog
+    {
+        std::mutex mutex;
+        std::vector<RecordedHit> hits;
+    };
+
+    //records every hit on its object, so the hit info the renderer computed can be checked afterwards
+    class RecordingMaterial final : public Raychel::Material {
+
+    public:
+
+        RecordingMaterial(size_t object, HitLog& log)
+            :object_{object}, log_{log}
+        {}
+
+        RecordingMaterial(RecordingMaterial&& rhs) noexcept
+            :object_{rhs.object_}, log_{rhs.log_}
+        {}
+
+        void initializeTextureProviders(const Raychel::vec3& /*unused*/, const Raychel::vec3& /*unused*/) override
+        {}
+
+        Raychel::color getSurfaceColor(const Raychel::ShadingData& data) const override
+        {
+            std::scoped_lock lock{log_.mutex};
+            log_.hits.push_back({object_, data.surface_point, data.hit_normal});
+            return Raychel::color{1};
+        }
+
+    private:
+
+        size_t object_;
+        HitLog& log_;
+    };
+
+    //a sphere that stays a separate object in the BVH, so many of them can be close to a hit at once
+    struct UncompiledSphere : public Raychel::SdSphere
+    {
+        using SdSphere::SdSphere;
+
+        bool compileInto(Raychel::PrimitiveStore& /*unused*/) const override
+        {
+            return false;
+        }
+    };
+
+    struct SphereShape
+    {
+        Raychel::vec3 center;
+        float radius;
+    };
+
+    //the scene SDF, evaluated without the renderer
+    float sdSpheres(const std::vector<SphereShape>& shapes, const Raychel::vec3& p)
+    {
+        float d = std::numeric_limits<float>::max();
+        for(const auto& [center, radius] : shapes) {
+            d = std::min(d, Raychel::dist(p, center) - radius);
+        }
+        return d;
+    }
+
+    Raychel::vec3 centralDifferenceNormal(const std::vector<SphereShape>& shapes, const Raychel::vec3& p)
+    {
+        using namespace Raychel;
+        constexpr float h = 1e-3F;
+        return normalize(vec3{
+            sdSpheres(shapes, p + vec3{h, 0, 0}) - sdSpheres(shapes, p - vec3{h, 0, 0}),
+            sdSpheres(shapes, p + vec3{0, h, 0}) - sdSpheres(shapes, p - vec3{0, h, 0}),
+            sdSpheres(shapes, p + vec3{0, 0, h}) - sdSpheres(shapes, p - vec3{0, 0, h})});
+    }
+
+    template<typename Sphere>
+    void renderSpheres(const std::vector<SphereShape>& shapes, HitLog& log)
+    {
+        using namespace Raychel;
+
+        Scene scene;
+        scene.setBackgroundTexture({[](const vec3& /*unused*/) {
+            return color{0};
+        }});
+        scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 1.0F});
+        for(size_t i = 0; i < shapes.size(); i++) {
+            scene.addObject<Sphere>(make_object_data({shapes[i].center, Quaternion{}}, RecordingMaterial{i, log}), shapes[i].radius);
+        }
+
+        RenderController renderer;
+        renderer.setCurrentScene(&scene);
+        renderer.setOutputSize({48, 32});
+
+        Framebuffer output{{48, 32}, FramebufferFormat::rgb32f};
+        REQUIRE(renderer.renderInto(output));
+        REQUIRE_FALSE(log.hits.empty());
+    }
+
+    //surface_point is moved off the surface along the normal by RaymarchData::surface_bias
+    Raychel::vec3 hitPoint(const RecordedHit& hit)
+    {
+        return hit.surface_point - (hit.normal * 5e-4F);
+    }
+
+}
+
+TEST_CASE("Hit normals and objects", "[Rendering][Marching]")
+{
+    using namespace Raychel;
+
+    SECTION("Compiled spheres")
+    {
+        //overlapping spheres of different sizes in front of the camera. They are compiled into clusters, so the hit objects
+        //have to be resolved
+        std::mt19937 rng{2024};
+        std::uniform_real_distribution<float> lateral{-1.5F, 1.5F};
+        std::uniform_real_distribution<float> forward{2.5F, 4.0F};
+        std::uniform_real_distribution<float> radius{0.3F, 0.9F};
+        std::vector<SphereShape> shapes;
+        for(size_t i = 0; i < 24; i++) {
+            shapes.push_back({vec3{lateral(rng), lateral(rng), forward(rng)}, radius(rng)});
+        }
+
+        HitLog log;
+        renderSpheres<SdSphere>(shapes, log);
+
+        size_t checked = 0;
+        for(const auto& hit : log.hits) {
+            const vec3 p = hitPoint(hit);
+
+            //linear search for the closest object, and how close the runner-up is
+            size_t closest = 0;
+            float closest_distance = std::numeric_limits<float>::max();
+            float second_distance = std::numeric_limits<float>::max();
+            for(size_t i = 0; i < shapes.size(); i++) {
+                const float d = dist(p, shapes[i].center) - shapes[i].radius;
+                if(d < closest_distance) {
+                    second_distance = closest_distance;
+                    closest_distance = d;
+                    closest = i;
+                } else {
+                    second_distance = std::min(second_distance, d);
+                }
+            }
+
+            //at the creases between spheres, neither the object nor the normal is well defined
+            if((second_distance - closest_distance) < 2e-3F) {
+                continue;
+            }
+
+            INFO("hit at " << p.x << ' ' << p.y << ' ' << p.z);
+            REQUIRE(hit.object == closest);
+            REQUIRE(dot(hit.normal, centralDifferenceNormal(shapes, p)) > 0.999F);
+            checked++;
+        }
+        REQUIRE(checked > (log.hits.size() / 2));
+    }
+
+    SECTION("More objects close to the hit than the normal estimate collects")
+    {
+        //twelve spheres whose surfaces are less than the sample distance of the normal apart, so getNormal() has to fall back to the
+        //whole scene
+        std::vector<SphereShape> shapes;
+        for(size_t i = 0; i < 12; i++) {
+            const auto f = static_cast<float>(i);
+            shapes.push_back({vec3{std::sin(f) * 2e-6F, std::cos(f) * 2e-6F, 4.0F}, 1.0F});
+        }
+
+        HitLog log;
+        renderSpheres<UncompiledSphere>(shapes, log);
+
+        for(const auto& hit : log.hits) {
+            const vec3 p = hitPoint(hit);
+            INFO("hit at " << p.x << ' ' << p.y << ' ' << p.z);
+            REQUIRE(dot(hit.normal, centralDifferenceNormal(shapes, p)) > 0.999F);
+
+            //every sphere touches the hit, but the resolved one has to be among them
+            REQUIRE(hit.object < shapes.size());
+            REQUIRE(std::abs(dist(p, shapes[hit.object].center) - shapes[hit.object].radius) < 1e-3F);
+        }
+    }
+}
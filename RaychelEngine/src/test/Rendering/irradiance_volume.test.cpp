@@ -0,0 +1,202 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+namespace {
+
+    //empty space, so every probe is valid
+    float noObjects(const Raychel::vec3& /*unused*/)
+    {
+        return 100.0F;
+    }
+
+    //reports a fatal error for every point that is shaded on it
+    class FaultyMaterial final : public Raychel::Material {
+
+    public:
+
+        FaultyMaterial()=default;
+
+        FaultyMaterial(FaultyMaterial&& /*unused*/) noexcept
+        {}
+
+        void initializeTextureProviders(const Raychel::vec3& /*unused*/, const Raychel::vec3& /*unused*/) override
+        {}
+
+        Raychel::color getSurfaceColor(const Raychel::ShadingData& /*unused*/) const override
+        {
+            RAYCHEL_REPORT_SHADING_ERROR("Texture lookup out of range", true);
+            return Raychel::color{1, 0, 1};
+        }
+    };
+
+    //light only arrives from above
+    Raychel::color sky(const Raychel::vec3& /*unused*/, const Raychel::normalized3& direction)
+    {
+        return direction.y > 0.0F ? Raychel::color{1} : Raychel::color{0};
+    }
+
+}
+
+TEST_CASE("Irradiance volume", "[Rendering][IrradianceVolume]")
+{
+    using namespace Raychel;
+
+    WorkStealingPool workers{2};
+    IrradianceVolume volume;
+    volume.setBounds(BoundingBox{vec3{-2, -2, -2}, vec3{2, 2, 2}}, 1.0F, 1000);
+    REQUIRE(volume.stats().probe_count == 125);
+    REQUIRE(volume.hasDirtyProbes());
+    REQUIRE_FALSE(volume.isBaked());
+
+    SECTION("Constant radiance")
+    {
+        volume.update(
+            noObjects,
+            [](const vec3& /*unused*/, const normalized3& /*unused*/) {
+                return color{0.5F};
+            },
+            256, workers);
+        REQUIRE(volume.isBaked());
+        REQUIRE_FALSE(volume.hasDirtyProbes());
+        REQUIRE(volume.stats().ray_count == 125 * 256);
+
+        //E / pi of a uniform environment is its radiance
+        for(const auto& n : {vec3{0, 1, 0}, vec3{1, 0, 0}, vec3{0, 0.6F, -0.8F}}) {
+            REQUIRE(std::abs(volume.irradiance(vec3{0.3F, -0.7F, 1.2F}, normalize(n)).r - 0.5F) < 0.02F);
+        }
+
+        //outside of the volume
+        REQUIRE(volume.irradiance(vec3{5, 0, 0}, normalize(vec3{0, 1, 0})) == color{0});
+    }
+
+    SECTION("Sky")
+    {
+        volume.update(noObjects, sky, 256, workers);
+
+        const vec3 p{0.5F, 0.5F, 0.5F};
+        REQUIRE(std::abs(volume.irradiance(p, normalize(vec3{0, 1, 0})).r - 1.0F) < 0.1F);
+        REQUIRE(volume.irradiance(p, normalize(vec3{0, -1, 0})).r < 0.1F);
+        REQUIRE(std::abs(volume.irradiance(p, normalize(vec3{1, 0, 0})).r - 0.5F) < 0.1F);
+    }
+
+    SECTION("Probes inside of objects are not used")
+    {
+        //the lower half of the volume is solid and completely dark
+        volume.update(
+            [](const vec3& p) {
+                return p.y - 0.5F;
+            },
+            [](const vec3& origin, const normalized3& /*unused*/) {
+                return origin.y < 0.5F ? color{0} : color{1};
+            },
+            64, workers);
+        REQUIRE(volume.stats().valid_probe_count == 50);
+
+        //a point between a solid and a free probe only sees the free one
+        REQUIRE(std::abs(volume.irradiance(vec3{0, 0.7F, 0}, normalize(vec3{0, 1, 0})).r - 1.0F) < 0.05F);
+    }
+
+    SECTION("Only dirty probes are updated")
+    {
+        volume.update(noObjects, sky, 64, workers);
+
+        volume.markDirty(BoundingBox{vec3{1.5F, 1.5F, 1.5F}, vec3{2, 2, 2}}, 0.25F);
+        REQUIRE(volume.hasDirtyProbes());
+        volume.update(noObjects, sky, 64, workers);
+        REQUIRE(volume.stats().updated_probe_count == 1);
+        REQUIRE(volume.stats().ray_count == 64);
+    }
+}
+
+TEST_CASE("Irradiance volume lighting", "[Rendering][IrradianceVolume]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return dir.y > 0.0F ? color{1} : color{0.2F};
+    }});
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, DiffuseMaterial(color{1})), 1.0F);
+    scene.addObject<SdSphere>(make_object_data({vec3{2.5, 0, 2.5}, Quaternion{}}, DiffuseMaterial(color{1})), 1.0F);
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    const vec2i size{32, 32};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    RenderOptions options;
+    options.use_irradiance_volume = true;
+    options.irradiance_probe_spacing = 0.5F;
+    options.irradiance_probe_rays = 32;
+    renderer.setRenderOptions(options);
+
+    auto image = renderer.getImageRendered();
+    REQUIRE(image.has_value());
+    //the frame counters do not include the probe rays
+    REQUIRE(renderer.getMarchStats().ray_count == size.x * size.y);
+    const IrradianceVolumeStats first = renderer.getIrradianceVolumeStats();
+    REQUIRE(first.probe_count > 0);
+    REQUIRE(first.updated_probe_count == first.probe_count);
+    REQUIRE(first.valid_probe_count < first.probe_count);
+
+    //the scene has no lamps, so all light on the sphere comes from the probes
+    const color center = image->at(vec2i{16, 16});
+    REQUIRE(center.r > 0.1F);
+    REQUIRE(center.r < 1.0F);
+
+    //a change inside of the volume only bakes the probes around it again
+    renderer.invalidateScene(BoundingBox{vec3{-1, -1, 1.5F}, vec3{1, 1, 3.5F}});
+    REQUIRE(renderer.getImageRendered().has_value());
+    const IrradianceVolumeStats second = renderer.getIrradianceVolumeStats();
+    REQUIRE(second.probe_count == first.probe_count);
+    REQUIRE(second.updated_probe_count > 0);
+    REQUIRE(second.updated_probe_count < first.probe_count);
+
+    //frames without changes do not bake anything
+    REQUIRE(renderer.getImageRendered().has_value());
+    REQUIRE(renderer.getIrradianceVolumeStats().updated_probe_count == 0);
+}
+
+TEST_CASE("Irradiance volume bake errors", "[Rendering][IrradianceVolume][Errors]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& /*unused*/) {
+        return color{1};
+    }});
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, DiffuseMaterial(color{1})), 1.0F);
+    //behind the camera, so only the probes see it
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, -3}, Quaternion{}}, FaultyMaterial{}), 1.0F);
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    const vec2i size{32, 32};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    RenderOptions options;
+    options.use_irradiance_volume = true;
+    options.irradiance_probe_spacing = 1.0F;
+    options.irradiance_probe_rays = 32;
+    renderer.setRenderOptions(options);
+
+    //errors of the bake are reported separately and do not fail the frame
+    Framebuffer output{size, FramebufferFormat::rgb32f};
+    REQUIRE(renderer.renderInto(output, FrameBudget{}).status == FrameStatus::complete);
+    REQUIRE(renderer.getShadingErrors().empty());
+    REQUIRE(renderer.getBakeErrors().hasFatal());
+
+    //they also do not end up in the next frame
+    REQUIRE(renderer.renderInto(output, FrameBudget{}).status == FrameStatus::complete);
+    REQUIRE(renderer.getShadingErrors().empty());
+    REQUIRE(renderer.getBakeErrors().empty());
+}
@@ -0,0 +1,185 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <map>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/lights.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+TEST_CASE("Light BVH sampling", "[Rendering][Lighting]")
+{
+    using namespace Raychel;
+
+    const vec3 p{0, 0, 0};
+    const vec3 n{0, 1, 0};
+
+    SECTION("Lamps are picked with the probability they report")
+    {
+        std::vector<LightBounds> lights;
+        for(size_t i = 0; i < 37; i++) {
+            const auto f = static_cast<float>(i);
+            lights.push_back({vec3{std::sin(f) * 6.0F, 1.0F + (static_cast<float>(i % 5) * 1.5F), std::cos(f * 1.7F) * 6.0F}, 0.1F, 1.0F + static_cast<float>(i % 3), 100.0F});
+        }
+
+        LightBvh bvh;
+        bvh.build(lights);
+        REQUIRE(bvh.nodeCount() == (2 * lights.size()) - 1);
+
+        constexpr size_t sample_count = 100000;
+        std::map<size_t, size_t> picks;
+        std::map<size_t, float> pdfs;
+        for(size_t i = 0; i < sample_count; i++) {
+            const LightSample sample = bvh.sample(p, n, (static_cast<float>(i) + 0.5F) / static_cast<float>(sample_count));
+            REQUIRE(sample.pdf > 0.0F);
+            picks[sample.light]++;
+            pdfs[sample.light] = sample.pdf;
+        }
+
+        float pdf_sum = 0.0F;
+        for(const auto& [light, count] : picks) {
+            REQUIRE(static_cast<float>(count) / static_cast<float>(sample_count) == Approx(pdfs[light]).margin(1e-4));
+            pdf_sum += pdfs[light];
+        }
+        REQUIRE(pdf_sum == Approx(1.0F));
+    }
+
+    SECTION("Brighter and closer lamps are picked more often")
+    {
+        LightBvh bvh;
+        bvh.build({{vec3{0, 1, 0}, 0.0F, 1.0F, 100.0F}, {vec3{0, 2, 0}, 0.0F, 1.0F, 100.0F}, {vec3{0, 2, 0.01F}, 0.0F, 8.0F, 100.0F}});
+
+        std::map<size_t, float> pdfs;
+        for(float u = 0.0F; u < 1.0F; u += 0.01F) {
+            const LightSample sample = bvh.sample(p, n, u);
+            pdfs[sample.light] = sample.pdf;
+        }
+
+        REQUIRE(pdfs.size() == 3);
+        REQUIRE(pdfs[0] > pdfs[1]);
+        REQUIRE(pdfs[2] > pdfs[0]);
+    }
+
+    SECTION("Lamps that cannot light the point are never picked")
+    {
+        LightBvh bvh;
+        //below the surface, out of range and in range
+        bvh.build({{vec3{0, -1, 0}, 0.0F, 1.0F, 100.0F}, {vec3{0, 5, 0}, 0.0F, 1.0F, 2.0F}, {vec3{1, 1, 0}, 0.0F, 1.0F, 100.0F}});
+
+        for(float u = 0.0F; u < 1.0F; u += 0.01F) {
+            const LightSample sample = bvh.sample(p, n, u);
+            REQUIRE(sample.light == 2);
+            REQUIRE(sample.pdf == 1.0F);
+        }
+
+        //above all lamps
+        REQUIRE(bvh.sample(vec3{0, 10, 0}, n, 0.5F).pdf == 0.0F);
+    }
+
+    SECTION("Tilted normals do not walk into dead ends")
+    {
+        //the box of the first two lamps has a corner above the surface, but both lamps are below it
+        LightBvh bvh;
+        bvh.build({{vec3{-3, 1, 0}, 0.0F, 1.0F, 100.0F}, {vec3{1, -3, 0}, 0.0F, 1.0F, 100.0F}, {vec3{5, 5, 0}, 0.0F, 1.0F, 100.0F}, {vec3{6, 6, 0}, 0.0F, 1.0F, 100.0F}});
+
+        const vec3 tilted = normalize(vec3{1, 1, 0});
+        for(float u = 0.0F; u < 1.0F; u += 0.01F) {
+            const LightSample sample = bvh.sample(p, tilted, u);
+            REQUIRE(sample.pdf > 0.0F);
+            REQUIRE(sample.light >= 2);
+        }
+    }
+
+    SECTION("Sampled estimates are unbiased for tilted normals")
+    {
+        //lamps on all sides of the surface, so parts of the tree are behind it
+        std::vector<LightBounds> lights;
+        for(size_t i = 0; i < 61; i++) {
+            const auto f = static_cast<float>(i);
+            lights.push_back({vec3{std::sin(f * 2.3F) * 6.0F, std::cos(f * 0.7F) * 6.0F, std::sin(f * 1.1F) * 6.0F}, 0.1F, 1.0F + static_cast<float>(i % 4), 100.0F});
+        }
+        LightBvh bvh;
+        bvh.build(lights);
+
+        const vec3 tilted = normalize(vec3{0.4F, 1, -0.7F});
+        const auto contribution = [&](const LightBounds& light) {
+            const vec3 to_light = light.position - p;
+            const float distance_squared = magSq(to_light);
+            return light.power * std::max(dot(tilted, to_light), 0.0F) / (distance_squared * std::sqrt(distance_squared));
+        };
+
+        float exact = 0.0F;
+        for(const auto& light : lights) {
+            exact += contribution(light);
+        }
+
+        //dead ends add 0, like in RaymarchRenderer::getDirectLighting()
+        constexpr size_t sample_count = 100000;
+        double sum = 0.0;
+        for(size_t i = 0; i < sample_count; i++) {
+            const LightSample sample = bvh.sample(p, tilted, (static_cast<float>(i) + 0.5F) / static_cast<float>(sample_count));
+            if(sample.pdf > 0.0F) {
+                sum += contribution(lights[sample.light]) / sample.pdf;
+            }
+        }
+        REQUIRE(sum / static_cast<double>(sample_count) == Approx(exact).epsilon(1e-3));
+    }
+}
+
+TEST_CASE("Sampled direct lighting", "[Rendering][Lighting]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& /*unused*/) {
+        return color{0};
+    }});
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    //wall at z = 5 with a grid of 64 lamps of different colors in front of it
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 105}, Quaternion{}}, DiffuseMaterial(color{1})), 100.0F);
+    for(size_t i = 0; i < 64; i++) {
+        const vec3 position{(static_cast<float>(i % 8) - 3.5F) * 2.0F, (static_cast<float>(i / 8) - 3.5F) * 2.0F, 3.5F};
+        const color lamp_color{static_cast<float>(i % 2), static_cast<float>((i / 2) % 2), 1.0F};
+        scene.addLamp<PointLight>(Transform{position, Quaternion{}}, LampData{lamp_color, 0.5F, 0.2F});
+    }
+
+    const vec2i size{32, 24};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    const auto render_mean = [&](size_t light_samples) {
+        RenderOptions options;
+        options.light_samples = light_samples;
+        //sampled lamps are weighted up before the cutoff, so they pass it more often than in the exact sum
+        options.light_cutoff = 1e-6F;
+        renderer.setRenderOptions(options);
+
+        Framebuffer output{size, FramebufferFormat::rgb32f};
+        REQUIRE(renderer.renderInto(output));
+
+        color sum{0};
+        for(size_t i = 0; i < output.pixelCount(); i++) {
+            sum += output.load(i);
+        }
+        return sum / static_cast<float>(output.pixelCount());
+    };
+
+    const color exact = render_mean(0);
+    const double exact_rays = renderer.getLightingStats().shadowRaysPerPoint();
+
+    const color sampled = render_mean(16);
+    const LightingStats& stats = renderer.getLightingStats();
+
+    //unbiased, so the noise averages out over the image. Fewer samples per point leave too much of it at this size
+    REQUIRE(sampled.r == Approx(exact.r).epsilon(0.05));
+    REQUIRE(sampled.g == Approx(exact.g).epsilon(0.05));
+    REQUIRE(sampled.b == Approx(exact.b).epsilon(0.05));
+
+    REQUIRE(stats.shadowRaysPerPoint() <= 16.0);
+    REQUIRE(stats.shadowRaysPerPoint() < exact_rays);
+}
@@ -0,0 +1,158 @@
+#include <catch2/catch.hpp>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/lights.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+namespace {
+
+    //scene data that is handed to a RaymarchRenderer directly, so lighting can be queried for single points
+    struct LitScene
+    {
+        std::vector<Raychel::IRaymarchable_p> objects;
+        std::vector<Raychel::SdLamp_p> lamps;
+        Raychel::CubeTexture<Raychel::color> background{Raychel::color{0}};
+        Raychel::RaymarchRenderer renderer;
+
+        LitScene()
+        {
+            using namespace Raychel;
+            //floor through the origin, facing up
+            objects.push_back(new SdSphere{make_object_data({vec3{0, -100, 0}, Quaternion{}}, DiffuseMaterial(color{1})), 100.0F});
+        }
+
+        void addOccluder(const Raychel::vec3& position, float radius)
+        {
+            using namespace Raychel;
+            objects.push_back(new SdSphere{make_object_data({position, Quaternion{}}, DiffuseMaterial(color{1})), radius});
+        }
+
+        void addLamp(const Raychel::vec3& position, float brightness, float size)
+        {
+            using namespace Raychel;
+            lamps.push_back(new PointLight{Transform{position, Quaternion{}}, LampData{color{1}, brightness, size}});
+        }
+
+        Raychel::color lightAt(const Raychel::vec3& point, const Raychel::vec3& normal = Raychel::vec3{0, 1, 0})
+        {
+            renderer.setSceneData(&objects, &lamps, &background);
+            return renderer.getDirectLighting(Raychel::ShadingData{point, normal, Raychel::vec3{0, -1, 0}});
+        }
+
+        ~LitScene()
+        {
+            for(auto ptr : objects) {
+                delete ptr;
+            }
+            for(auto ptr : lamps) {
+                delete ptr;
+            }
+        }
+    };
+
+}
+
+TEST_CASE("Direct lighting", "[Rendering][Lighting]")
+{
+    using namespace Raychel;
+
+    LitScene scene;
+
+    SECTION("Scenes without lamps are unlit")
+    {
+        REQUIRE(scene.lightAt(vec3{0, 0, 0}) == color{1});
+    }
+
+    SECTION("Point lights fall off with the squared distance")
+    {
+        scene.addLamp(vec3{0, 2, 0}, 4.0F, 0.0F);
+        REQUIRE(scene.lightAt(vec3{0, 0, 0}).r == Approx(1.0F));
+
+        //45 degrees off the normal and twice the squared distance
+        REQUIRE(scene.lightAt(vec3{2, 0, 0}).r == Approx(0.5F / std::sqrt(2.0F)).epsilon(1e-3));
+
+        REQUIRE(scene.lightAt(vec3{0, 0, 0}, vec3{0, -1, 0}) == color{0});
+    }
+
+    SECTION("Hard shadows")
+    {
+        scene.addLamp(vec3{0, 4, 0}, 16.0F, 0.0F);
+        scene.addOccluder(vec3{0, 2, 0}, 0.5F);
+
+        REQUIRE(scene.lightAt(vec3{0, 0, 0}) == color{0});
+        REQUIRE(scene.lightAt(vec3{3, 0, 0}).r > 0.0F);
+    }
+
+    SECTION("Soft shadows")
+    {
+        scene.addLamp(vec3{0, 4, 0}, 16.0F, 0.5F);
+        scene.addOccluder(vec3{0, 2, 0}, 0.5F);
+
+        const auto visibility = [&](float x) {
+            const vec3 point{x, 0, 0};
+            const float unshadowed = 16.0F * (4.0F / std::pow(std::sqrt((x * x) + 16.0F), 3.0F));
+            return scene.lightAt(point).r / unshadowed;
+        };
+
+        REQUIRE(visibility(0.0F) == 0.0F);
+        REQUIRE(visibility(5.0F) == Approx(1.0F));
+
+        //the penumbra gets brighter towards its outside
+        const float inner = visibility(1.1F);
+        const float outer = visibility(1.4F);
+        REQUIRE(inner > 0.0F);
+        REQUIRE(inner < outer);
+        REQUIRE(outer < 1.0F);
+    }
+
+    SECTION("Dim lamps are culled")
+    {
+        RenderOptions options;
+        options.light_cutoff = 0.01F;
+        scene.renderer.setRenderOptions(options);
+
+        //range of sqrt(0.5 / 0.01) ~ 7m
+        scene.addLamp(vec3{0, 1, 0}, 0.5F, 0.0F);
+        REQUIRE(scene.lightAt(vec3{0, 0, 0}).r == Approx(0.5F));
+        REQUIRE(scene.lightAt(vec3{8, 0, 0}) == color{0});
+    }
+}
+
+TEST_CASE("Many lamps", "[Rendering][Lighting]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& /*unused*/) {
+        return color{0};
+    }});
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    //wall at z = 5 with a grid of 50 dim lamps in front of it
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 105}, Quaternion{}}, DiffuseMaterial(color{1})), 100.0F);
+    constexpr size_t lamp_count = 50;
+    for(size_t i = 0; i < lamp_count; i++) {
+        const vec3 position{(static_cast<float>(i % 10) - 4.5F) * 2.5F, (static_cast<float>(i / 10) - 2.0F) * 2.5F, 4.0F};
+        scene.addLamp<PointLight>(Transform{position, Quaternion{}}, LampData{color{1}, 0.01F, 0.1F});
+    }
+
+    const vec2i size{32, 24};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    Framebuffer output{size, FramebufferFormat::rgb32f};
+    REQUIRE(renderer.renderInto(output));
+
+    const LightingStats& stats = renderer.getLightingStats();
+    //a few corner pixels miss the wall
+    REQUIRE(stats.point_count > (size.x * size.y) / 2);
+    //every lamp is either culled or gets its shadow ray
+    REQUIRE(stats.culled_light_count + stats.shadow_ray_count == stats.point_count * lamp_count);
+    //only the few lamps close to a point are shaded there
+    REQUIRE(stats.shadowRaysPerPoint() < 10.0);
+    REQUIRE(output.at(vec2i{16, 12}).r > 0.0F);
+}
@@ -0,0 +1,253 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+namespace {
+
+    void fillScene(Raychel::Scene& scene)
+    {
+        using namespace Raychel;
+
+        scene.setBackgroundTexture({[](const vec3& dir) {
+            return color{dir};
+        }});
+        scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+        scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, DiffuseMaterial(color(1, 0, 0))), 1.0F);
+        scene.addObject<SdSphere>(make_object_data({vec3{2.5, 0, 0}, Quaternion{}}, DiffuseMaterial(color(0, 1, 0))), 1.0F);
+        scene.addObject<SdSphere>(make_object_data({vec3{0, 0, -2.5}, Quaternion{}}, ReflectiveMaterial(color(0, 0, 1), 0.8F)), 1.0F);
+        scene.addObject<SdSphere>(make_object_data({vec3{-2.5, 0, 0}, Quaternion{}}, DiffuseMaterial(color(1))), 1.0F);
+
+        //a ring of small spheres, so rays pass close to many objects before they hit something
+        for(size_t i = 0; i < 40; i++) {
+            const float angle = static_cast<float>(i) * 0.157F;
+            const vec3 position{std::sin(angle) * 4.0F, (static_cast<float>(i % 5) - 2.0F) * 0.4F, std::cos(angle) * 4.0F};
+            scene.addObject<SdSphere>(make_object_data({position, Quaternion{}}, DiffuseMaterial(color(0.5F, 1, 0.5F))), 0.15F);
+        }
+    }
+
+    Raychel::Framebuffer renderFrame(Raychel::Scene& scene, const Raychel::vec2i& size, const Raychel::RenderOptions& options)
+    {
+        Raychel::RenderController renderer;
+        renderer.setCurrentScene(&scene);
+        renderer.setOutputSize(size);
+        renderer.setRenderOptions(options);
+
+        Raychel::Framebuffer output{size, options.framebuffer_format};
+        REQUIRE(renderer.renderInto(output));
+        return output;
+    }
+
+    void requireSameImage(const Raychel::Framebuffer& expected, const Raychel::Framebuffer& actual, float margin)
+    {
+        REQUIRE(expected.pixelCount() == actual.pixelCount());
+        for(size_t i = 0; i < expected.pixelCount(); i++) {
+            const Raychel::color a = expected.load(i);
+            const Raychel::color b = actual.load(i);
+            INFO("pixel " << i);
+            REQUIRE(a.r == Approx(b.r).margin(margin));
+            REQUIRE(a.g == Approx(b.g).margin(margin));
+            REQUIRE(a.b == Approx(b.b).margin(margin));
+        }
+    }
+
+    void requireIdenticalImage(const Raychel::Framebuffer& expected, const Raychel::Framebuffer& actual)
+    {
+        REQUIRE(expected.pixelCount() == actual.pixelCount());
+        for(size_t i = 0; i < expected.pixelCount(); i++) {
+            const Raychel::color a = expected.load(i);
+            const Raychel::color b = actual.load(i);
+            INFO("pixel " << i);
+            REQUIRE(a.r == b.r);
+            REQUIRE(a.g == b.g);
+            REQUIRE(a.b == b.b);
+        }
+    }
+
+}
+
+TEST_CASE("Packet marching", "[Rendering][Marching]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    fillScene(scene);
+
+    //odd sizes leave partially filled packets at the end of the rows
+    const vec2i size = GENERATE(vec2i{48, 32}, vec2i{37, 23});
+
+    RenderOptions options;
+    const Framebuffer scalar = renderFrame(scene, size, options);
+
+    options.use_ray_packets = true;
+    const Framebuffer packets = renderFrame(scene, size, options);
+
+    //the lanes run the same math as the scalar loop
+    requireSameImage(scalar, packets, 1e-5F);
+}
+
+TEST_CASE("Over-relaxed marching", "[Rendering][Marching]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    fillScene(scene);
+
+    const vec2i size{48, 32};
+
+    RenderOptions options;
+    options.use_ray_packets = GENERATE(false, true);
+    const Framebuffer classic = renderFrame(scene, size, options);
+
+    options.marching_strategy = MarchingStrategy::over_relaxed;
+    const Framebuffer over_relaxed = renderFrame(scene, size, options);
+
+    //overshooting steps are taken back, so the rays end on the same surfaces
+    requireSameImage(classic, over_relaxed, 1e-5F);
+}
+
+TEST_CASE("Cone pre-pass", "[Rendering][Marching]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    fillScene(scene);
+
+    const vec2i size{48, 32};
+
+    RenderOptions options;
+    options.use_ray_packets = GENERATE(false, true);
+    options.tile_size = GENERATE(7, 16);
+    const Framebuffer full_rays = renderFrame(scene, size, options);
+
+    options.use_cone_prepass = true;
+    const Framebuffer cone_prepass = renderFrame(scene, size, options);
+
+    //the rays only skip empty space in front of their tile
+    requireSameImage(full_rays, cone_prepass, 1e-5F);
+}
+
+TEST_CASE("Depth seeding", "[Rendering][Marching]")
+{
+    using namespace Raychel;
+
+    //wider pixels need wider cones to prove their hints, which stop too early to save any steps
+    const vec2i size{96, 64};
+    constexpr size_t frame_count = 6;
+
+    RenderOptions options;
+    options.use_ray_packets = GENERATE(false, true);
+
+    //the camera moves by this much every frame
+    vec3 camera_step{0, 0, 0};
+    float yaw_step = 0.0F;
+
+    //a sphere close to the camera that is too small for the samples of the last frame to find it in front of the red one
+    vec3 near_sphere_position{0, 0, 0};
+    bool add_near_sphere = false;
+    SECTION("Camera pan")
+    {
+        yaw_step = 4_deg;
+    }
+    SECTION("Camera moving backwards")
+    {
+        camera_step = vec3{0, 0, -0.25F};
+        near_sphere_position = vec3{0, 0.6F, 1.2F};
+        add_near_sphere = true;
+    }
+    SECTION("Camera moving upwards")
+    {
+        camera_step = vec3{0, 0.2F, 0};
+        near_sphere_position = vec3{0.2F, 0.3F, 1.4F};
+        add_near_sphere = true;
+    }
+
+    //render the same camera path once with and once without seeding
+    const auto render_path = [&](const RenderOptions& path_options, size_t& out_step_count) {
+        Scene scene;
+        fillScene(scene);
+        if(add_near_sphere) {
+            scene.addObject<SdSphere>(make_object_data({near_sphere_position, Quaternion{}}, DiffuseMaterial(color(1, 1, 0))), 0.03F);
+        }
+
+        RenderController renderer;
+        renderer.setCurrentScene(&scene);
+        renderer.setOutputSize(size);
+        renderer.setRenderOptions(path_options);
+
+        std::vector<Framebuffer> frames;
+        out_step_count = 0;
+        for(size_t i = 0; i < frame_count; i++) {
+            auto& cam = scene.setCamera({Transform{camera_step * static_cast<float>(i), Quaternion{}}, 0.25});
+            cam.updateYaw(yaw_step * static_cast<float>(i));
+
+            Framebuffer output{size, path_options.framebuffer_format};
+            REQUIRE(renderer.renderInto(output));
+            frames.push_back(std::move(output));
+            out_step_count += renderer.getMarchStats().step_count;
+        }
+        return frames;
+    };
+
+    size_t expected_steps = 0;
+    const std::vector<Framebuffer> expected = render_path(options, expected_steps);
+
+    options.temporal_depth_seeding = true;
+    size_t seeded_steps = 0;
+    const std::vector<Framebuffer> seeded = render_path(options, seeded_steps);
+    REQUIRE(seeded_steps < expected_steps);
+
+    //seeded rays only skip space that is proven to be empty, so they end on exactly the same surfaces
+    for(size_t i = 0; i < frame_count; i++) {
+        INFO("frame " << i);
+        requireIdenticalImage(expected[i], seeded[i]);
+    }
+}
+
+TEST_CASE("Primary ray directions", "[Rendering][Marching]")
+{
+    using namespace Raychel;
+
+    //every ray hits the background, which shows its direction. color{dir} would drop the signs
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return color{(dir.x * 0.5F) + 0.5F, (dir.y * 0.5F) + 0.5F, (dir.z * 0.5F) + 0.5F};
+    }});
+    auto& cam = scene.setCamera({Transform{vec3(1, 2, 3), Quaternion{}}, 0.4F});
+    cam.updateYaw(30_deg);
+    cam.updatePitch(-20_deg);
+    cam.updateRoll(10_deg);
+
+    const vec2i size = GENERATE(vec2i{48, 32}, vec2i{23, 37});
+
+    RenderOptions options;
+    options.use_ray_packets = GENERATE(false, true);
+    const Framebuffer image = renderFrame(scene, size, options);
+
+    //the uv mapping of every pixel, evaluated the way _getRootRequest() and _getRayDirectionFromUV() do
+    const float aspect_ratio = static_cast<float>(size.x) / static_cast<float>(size.y);
+    for(size_t y = 0; y < size.y; y++) {
+        for(size_t x = 0; x < size.x; x++) {
+            float u = (static_cast<float>(x) / static_cast<float>(size.x)) - 0.5F;
+            float v = (static_cast<float>(y) / static_cast<float>(size.y)) - 0.5F;
+            if(aspect_ratio > 1.0F) {
+                u *= aspect_ratio;
+            } else {
+                v /= aspect_ratio;
+            }
+            const vec3 expected = normalize((cam.forward() * cam.zoom()) + (cam.right() * u) + (cam.up() * v));
+
+            const color c = image.at(vec2i{x, y});
+            INFO("pixel " << x << ", " << y);
+            REQUIRE(c.r == Approx((expected.x * 0.5F) + 0.5F).margin(1e-6));
+            REQUIRE(c.g == Approx((expected.y * 0.5F) + 0.5F).margin(1e-6));
+            REQUIRE(c.b == Approx((expected.z * 0.5F) + 0.5F).margin(1e-6));
+        }
+    }
+}
@@ -0,0 +1,156 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Pipeline/ObjectBvh.h"
+
+namespace {
+
+    //randomly placed spheres of different sizes
+    struct SphereField
+    {
+        std::vector<Raychel::IRaymarchable_p> objects;
+
+        explicit SphereField(size_t count)
+        {
+            using namespace Raychel;
+
+            std::mt19937 rng{1234};
+            std::uniform_real_distribution<float> position{-20.0F, 20.0F};
+            std::uniform_real_distribution<float> radius{0.05F, 1.5F};
+            for(size_t i = 0; i < count; i++) {
+                objects.push_back(new SdSphere{make_object_data({vec3{position(rng), position(rng), position(rng)}, Quaternion{}}, DiffuseMaterial(color{1})), radius(rng)});
+            }
+        }
+
+        //reference for ObjectBvh::closestObject()
+        Raychel::ObjectDistance linearClosest(const Raychel::vec3& p, float current_min) const
+        {
+            Raychel::ObjectDistance closest{current_min, nullptr};
+            for(const auto& obj : objects) {
+                const float d = obj->eval(p);
+                if(d < closest.distance) {
+                    closest = {d, obj};
+                }
+            }
+            return closest;
+        }
+
+        SphereField(const SphereField&)=delete;
+        SphereField& operator=(const SphereField&)=delete;
+
+        ~SphereField()
+        {
+            for(auto ptr : objects) {
+                delete ptr;
+            }
+        }
+    };
+
+}
+
+TEST_CASE("Object BVH queries", "[Rendering][ObjectBvh]")
+{
+    using namespace Raychel;
+
+    const size_t object_count = GENERATE(1, 7, 3000);
+    SphereField field{object_count};
+
+    WorkStealingPool workers{4};
+    ObjectBvh bvh;
+    bvh.build({field.objects.cbegin(), field.objects.cend()}, workers);
+    REQUIRE(bvh.stats().num_objects == object_count);
+    REQUIRE(bvh.stats().num_unbounded == 0);
+
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<float> coordinate{-25.0F, 25.0F};
+    std::uniform_real_distribution<float> limit{0.0F, 5.0F};
+    std::bernoulli_distribution lane_active{0.7};
+
+    const auto random_point = [&] {
+        return vec3{coordinate(rng), coordinate(rng), coordinate(rng)};
+    };
+
+    SECTION("Distances match a linear search")
+    {
+        for(size_t i = 0; i < 2000; i++) {
+            const vec3 p = random_point();
+            const float current_min = (i % 2 == 0) ? std::numeric_limits<float>::max() : limit(rng);
+            INFO("point " << p << ", current_min " << current_min);
+
+            const ObjectDistance expected = field.linearClosest(p, current_min);
+            const ObjectDistance closest = bvh.closestObject(p, current_min);
+
+            //both evaluate the same objects, so the minimum is the same float
+            REQUIRE(closest.distance == expected.distance);
+            REQUIRE(bvh.distance(p, current_min) == expected.distance);
+            if(expected.object == nullptr) {
+                REQUIRE(closest.object == nullptr);
+            } else {
+                REQUIRE(closest.object != nullptr);
+                REQUIRE(closest.object->eval(p) == expected.distance);
+            }
+        }
+    }
+
+    SECTION("Active packet lanes match a linear search")
+    {
+        for(size_t i = 0; i < 500; i++) {
+            vec3Packet points;
+            PacketLanes<bool> active{};
+            PacketLanes<float> distances{};
+            PacketLanes<const IRaymarchable*> closest{};
+            PacketLanes<float> start_distances{};
+
+            for(size_t lane = 0; lane < ray_packet_width; lane++) {
+                points.setLane(lane, random_point());
+                active[lane] = lane_active(rng);
+                start_distances[lane] = (lane % 2 == 0) ? std::numeric_limits<float>::max() : limit(rng);
+                distances[lane] = start_distances[lane];
+                closest[lane] = nullptr;
+            }
+
+            bvh.distancePacket(points, active, distances, closest);
+
+            for(size_t lane = 0; lane < ray_packet_width; lane++) {
+                if(!active[lane]) {
+                    continue;
+                }
+                INFO("lane " << lane << ", point " << points.lane(lane));
+
+                const ObjectDistance expected = field.linearClosest(points.lane(lane), start_distances[lane]);
+                REQUIRE(distances[lane] == expected.distance);
+                if(expected.object == nullptr) {
+                    REQUIRE(closest[lane] == nullptr);
+                } else {
+                    REQUIRE(closest[lane] != nullptr);
+                    REQUIRE(closest[lane]->eval(points.lane(lane)) == expected.distance);
+                }
+            }
+        }
+    }
+
+    SECTION("Objects within a distance match a linear search")
+    {
+        std::vector<const IRaymarchable*> found(object_count);
+        for(size_t i = 0; i < 500; i++) {
+            const vec3 p = random_point();
+            const float max_distance = limit(rng);
+
+            const size_t expected = static_cast<size_t>(std::count_if(field.objects.cbegin(), field.objects.cend(), [&](const auto& obj) {
+                return obj->eval(p) <= max_distance;
+            }));
+
+            const size_t count = bvh.objectsWithin(p, max_distance, found.data(), found.size());
+            REQUIRE(count == expected);
+            for(size_t j = 0; j < count; j++) {
+                REQUIRE(found[j]->eval(p) <= max_distance);
+            }
+        }
+    }
+}
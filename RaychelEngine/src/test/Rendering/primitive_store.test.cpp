@@ -0,0 +1,141 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Pipeline/PrimitiveStore.h"
+
+namespace {
+
+    //randomly placed spheres of different sizes, compiled into a store
+    struct CompiledSpheres
+    {
+        std::vector<Raychel::IRaymarchable_p> objects;
+        std::vector<std::pair<Raychel::vec3, float>> centers_and_radii;
+        Raychel::PrimitiveStore store;
+        std::vector<Raychel::not_null<const Raychel::IRaymarchable*>> clusters;
+
+        explicit CompiledSpheres(size_t count)
+        {
+            using namespace Raychel;
+
+            std::mt19937 rng{4321};
+            std::uniform_real_distribution<float> position{-10.0F, 10.0F};
+            std::uniform_real_distribution<float> radius{0.05F, 1.5F};
+            for(size_t i = 0; i < count; i++) {
+                centers_and_radii.emplace_back(vec3{position(rng), position(rng), position(rng)}, radius(rng));
+                objects.push_back(new SdSphere{make_object_data({centers_and_radii.back().first, Quaternion{}}, DiffuseMaterial(color{1})), centers_and_radii.back().second});
+                REQUIRE(objects.back()->compileInto(store));
+            }
+            store.finalize(clusters);
+        }
+
+        //reference for the distance kernels
+        float linearMin(const Raychel::vec3& p) const
+        {
+            float min_distance = std::numeric_limits<float>::max();
+            for(const auto& obj : objects) {
+                min_distance = std::min(min_distance, obj->eval(p));
+            }
+            return min_distance;
+        }
+
+        CompiledSpheres(const CompiledSpheres&)=delete;
+        CompiledSpheres& operator=(const CompiledSpheres&)=delete;
+
+        ~CompiledSpheres()
+        {
+            for(auto ptr : objects) {
+                delete ptr;
+            }
+        }
+    };
+
+}
+
+TEST_CASE("Primitive store distance kernels", "[Rendering][PrimitiveStore]")
+{
+    using namespace Raychel;
+
+    //not a multiple of the cluster or register size, so the last cluster and the scalar tails are used
+    CompiledSpheres spheres{61};
+    const SphereBucket& bucket = spheres.store.spheres();
+    REQUIRE(bucket.size() == 61);
+    REQUIRE(spheres.clusters.size() == 8);
+
+    std::mt19937 rng{99};
+    std::uniform_real_distribution<float> position{-12.0F, 12.0F};
+    std::vector<vec3> points;
+    for(size_t i = 0; i < 64; i++) {
+        points.emplace_back(position(rng), position(rng), position(rng));
+    }
+
+    SECTION("sphereMinDistance matches the spheres for uneven ranges")
+    {
+        const size_t begin = GENERATE(0, 1, 3, 7, 8);
+        const size_t end = GENERATE(9, 12, 16, 17, 23, 61);
+
+        for(const auto& p : points) {
+            float expected = std::numeric_limits<float>::max();
+            for(size_t i = begin; i < end; i++) {
+                expected = std::min(expected, bucket.owners[i]->eval(p));
+            }
+            REQUIRE(sphereMinDistance(bucket, begin, end, p) == Approx(expected).margin(1e-5));
+        }
+    }
+
+    SECTION("Clusters evaluate to the minimum over their spheres")
+    {
+        for(const auto& p : points) {
+            float cluster_min = std::numeric_limits<float>::max();
+            for(const auto& cluster : spheres.clusters) {
+                cluster_min = std::min(cluster_min, cluster->eval(p));
+            }
+            REQUIRE(cluster_min == Approx(spheres.linearMin(p)).margin(1e-5));
+        }
+    }
+
+    SECTION("Packets match single evaluations")
+    {
+        for(size_t first = 0; (first + ray_packet_width) <= points.size(); first += ray_packet_width) {
+            vec3Packet packet{};
+            for(size_t i = 0; i < ray_packet_width; i++) {
+                packet.setLane(i, points[first + i]);
+            }
+
+            for(const auto& cluster : spheres.clusters) {
+                PacketLanes<float> distances{};
+                cluster->evalPacket(packet, distances);
+                for(size_t i = 0; i < ray_packet_width; i++) {
+                    REQUIRE(distances[i] == Approx(cluster->eval(points[first + i])).margin(1e-5));
+                }
+            }
+        }
+    }
+
+    SECTION("Hit objects resolve to the closest sphere")
+    {
+        //points on the surfaces, like after a hit
+        for(const auto& [center, radius] : spheres.centers_and_radii) {
+            const vec3 p = center + (normalize(points[0]) * radius);
+            if(spheres.linearMin(p) < -1e-4F) {
+                //inside of another sphere, so it cannot be hit
+                continue;
+            }
+
+            const auto hit_cluster = std::min_element(spheres.clusters.begin(), spheres.clusters.end(), [&](const auto& a, const auto& b) {
+                return a->eval(p) < b->eval(p);
+            });
+            REQUIRE(std::abs((*hit_cluster)->eval(p)) < 1e-4F);
+
+            //other spheres may touch p as well, but the resolved one must be on its surface
+            const IRaymarchable* resolved = (*hit_cluster)->resolveHitObject(p);
+            REQUIRE(std::find(spheres.objects.begin(), spheres.objects.end(), resolved) != spheres.objects.end());
+            REQUIRE(std::abs(resolved->eval(p)) < 1e-4F);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+TEST_CASE("Progressive rendering", "[Rendering][Progressive]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return color{dir};
+    }});
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, DiffuseMaterial(color(1, 0, 0))), 1.0F);
+    scene.addObject<SdSphere>(make_object_data({vec3{-2.5, 0, 0}, Quaternion{}}, DiffuseMaterial(color(1))), 1.0F);
+    for(size_t i = 0; i < 20; i++) {
+        const float angle = static_cast<float>(i) * 0.157F;
+        scene.addObject<SdSphere>(make_object_data({vec3{std::sin(angle) * 4.0F, 0, std::cos(angle) * 4.0F}, Quaternion{}}, DiffuseMaterial(color(0.5F, 1, 0.5F))), 0.15F);
+    }
+
+    //not a multiple of the coarsest step, so the last rows and columns of the lattice are partial
+    const vec2i size{97, 61};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    RenderOptions options;
+    options.use_ray_packets = GENERATE(false, true);
+    renderer.setRenderOptions(options);
+
+    Framebuffer single_pass{size, FramebufferFormat::rgb32f};
+    REQUIRE(renderer.renderInto(single_pass));
+    const size_t single_pass_rays = renderer.getMarchStats().ray_count;
+    REQUIRE(single_pass_rays == size.x * size.y);
+
+    std::vector<size_t> preview_steps;
+    renderer.setPreviewCallback([&](const FramebufferView& preview, size_t pixel_step) {
+        REQUIRE(preview.size() == size);
+        preview_steps.push_back(pixel_step);
+    });
+    options.progressive = true;
+    renderer.setRenderOptions(options);
+
+    Framebuffer progressive{size, FramebufferFormat::rgb32f};
+    REQUIRE(renderer.renderInto(progressive));
+
+    REQUIRE(preview_steps == std::vector<size_t>{8, 4, 2});
+
+    //the coarse passes are part of the final image, so progressive frames march no more rays than one full pass
+    REQUIRE(renderer.getMarchStats().ray_count == single_pass_rays);
+
+    for(size_t i = 0; i < single_pass.pixelCount(); i++) {
+        INFO("pixel " << i);
+        const color a = single_pass.load(i);
+        const color b = progressive.load(i);
+        REQUIRE(a.r == b.r);
+        REQUIRE(a.g == b.g);
+        REQUIRE(a.b == b.b);
+    }
+}
@@ -0,0 +1,156 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+namespace {
+
+    const Raychel::BoundingBox unit_room{Raychel::vec3{-1, -1, -1}, Raychel::vec3{1, 1, 1}};
+
+    Raychel::color lookup(const Raychel::ReflectionProbes& probes, const Raychel::vec3& p, const Raychel::vec3& direction, float roughness)
+    {
+        Raychel::color result{-1};
+        REQUIRE(probes.lookup(p, Raychel::normalize(direction), roughness, result));
+        return result;
+    }
+
+}
+
+TEST_CASE("Reflection probes", "[Rendering][ReflectionProbes]")
+{
+    using namespace Raychel;
+
+    WorkStealingPool workers{2};
+    ReflectionProbes probes;
+    probes.setProbes({{vec3{0, 0, 0}, unit_room}}, 16, 5);
+    REQUIRE(probes.stats().mip_count == 5);
+    REQUIRE(probes.hasDirtyProbes());
+    REQUIRE_FALSE(probes.covers(vec3{0, 0, 0}));
+
+    SECTION("Constant radiance")
+    {
+        probes.update(
+            [](const vec3& /*unused*/, const normalized3& /*unused*/) {
+                return color{0.5F};
+            },
+            workers);
+        REQUIRE_FALSE(probes.hasDirtyProbes());
+        REQUIRE(probes.stats().ray_count == 6 * 16 * 16);
+
+        REQUIRE(probes.covers(vec3{0.5F, 0, 0}));
+        REQUIRE_FALSE(probes.covers(vec3{1.5F, 0, 0}));
+        color outside;
+        REQUIRE_FALSE(probes.lookup(vec3{1.5F, 0, 0}, normalize(vec3{1, 0, 0}), 0.0F, outside));
+
+        for(const float roughness : {0.0F, 0.3F, 0.55F, 1.0F}) {
+            REQUIRE(std::abs(lookup(probes, vec3{0.2F, 0.1F, -0.3F}, vec3{0.3F, 1, 0.2F}, roughness).g - 0.5F) < 1e-4F);
+        }
+    }
+
+    SECTION("Roughness blurs the reflection")
+    {
+        //only the +x half of the scene is bright
+        probes.update(
+            [](const vec3& /*unused*/, const normalized3& direction) {
+                return direction.x > 0.0F ? color{1} : color{0};
+            },
+            workers);
+
+        const vec3 p{0, 0, 0};
+        REQUIRE(lookup(probes, p, vec3{1, 0, 0}, 0.0F).r > 0.99F);
+        REQUIRE(lookup(probes, p, vec3{-1, 0, 0}, 0.0F).r < 0.01F);
+
+        //rougher levels mix in more of the other half
+        const float smooth = lookup(probes, p, vec3{0.3F, 1, 0}, 0.25F).r;
+        const float rough = lookup(probes, p, vec3{0.3F, 1, 0}, 1.0F).r;
+        REQUIRE(smooth > 0.9F);
+        REQUIRE(rough < smooth);
+        REQUIRE(std::abs(lookup(probes, p, vec3{0, 1, 0}, 1.0F).r - 0.5F) < 0.05F);
+    }
+
+    SECTION("Parallax correction")
+    {
+        //a small bright spot in the middle of the +x wall
+        probes.update(
+            [](const vec3& /*unused*/, const normalized3& direction) {
+                return direction.x > 0.97F ? color{1} : color{0};
+            },
+            workers);
+
+        //the reflected ray from the probe position hits the spot, from further up it hits the wall above it
+        REQUIRE(lookup(probes, vec3{0, 0, 0}, vec3{1, 0, 0}, 0.0F).r > 0.9F);
+        REQUIRE(lookup(probes, vec3{0, 0.6F, 0}, vec3{1, 0, 0}, 0.0F).r < 0.1F);
+    }
+
+    SECTION("Only probes close to a change are updated")
+    {
+        probes.setProbes({{vec3{0, 0, 0}, unit_room}, {vec3{10, 0, 0}, BoundingBox{vec3{9, -1, -1}, vec3{11, 1, 1}}}}, 8, 3);
+        const auto sky = [](const vec3& /*unused*/, const normalized3& direction) {
+            return color{direction.y};
+        };
+        probes.update(sky, workers);
+        REQUIRE(probes.stats().updated_probe_count == 2);
+
+        probes.markDirty(BoundingBox{vec3{11.5F, 0, 0}, vec3{12, 0.5F, 0.5F}}, 1.0F);
+        probes.update(sky, workers);
+        REQUIRE(probes.stats().updated_probe_count == 1);
+        REQUIRE(probes.stats().ray_count == 6 * 8 * 8);
+    }
+}
+
+TEST_CASE("Reflection probe rendering", "[Rendering][ReflectionProbes]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return color{dir.x * 0.5F + 0.5F, 0.5F, 0.0F};
+    }});
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, ReflectiveMaterial(color{1}, 0.8F, 0.5F)), 1.0F);
+    scene.addObject<SdSphere>(make_object_data({vec3{1.5, 0, 1.5}, Quaternion{}}, DiffuseMaterial(color{0, 0, 1})), 0.5F);
+    scene.addReflectionProbe(vec3{0, 0, 0.5F}, BoundingBox{vec3{-4, -4, -2}, vec3{4, 4, 6}});
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    const vec2i size{32, 32};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    RenderOptions options;
+    renderer.setRenderOptions(options);
+    REQUIRE(renderer.getImageRendered().has_value());
+    const size_t marched_rays = renderer.getMarchStats().ray_count;
+
+    options.use_reflection_probes = true;
+    options.reflection_probe_resolution = 16;
+    renderer.setRenderOptions(options);
+    auto image = renderer.getImageRendered();
+    REQUIRE(image.has_value());
+    REQUIRE(renderer.getReflectionProbeStats().probe_count == 1);
+    REQUIRE(renderer.getReflectionProbeStats().updated_probe_count == 1);
+
+    //the frame counters do not include the probe rays, and the rough sphere reads its reflections from the probe
+    REQUIRE(renderer.getMarchStats().ray_count == size.x * size.y);
+    REQUIRE(renderer.getMarchStats().ray_count < marched_rays);
+    const color center = image->at(vec2i{16, 16});
+    REQUIRE(center.r > 0.0F);
+    REQUIRE(center.g > 0.0F);
+
+    //nothing changed, nothing is baked
+    REQUIRE(renderer.getImageRendered().has_value());
+    REQUIRE(renderer.getReflectionProbeStats().updated_probe_count == 0);
+
+    //a change far away from the probe bounds keeps the cubemap
+    renderer.invalidateScene(BoundingBox{vec3{20, 20, 20}, vec3{21, 21, 21}});
+    REQUIRE(renderer.getImageRendered().has_value());
+    REQUIRE(renderer.getReflectionProbeStats().updated_probe_count == 0);
+
+    renderer.invalidateScene(BoundingBox{vec3{1, -0.5F, 1}, vec3{2, 0.5F, 2}});
+    REQUIRE(renderer.getImageRendered().has_value());
+    REQUIRE(renderer.getReflectionProbeStats().updated_probe_count == 1);
+}
@@ -0,0 +1,160 @@
+#include <catch2/catch.hpp>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+namespace {
+
+    //a reflective sphere in front of the camera and a small diffuse one next to it
+    Raychel::Camera& fillScene(Raychel::Scene& scene, float roughness, bool use_probe)
+    {
+        using namespace Raychel;
+
+        scene.setBackgroundTexture({[](const vec3& dir) {
+            return color{(dir.x * 0.5F) + 0.5F, (dir.y * 0.5F) + 0.5F, (dir.z * 0.5F) + 0.5F};
+        }});
+        scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 3}, Quaternion{}}, ReflectiveMaterial(color{1}, 1.0F, roughness)), 1.2F);
+        scene.addObject<SdSphere>(make_object_data({vec3{1.5, 0.5, 4}, Quaternion{}}, DiffuseMaterial(color(0, 1, 0))), 0.5F);
+        if(use_probe) {
+            scene.addReflectionProbe(vec3{0, 0, 0.5F}, BoundingBox{vec3{-6, -6, -4}, vec3{6, 6, 8}});
+        }
+
+        return scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+    }
+
+}
+
+TEST_CASE("Reprojection of reflections", "[Rendering][Reprojection]")
+{
+    using namespace Raychel;
+
+    RenderOptions options;
+    options.use_wavefront = GENERATE(false, true);
+    float roughness = 0.0F;
+    bool use_probe = false;
+    SECTION("Mirror")
+    {
+    }
+    SECTION("Rough surface that reads a reflection probe")
+    {
+        roughness = 0.5F;
+        use_probe = true;
+        options.use_reflection_probes = true;
+        options.reflection_probe_resolution = 16;
+    }
+
+    //materials talk to the renderer they were attached to last, so both renderers get their own scene
+    Scene reference_scene;
+    Camera& reference_cam = fillScene(reference_scene, roughness, use_probe);
+    Scene temporal_scene;
+    Camera& temporal_cam = fillScene(temporal_scene, roughness, use_probe);
+
+    const vec2i size{48, 32};
+    const auto make_renderer = [&](RenderController& renderer, Scene& scene, const RenderOptions& render_options) {
+        renderer.setCurrentScene(&scene);
+        renderer.setOutputSize(size);
+        renderer.setRenderOptions(render_options);
+    };
+
+    RenderController reference;
+    make_renderer(reference, reference_scene, options);
+
+    options.temporal_reprojection = true;
+    RenderController temporal;
+    make_renderer(temporal, temporal_scene, options);
+
+    size_t reprojected_pixel_count = 0;
+    for(size_t frame = 0; frame < 6; frame++) {
+        auto expected = reference.getImageRendered();
+        auto actual = temporal.getImageRendered();
+        REQUIRE(expected.has_value());
+        REQUIRE(actual.has_value());
+        reprojected_pixel_count += temporal.getTemporalStats().reprojected_pixel_count;
+
+        //the reflection of the background changes with every camera move, so it must never be reused
+        for(size_t i = 0; i < expected->pixelCount(); i++) {
+            const color a = expected->load(i);
+            const color b = actual->load(i);
+            INFO("frame " << frame << ", pixel " << i);
+            REQUIRE(a.r == Approx(b.r).margin(1e-3));
+            REQUIRE(a.g == Approx(b.g).margin(1e-3));
+            REQUIRE(a.b == Approx(b.b).margin(1e-3));
+        }
+
+        reference.recycleFramebuffer(std::move(*expected));
+        temporal.recycleFramebuffer(std::move(*actual));
+
+        reference_cam.updateYaw(2_deg);
+        temporal_cam.updateYaw(2_deg);
+    }
+
+    //the diffuse sphere and the background are still reused
+    REQUIRE(reprojected_pixel_count > 0);
+}
+
+TEST_CASE("Reprojection of disoccluded surfaces", "[Rendering][Reprojection]")
+{
+    using namespace Raychel;
+
+    //a diffuse sphere in front of a diffuse wall. Moving the camera sideways uncovers parts of the wall
+    const auto fill_scene = [](Scene& scene) {
+        scene.setBackgroundTexture({[](const vec3& dir) {
+            return color{dir};
+        }});
+        scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, DiffuseMaterial(color(1, 0, 0))), 0.6F);
+        scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 56}, Quaternion{}}, DiffuseMaterial(color(0, 0, 1))), 50.0F);
+    };
+
+    Scene reference_scene;
+    fill_scene(reference_scene);
+    Scene temporal_scene;
+    fill_scene(temporal_scene);
+
+    const vec2i size{48, 32};
+    const auto make_renderer = [&](RenderController& renderer, Scene& scene, const RenderOptions& render_options) {
+        renderer.setCurrentScene(&scene);
+        renderer.setOutputSize(size);
+        renderer.setRenderOptions(render_options);
+    };
+
+    RenderOptions options;
+    options.use_wavefront = GENERATE(false, true);
+
+    RenderController reference;
+    make_renderer(reference, reference_scene, options);
+
+    options.temporal_reprojection = true;
+    RenderController temporal;
+    make_renderer(temporal, temporal_scene, options);
+
+    size_t reprojected_pixel_count = 0;
+    for(size_t frame = 0; frame < 6; frame++) {
+        const Camera cam{Transform{vec3(static_cast<float>(frame) * 0.15F, 0, 0), Quaternion{}}, 0.25};
+        reference_scene.setCamera(cam);
+        temporal_scene.setCamera(cam);
+
+        auto expected = reference.getImageRendered();
+        auto actual = temporal.getImageRendered();
+        REQUIRE(expected.has_value());
+        REQUIRE(actual.has_value());
+        reprojected_pixel_count += temporal.getTemporalStats().reprojected_pixel_count;
+
+        //the uncovered wall must not show the sphere that was in front of it
+        for(size_t i = 0; i < expected->pixelCount(); i++) {
+            const color a = expected->load(i);
+            const color b = actual->load(i);
+            INFO("frame " << frame << ", pixel " << i);
+            REQUIRE(a.r == Approx(b.r).margin(1e-3));
+            REQUIRE(a.g == Approx(b.g).margin(1e-3));
+            REQUIRE(a.b == Approx(b.b).margin(1e-3));
+        }
+
+        reference.recycleFramebuffer(std::move(*expected));
+        temporal.recycleFramebuffer(std::move(*actual));
+    }
+
+    REQUIRE(reprojected_pixel_count > 0);
+}
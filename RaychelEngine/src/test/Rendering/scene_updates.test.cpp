@@ -0,0 +1,47 @@
+#include <catch2/catch.hpp>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+TEST_CASE("Objects added to the current scene", "[Rendering][Scene]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return color{dir};
+    }});
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+    scene.addObject<SdSphere>(make_object_data({vec3{2.5, 0, 0}, Quaternion{}}, DiffuseMaterial(color(0, 1, 0))), 1.0F);
+
+    const vec2i size{16, 16};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    RenderOptions options;
+    options.temporal_reprojection = GENERATE(false, true);
+    renderer.setRenderOptions(options);
+
+    const auto center_color = [&] {
+        auto framebuffer = renderer.getImageRendered();
+        REQUIRE(framebuffer.has_value());
+        const color c = framebuffer->at(vec2i{size.x / 2, size.y / 2});
+        renderer.recycleFramebuffer(std::move(*framebuffer));
+        return c;
+    };
+
+    const color before = center_color();
+
+    //added after setCurrentScene(), without invalidateScene()
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 3}, Quaternion{}}, DiffuseMaterial(color(1, 0, 0))), 1.0F);
+
+    const color after = center_color();
+    REQUIRE(mag(vec3{after.r - before.r, after.g - before.g, after.b - before.b}) > 0.1F);
+
+    //later frames keep showing it
+    REQUIRE(center_color().r == Approx(after.r));
+}
@@ -0,0 +1,67 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Pipeline/SdfCache.h"
+
+namespace {
+
+    struct OwnedObjects
+    {
+        std::vector<Raychel::IRaymarchable_p> objects;
+
+        OwnedObjects()=default;
+        OwnedObjects(const OwnedObjects&)=delete;
+        OwnedObjects& operator=(const OwnedObjects&)=delete;
+
+        ~OwnedObjects()
+        {
+            for(auto ptr : objects) {
+                delete ptr;
+            }
+        }
+    };
+
+}
+
+TEST_CASE("SDF cache distances", "[Rendering][SdfCache]")
+{
+    using namespace Raychel;
+
+    OwnedObjects scene;
+    std::mt19937 rng{1234};
+    {
+        std::uniform_real_distribution<float> position{-10.0F, 10.0F};
+        std::uniform_real_distribution<float> radius{0.05F, 1.0F};
+        for(size_t i = 0; i < 300; i++) {
+            scene.objects.push_back(new SdSphere{make_object_data({vec3{position(rng), position(rng), position(rng)}, Quaternion{}}, DiffuseMaterial(color{1})), radius(rng)});
+        }
+    }
+
+    WorkStealingPool workers{4};
+    ObjectBvh bvh;
+    bvh.build({scene.objects.cbegin(), scene.objects.cend()}, workers);
+
+    const SdfCacheFormat format = GENERATE(SdfCacheFormat::fp16, SdfCacheFormat::unorm8);
+    //the small budget leaves most cells close to a surface without a brick
+    const size_t memory_budget = GENERATE(size_t{64} << 20U, size_t{256} << 10U);
+
+    constexpr float max_distance = 10.0F;
+    SdfCache cache;
+    REQUIRE(cache.bake(bvh, max_distance, format, memory_budget, workers));
+    REQUIRE(cache.stats().memory_usage <= memory_budget);
+
+    //also sample outside of the cached bounds
+    std::uniform_real_distribution<float> coordinate{-14.0F, 14.0F};
+    for(size_t i = 0; i < 20000; i++) {
+        const vec3 p{coordinate(rng), coordinate(rng), coordinate(rng)};
+        const float exact = std::min(bvh.distance(p, max_distance), max_distance);
+
+        INFO("point " << p << ", exact distance " << exact);
+        REQUIRE(cache.distance(p) <= exact);
+    }
+}
@@ -0,0 +1,112 @@
+#include <catch2/catch.hpp>
+
+#include <atomic>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+namespace {
+
+    std::atomic_size_t reported_errors{0};
+
+    //reports an error for every point on the right half of its object
+    class FaultyMaterial final : public Raychel::Material {
+
+    public:
+
+        explicit FaultyMaterial(bool fatal)
+            :fatal_{fatal}
+        {}
+
+        FaultyMaterial(FaultyMaterial&& rhs) noexcept
+            :fatal_{rhs.fatal_}
+        {}
+
+        void initializeTextureProviders(const Raychel::vec3& /*unused*/, const Raychel::vec3& /*unused*/) override
+        {}
+
+        Raychel::color getSurfaceColor(const Raychel::ShadingData& data) const override
+        {
+            if(data.surface_point.x > 0.0F) {
+                reported_errors++;
+                RAYCHEL_REPORT_SHADING_ERROR("Texture lookup out of range", fatal_);
+                return Raychel::color{1, 0, 1};
+            }
+            return Raychel::color{1};
+        }
+
+    private:
+
+        bool fatal_;
+    };
+
+}
+
+TEST_CASE("Shading errors", "[Rendering][Errors]")
+{
+    using namespace Raychel;
+
+    SECTION("Logs count repeated errors once")
+    {
+        ShadingErrorLog log;
+        log.add({"a", "f", false, 1});
+        log.add({"a", "f", false, 2});
+        log.add({"b", "f", true, 1});
+        REQUIRE(log.totalCount() == 4);
+        REQUIRE(log.hasFatal());
+        REQUIRE(std::distance(log.begin(), log.end()) == 2);
+        REQUIRE(log.begin()->count == 3);
+
+        ShadingErrorLog merged;
+        for(size_t i = 0; i < ShadingErrorLog::max_distinct_errors; i++) {
+            merged.add({"filler", "g", false, 1});
+            merged.add({"filler", "h", false, 1});
+        }
+        merged.merge(log);
+        REQUIRE(merged.totalCount() == (2 * ShadingErrorLog::max_distinct_errors) + 4);
+        REQUIRE(merged.hasFatal());
+    }
+
+    const bool fatal = GENERATE(false, true);
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return color{dir};
+    }});
+    scene.addObject<SdSphere>(make_object_data({vec3{0, 0, 2.5}, Quaternion{}}, FaultyMaterial{fatal}), 1.0F);
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    const vec2i size{64, 32};
+    RenderController renderer;
+    renderer.setCurrentScene(&scene);
+    renderer.setOutputSize(size);
+
+    Framebuffer output{size, FramebufferFormat::rgb32f};
+
+    SECTION("Every report of a frame is collected")
+    {
+        reported_errors = 0;
+        const FrameResult result = renderer.renderInto(output, FrameBudget{});
+        const ShadingErrorLog& errors = renderer.getShadingErrors();
+
+        REQUIRE(reported_errors != 0);
+        REQUIRE(errors.hasFatal() == fatal);
+        REQUIRE(std::distance(errors.begin(), errors.end()) == 1);
+        REQUIRE(errors.begin()->what == "Texture lookup out of range");
+        REQUIRE(errors.totalCount() == reported_errors);
+        REQUIRE(result.status == (fatal ? FrameStatus::failed : FrameStatus::complete));
+    }
+
+    SECTION("Errors do not carry over into the next frame")
+    {
+        REQUIRE(renderer.renderInto(output, FrameBudget{}).status == (fatal ? FrameStatus::failed : FrameStatus::complete));
+
+        //the sphere moves out of view
+        scene.setCamera({Transform{vec3(0, 0, 10), Quaternion{}}, 0.25});
+        REQUIRE(renderer.renderInto(output, FrameBudget{}).status == FrameStatus::complete);
+        REQUIRE(renderer.getShadingErrors().empty());
+    }
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+#include "Raychel/Engine/Rendering/Pipeline/Tiles.h"
+
+TEST_CASE("Morton encoding", "[Rendering][Tiles]")
+{
+    using namespace Raychel;
+
+    REQUIRE(mortonEncode(0, 0) == 0);
+    REQUIRE(mortonEncode(1, 0) == 1);
+    REQUIRE(mortonEncode(0, 1) == 2);
+    REQUIRE(mortonEncode(1, 1) == 3);
+    REQUIRE(mortonEncode(2, 0) == 4);
+    REQUIRE(mortonEncode(3, 3) == 15);
+    REQUIRE(mortonEncode(0xFFFF, 0xFFFF) == 0xFFFFFFFFU);
+
+    //only the lower 16 bits are used
+    REQUIRE(mortonEncode(0x10000, 0) == 0);
+}
+
+TEST_CASE("Morton order keeps 2x2 blocks together", "[Rendering][Tiles]")
+{
+    using namespace Raychel;
+
+    for(std::uint32_t y = 0; y < 16; y += 2) {
+        for(std::uint32_t x = 0; x < 16; x += 2) {
+            const auto base = mortonEncode(x, y);
+            REQUIRE(mortonEncode(x + 1, y) == base + 1);
+            REQUIRE(mortonEncode(x, y + 1) == base + 2);
+            REQUIRE(mortonEncode(x + 1, y + 1) == base + 3);
+        }
+    }
+}
+
+TEST_CASE("Quadrants cover their rect", "[Rendering][Tiles]")
+{
+    using namespace Raychel;
+
+    const Tile rect{vec2i{3, 5}, GENERATE(vec2i{16, 16}, vec2i{7, 4}, vec2i{1, 3})};
+
+    size_t area = 0;
+    for(const auto& quadrant : splitIntoQuadrants(rect)) {
+        area += quadrant.size.x * quadrant.size.y;
+        if(quadrant.size.x == 0 || quadrant.size.y == 0) {
+            continue;
+        }
+        REQUIRE(quadrant.origin.x >= rect.origin.x);
+        REQUIRE(quadrant.origin.y >= rect.origin.y);
+        REQUIRE(quadrant.origin.x + quadrant.size.x <= rect.origin.x + rect.size.x);
+        REQUIRE(quadrant.origin.y + quadrant.size.y <= rect.origin.y + rect.size.y);
+    }
+
+    //the quadrants don't overlap, so they cover the rect if their areas add up
+    REQUIRE(area == rect.size.x * rect.size.y);
+}
+
+TEST_CASE("Tiles cover the image once", "[Rendering][Tiles]")
+{
+    using namespace Raychel;
+
+    //partial tiles at the right and bottom border, exact multiples and tiles larger than the image
+    const auto [image_size, tile_size] = GENERATE(std::make_pair(vec2i{37, 23}, size_t{8}), std::make_pair(vec2i{32, 16}, size_t{16}),
+                                                  std::make_pair(vec2i{5, 3}, size_t{16}), std::make_pair(vec2i{1, 1}, size_t{1}));
+
+    const auto tiles = makeTiles(image_size, tile_size);
+    REQUIRE(tiles.size() == ((image_size.x + tile_size - 1) / tile_size) * ((image_size.y + tile_size - 1) / tile_size));
+
+    std::vector<size_t> coverage(image_size.x * image_size.y, 0);
+    for(const auto& tile : tiles) {
+        REQUIRE(tile.size.x != 0);
+        REQUIRE(tile.size.y != 0);
+        REQUIRE(tile.size.x <= tile_size);
+        REQUIRE(tile.size.y <= tile_size);
+        REQUIRE(tile.origin.x + tile.size.x <= image_size.x);
+        REQUIRE(tile.origin.y + tile.size.y <= image_size.y);
+
+        for(size_t y = tile.origin.y; y < tile.origin.y + tile.size.y; y++) {
+            for(size_t x = tile.origin.x; x < tile.origin.x + tile.size.x; x++) {
+                coverage[(y * image_size.x) + x]++;
+            }
+        }
+    }
+
+    REQUIRE(std::all_of(coverage.cbegin(), coverage.cend(), [](size_t count) { return count == 1; }));
+}
@@ -0,0 +1,68 @@
+#include <catch2/catch.hpp>
+
+#include "Raychel/Raychel.h"
+#include "Raychel/Engine/Interface/Scene.h"
+#include "Raychel/Engine/Materials/Materials.h"
+#include "Raychel/Engine/Objects/sdObjects.h"
+#include "Raychel/Engine/Rendering/Renderer.h"
+
+namespace {
+
+    Raychel::Framebuffer renderFrame(Raychel::Scene& scene, const Raychel::vec2i& size, const Raychel::RenderOptions& options)
+    {
+        Raychel::RenderController renderer;
+        renderer.setCurrentScene(&scene);
+        renderer.setOutputSize(size);
+        renderer.setRenderOptions(options);
+
+        Raychel::Framebuffer output{size, options.framebuffer_format};
+        REQUIRE(renderer.renderInto(output));
+        return output;
+    }
+
+}
+
+TEST_CASE("Wavefront rendering", "[Rendering][Wavefront]")
+{
+    using namespace Raychel;
+
+    Scene scene;
+    scene.setBackgroundTexture({[](const vec3& dir) {
+        return color{dir};
+    }});
+    scene.setCamera({Transform{vec3(0, 0, 0), Quaternion{}}, 0.25});
+
+    //two mirrors facing each other, so some rays bounce until the recursion limit
+    scene.addObject<SdSphere>(make_object_data({vec3{-1.1, 0, 3}, Quaternion{}}, ReflectiveMaterial(color(1, 0, 0), 0.8F)), 1.0F);
+    scene.addObject<SdSphere>(make_object_data({vec3{1.1, 0, 3}, Quaternion{}}, ReflectiveMaterial(color(0, 0, 1), 0.8F)), 1.0F);
+    scene.addObject<SdSphere>(make_object_data({vec3{0, -1.5, 4}, Quaternion{}}, DiffuseMaterial(color(0, 1, 0))), 0.7F);
+
+    const vec2i size{48, 32};
+
+    RenderOptions options;
+    const int features = GENERATE(0, 1, 2);
+    if(features >= 1) {
+        options.use_ray_packets = true;
+    }
+    if(features == 2) {
+        options.use_cone_prepass = true;
+        options.progressive = true;
+        options.doAA = true;
+        options.tile_size = 7;
+    }
+
+    const Framebuffer expected = renderFrame(scene, size, options);
+
+    options.use_wavefront = true;
+    const Framebuffer wavefront = renderFrame(scene, size, options);
+
+    //the secondary rays are summed up in another order, so only the rounding may differ
+    for(size_t i = 0; i < expected.pixelCount(); i++) {
+        const color a = expected.load(i);
+        const color b = wavefront.load(i);
+        INFO("features " << features << " pixel " << i);
+        REQUIRE(a.r == Approx(b.r).margin(1e-5));
+        REQUIRE(a.g == Approx(b.g).margin(1e-5));
+        REQUIRE(a.b == Approx(b.b).margin(1e-5));
+    }
+}
@@ -46,26 +46,15 @@ int main(int /*unused*/, char** argv)
 
     auto label = Logger::startTimer("Total time");
 
-    for(size_t i = 0;; i++) {
-
-        auto render_label = Logger::startTimer("Render time");
-        auto results = renderer.getImageRendered();
-        Logger::logDuration(render_label);
-
-        if(!results) {
-            break;
+    //frames are written on a separate thread while the next one renders
+    const size_t frame_count = renderer.renderToTarget(*target, [&](size_t frame_index) {
+        if(frame_index != 0) {
+            cam.updateYaw(2_deg);
         }
-        
-        auto file_label = Logger::startTimer("Write time");
-            target->prepareFramebufferWrite();
-            target->writeFramebuffer(results.value());
-            target->finishFramebufferWrite();
-        Logger::logDuration(file_label);
-
-        cam.updateYaw(2_deg);
+        return true;
+    });
 
-        using namespace std::chrono_literals;
-    }
+    Logger::log("Wrote ", frame_count, " frames\n");
 
     Logger::logDuration(label);
 